@@ -0,0 +1,102 @@
+#include "PosixStream.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+PosixStream::PosixStream(int fd)
+    : fd(fd), bufferPosition(0), bufferLength(0)
+{
+}
+
+int PosixStream::read()
+{
+  if (bufferPosition == bufferLength)
+  {
+    if (!waitReadable(0))
+    {
+      return -1;
+    }
+
+    ssize_t count = ::read(fd, buffer, sizeof(buffer));
+    if (count <= 0)
+    {
+      return -1;
+    }
+    bufferPosition = 0;
+    bufferLength = (int)count;
+  }
+
+  return buffer[bufferPosition++];
+}
+
+void PosixStream::write(const uint8_t *data, uint16_t length)
+{
+  uint16_t written = 0;
+  while (written < length)
+  {
+    ssize_t count = ::write(fd, data + written, length - written);
+    if (count < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN)
+      {
+        continue;
+      }
+      return;
+    }
+    written += (uint16_t)count;
+  }
+}
+
+bool PosixStream::waitReadable(int timeoutMs)
+{
+  if (bufferPosition < bufferLength)
+  {
+    return true;
+  }
+
+  struct pollfd descriptor = {fd, POLLIN, 0};
+  return poll(&descriptor, 1, timeoutMs) > 0 && (descriptor.revents & POLLIN);
+}
+
+bool PosixStream::configureRaw(int fd, int baudRate)
+{
+  struct termios options;
+  if (tcgetattr(fd, &options) != 0)
+  {
+    return false;
+  }
+
+  cfmakeraw(&options);
+  options.c_cflag |= CLOCAL | CREAD;
+  options.c_cc[VMIN] = 0;
+  options.c_cc[VTIME] = 0;
+
+  speed_t speed;
+  switch (baudRate)
+  {
+  case 9600:
+    speed = B9600;
+    break;
+  case 57600:
+    speed = B57600;
+    break;
+  case 115200:
+    speed = B115200;
+    break;
+  case 460800:
+    speed = B460800;
+    break;
+  case 921600:
+    speed = B921600;
+    break;
+  default:
+    speed = B230400;
+    break;
+  }
+  cfsetispeed(&options, speed);
+  cfsetospeed(&options, speed);
+
+  return tcsetattr(fd, TCSANOW, &options) == 0;
+}
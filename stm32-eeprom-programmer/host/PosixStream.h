@@ -0,0 +1,28 @@
+#ifndef POSIX_STREAM_H
+#define POSIX_STREAM_H
+
+#include "ProgrammingProtocol.h"
+
+// ByteStream over a file descriptor (serial tty or pty master)
+class PosixStream : public ByteStream
+{
+public:
+  explicit PosixStream(int fd);
+
+  int read() override; // Never blocks
+  void write(const uint8_t *data, uint16_t length) override;
+
+  // Wait until a byte is available; false on timeout
+  bool waitReadable(int timeoutMs);
+
+  // Raw 8N1 mode; the baud rate is ignored by ptys
+  static bool configureRaw(int fd, int baudRate);
+
+private:
+  int fd;
+  uint8_t buffer[256];
+  int bufferPosition;
+  int bufferLength;
+};
+
+#endif // POSIX_STREAM_H
@@ -0,0 +1,411 @@
+// Stand-in for the programmer board: runs the firmware's ProgrammerServer on
+// a pseudo-terminal with an in-memory 28C256, so the client can be exercised
+// without hardware. Prints the pty path to pass to programmer-client.
+//
+// usage: fake-device [--write-us N] [--corrupt-every N] [--dump FILE]
+//   --write-us N       simulated write cycle per page (default 10000)
+//   --corrupt-every N  flip a bit in every Nth received byte
+//   --dump FILE        write the memory contents to FILE on exit
+
+#include "ImageManifest.h"
+#include "PosixStream.h"
+#include "ProgrammerServer.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+  volatile sig_atomic_t running = 1;
+
+  void stop(int)
+  {
+    running = 0;
+  }
+
+  class MemoryPageStore : public PageStore
+  {
+  public:
+    static const uint32_t SIZE = 32768;
+
+    explicit MemoryPageStore(int writeMicros) : writeMicros(writeMicros)
+    {
+      memset(memory, 0xFF, sizeof(memory));
+    }
+
+    // As EEPROMPageStore: the first write of a session invalidates the manifest
+    void beginSession() override
+    {
+      manifestChecked = false;
+    }
+
+    WriteResult writePage(uint16_t address, const uint8_t *data, uint16_t length, bool) override
+    {
+      if (address + length > SIZE)
+      {
+        return PAGE_FAILED;
+      }
+      if (!manifestChecked)
+      {
+        if (ProgrammingProtocol::readLE32(memory + ImageManifest::HEADER_ADDRESS) == ImageManifest::MAGIC)
+        {
+          memory[ImageManifest::HEADER_ADDRESS] = ImageManifest::INVALID_MAGIC;
+          usleep(writeMicros);
+        }
+        manifestChecked = true;
+      }
+      if (memcmp(memory + address, data, length) == 0)
+      {
+        return PAGE_UNCHANGED;
+      }
+      memcpy(memory + address, data, length);
+      usleep(writeMicros);
+      pagesWritten++;
+      return PAGE_WRITTEN;
+    }
+
+    void readBlock(uint16_t address, uint8_t *data, uint16_t length) override
+    {
+      for (uint16_t i = 0; i < length; i++)
+      {
+        data[i] = memory[(address + i) % SIZE];
+      }
+    }
+
+    bool erase() override
+    {
+      memset(memory, 0xFF, sizeof(memory));
+      usleep(writeMicros);
+      return true;
+    }
+
+    bool isBlank(uint16_t address, uint16_t length, uint16_t &firstUsed) override
+    {
+      for (uint16_t i = 0; i < length; i++)
+      {
+        if (memory[(address + i) % SIZE] != 0xFF)
+        {
+          firstUsed = address + i;
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool dump(const char *path) const
+    {
+      FILE *file = fopen(path, "wb");
+      if (!file)
+      {
+        return false;
+      }
+      bool written = fwrite(memory, 1, SIZE, file) == SIZE;
+      return fclose(file) == 0 && written;
+    }
+
+    int writeMicros;
+    uint32_t pagesWritten = 0;
+
+  private:
+    uint8_t memory[SIZE];
+    bool manifestChecked = false;
+  };
+
+  // Diagnostics with every write cycle taking --write-us; the benchmark
+  // times the in-memory store
+  class MemoryDiagnostics : public Diagnostics
+  {
+  public:
+    explicit MemoryDiagnostics(MemoryPageStore &store) : store(store) {}
+
+    void readStats(ProgrammingProtocol::DeviceStats &stats, bool reset) override
+    {
+      using namespace ProgrammingProtocol;
+      memset(&stats, 0, sizeof(stats));
+      stats.phaseMicros[STATS_PHASES - 1] = store.pagesWritten * (uint32_t)store.writeMicros;
+      stats.phaseCount[STATS_PHASES - 1] = store.pagesWritten;
+      stats.writeCycles = store.pagesWritten;
+
+      uint8_t bucket = 0;
+      while (bucket < STATS_HISTOGRAM_BUCKETS - 1 &&
+             (uint32_t)store.writeMicros >= (STATS_HISTOGRAM_BASE_US << bucket))
+      {
+        bucket++;
+      }
+      stats.histogram[bucket] = (uint16_t)store.pagesWritten;
+
+      if (reset)
+      {
+        store.pagesWritten = 0;
+      }
+    }
+
+    void runBenchmark(uint16_t address, uint16_t length, ProgrammingProtocol::BenchmarkResult &result) override
+    {
+      typedef std::chrono::steady_clock Clock;
+      uint8_t pattern[SIZE_LIMIT];
+      uint8_t readBack[SIZE_LIMIT];
+      for (uint16_t i = 0; i < length; i++)
+      {
+        pattern[i] = (uint8_t)(rand() >> 4);
+      }
+
+      Clock::time_point start = Clock::now();
+      bool success = true;
+      for (uint16_t offset = 0; offset < length && success;)
+      {
+        uint16_t chunk = ProgrammingProtocol::PAGE_SIZE - ((address + offset) & (ProgrammingProtocol::PAGE_SIZE - 1));
+        chunk = chunk < length - offset ? chunk : length - offset;
+        success = store.writePage(address + offset, pattern + offset, chunk, false) != PageStore::PAGE_FAILED;
+        offset += chunk;
+      }
+      result.writeMicros = microsecondsSince(start);
+
+      start = Clock::now();
+      store.readBlock(address, readBack, length);
+      success = success && memcmp(readBack, pattern, length) == 0;
+      result.verifyMicros = microsecondsSince(start);
+
+      start = Clock::now();
+      store.readBlock(address, readBack, length);
+      result.dumpMicros = microsecondsSince(start);
+
+      result.length = length;
+      result.status = success ? ProgrammingProtocol::STATUS_OK : ProgrammingProtocol::STATUS_WRITE_FAILED;
+    }
+
+    // Memory has no bus to time; only the write cycle is reported
+    void characterize(uint16_t address, ProgrammingProtocol::TimingReport &report) override
+    {
+      (void)address;
+      memset(&report, 0, sizeof(report));
+      report.status = ProgrammingProtocol::STATUS_OK;
+      report.writeCycleMicros = (uint32_t)store.writeMicros;
+      report.writeTimeoutMicros = 20000; // WRITE_CYCLE_TIMEOUT_US, characterization keeps it
+    }
+
+    // A pretend CPU fetching the memory in order at FETCH_HZ, sampled
+    // from power-up; the trigger is its first fetch of the address
+    bool capture(const ProgrammingProtocol::CaptureRequest &request, ProgrammingProtocol::CaptureInfo &info) override
+    {
+      using namespace ProgrammingProtocol;
+      captureRateHz = request.sampleRateHz;
+      uint64_t triggerSample = 0;
+      bool triggered = (request.flags & FLAG_CAPTURE_TRIGGER) != 0;
+      if (triggered)
+      {
+        uint64_t fetch = request.triggerAddress % MemoryPageStore::SIZE;
+        triggerSample = (fetch * captureRateHz + FETCH_HZ - 1) / FETCH_HZ;
+      }
+      captureStart = triggerSample > request.preTrigger ? triggerSample - request.preTrigger : 0;
+
+      info.status = STATUS_OK;
+      info.triggered = triggered ? 1 : 0;
+      info.sampleCount = CAPTURE_SAMPLES;
+      info.triggerIndex = (uint16_t)(triggerSample - captureStart);
+      info.sampleRateHz = captureRateHz;
+      info.missedSamples = 0;
+      return true;
+    }
+
+    uint8_t readCapture(uint16_t index, ProgrammingProtocol::CaptureSample *samples, uint8_t count) override
+    {
+      using namespace ProgrammingProtocol;
+      if (index >= CAPTURE_SAMPLES)
+      {
+        return 0;
+      }
+      count = count < CAPTURE_SAMPLES - index ? count : (uint8_t)(CAPTURE_SAMPLES - index);
+
+      uint8_t data[1];
+      for (uint8_t i = 0; i < count; i++)
+      {
+        uint64_t fetch = (captureStart + index + i) * FETCH_HZ / captureRateHz;
+        samples[i].address = (uint16_t)(fetch % MemoryPageStore::SIZE);
+        store.readBlock(samples[i].address, data, 1);
+        samples[i].data = data[0];
+        samples[i].control = CAPTURE_WE; // CE and OE low
+      }
+      return count;
+    }
+
+    void endCapture() override
+    {
+    }
+
+  private:
+    static const uint32_t SIZE_LIMIT = MemoryPageStore::SIZE;
+    static const uint16_t CAPTURE_SAMPLES = 1023;
+    static const uint64_t FETCH_HZ = 1000000;
+
+    MemoryPageStore &store;
+    uint32_t captureRateHz = 1;
+    uint64_t captureStart = 0;
+
+    static uint32_t microsecondsSince(std::chrono::steady_clock::time_point start)
+    {
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      uint32_t micros = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+      return micros > 0 ? micros : 1;
+    }
+  };
+
+  // ROM emulation with the figures of the real loop at 8 MHz; serving
+  // just waits for the host's next frame
+  class MemoryEmulator : public Emulator
+  {
+  public:
+    static const uint16_t SIZE = 14336;
+    static const uint16_t LOOP_CYCLES = 15;
+    static const uint32_t CLOCK_HZ = 8000000;
+
+    explicit MemoryEmulator(PosixStream &pty) : pty(pty)
+    {
+      memset(image, 0xFF, sizeof(image));
+    }
+
+    bool load(uint16_t address, const uint8_t *data, uint16_t length) override
+    {
+      if ((uint32_t)address + length > SIZE)
+      {
+        return false;
+      }
+      memcpy(image + address, data, length);
+      return true;
+    }
+
+    void describe(ProgrammingProtocol::EmulationInfo &info) override
+    {
+      info.status = ProgrammingProtocol::STATUS_OK;
+      info.capacity = SIZE;
+      info.loopCycles = LOOP_CYCLES;
+      info.accessNs = (uint32_t)(2ull * LOOP_CYCLES * 1000000000ull / CLOCK_HZ);
+      info.maxClockHz = 1000000000u / info.accessNs;
+      info.lanes = 1;
+    }
+
+    void run() override
+    {
+      while (running && !pty.waitReadable(100))
+      {
+      }
+    }
+
+    void endEmulation() override
+    {
+    }
+
+  private:
+    PosixStream &pty;
+    uint8_t image[SIZE];
+  };
+
+  // Injects line noise to exercise the CRC and retransmission paths
+  class CorruptingStream : public ByteStream
+  {
+  public:
+    CorruptingStream(ByteStream &inner, long every) : inner(inner), every(every), count(0) {}
+
+    int read() override
+    {
+      int byte = inner.read();
+      if (byte >= 0 && every > 0 && ++count % every == 0)
+      {
+        byte ^= 0x10;
+      }
+      return byte;
+    }
+
+    void write(const uint8_t *data, uint16_t length) override
+    {
+      inner.write(data, length);
+    }
+
+  private:
+    ByteStream &inner;
+    long every;
+    long count;
+  };
+}
+
+int main(int argc, char **argv)
+{
+  int writeMicros = 10000;
+  long corruptEvery = 0;
+  const char *dumpPath = nullptr;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--write-us" && i + 1 < argc)
+    {
+      writeMicros = atoi(argv[++i]);
+    }
+    else if (arg == "--corrupt-every" && i + 1 < argc)
+    {
+      corruptEvery = atol(argv[++i]);
+    }
+    else if (arg == "--dump" && i + 1 < argc)
+    {
+      dumpPath = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: fake-device [--write-us N] [--corrupt-every N] [--dump FILE]\n");
+      return 2;
+    }
+  }
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    perror("posix_openpt");
+    return 1;
+  }
+
+  // Keep the slave open in raw mode: no echo back to the device, and the
+  // master stays readable across client connections
+  const char *slavePath = ptsname(master);
+  int slave = open(slavePath, O_RDWR | O_NOCTTY);
+  if (slave < 0 || !PosixStream::configureRaw(slave, 230400))
+  {
+    perror(slavePath);
+    return 1;
+  }
+
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  printf("%s\n", slavePath);
+  fflush(stdout);
+
+  PosixStream pty(master);
+  CorruptingStream stream(pty, corruptEvery);
+  MemoryPageStore store(writeMicros);
+  MemoryDiagnostics diagnostics(store);
+  MemoryEmulator emulator(pty);
+  ProgrammerServer server(stream, store, &diagnostics, &emulator);
+
+  while (running)
+  {
+    pty.waitReadable(1);
+    server.poll();
+  }
+
+  server.flush();
+  if (dumpPath && !store.dump(dumpPath))
+  {
+    perror(dumpPath);
+    return 1;
+  }
+
+  close(slave);
+  close(master);
+  return 0;
+}
@@ -0,0 +1,1132 @@
+// Host side of the streaming protocol: sends an image to the resident
+// programmer firmware page by page with two pages in flight, then reads it
+// back to verify.
+//
+// usage: programmer-client [options] <serial-device> [image]
+//   --baud N       serial speed (default 230400)
+//   --start ADDR   first EEPROM address (default 0)
+//   --lane low|high  byte lane of a .hack image (default low)
+//   --protected    write with the software data protection unlock sequence
+//   --no-verify    skip the read-back
+//   --no-manifest  write and verify every page, without the chip's image
+//                  manifest (which picks the changed pages from their hashes)
+//   --erase        software chip erase first; pages of 0xFF then cost no write cycle
+//   --blank-check  report whether the chip is erased (after --erase, before the image)
+//   --characterize ADDR  measure the chip's timing on the page holding ADDR
+//                  (restored afterwards); the device uses it until reset
+//   --benchmark ADDR:LEN  time write, verify and dump of a scratch region
+//                  on the device (overwrites it)
+//   --stats        print the device's write path instrumentation
+//   --reset-stats  as --stats, then clear the counters
+//   --capture FILE sample the bus of the board the programmer is clipped
+//                  onto (all pins inputs) and write the trace as a VCD file;
+//                  prints which addresses were fetched and how often
+//   --trigger ADDR   start the capture at the first fetch of ADDR
+//   --pre-trigger N  samples kept before the trigger (default 128)
+//   --rate HZ        sample rate (default 1000000)
+//   --capture-timeout MS  how long to wait for the trigger (default 5000)
+//   --emulate      load the image into the device's RAM instead of the chip
+//                  and serve it to the board's CPU as its ROM, until the
+//                  next command; prints the fastest CPU clock it keeps up with
+
+#include "ImageManifest.h"
+#include "PosixStream.h"
+#include "ProgrammingProtocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace ProgrammingProtocol;
+
+namespace
+{
+  const uint32_t EEPROM_SIZE = 32768;
+  const int ACK_TIMEOUT_MS = 250;
+  const int REPLY_TIMEOUT_MS = 300;
+  const int MAX_ATTEMPTS = 8;
+  const int BENCHMARK_MS_PER_PAGE = 40; // Write cycle, read-back and the write timeout's margin
+  const int CHARACTERIZE_TIMEOUT_MS = 2000; // About 40 page writes while the settle times are bisected
+  const int CAPTURE_MARGIN_MS = 1000;       // On top of the trigger timeout, for filling the buffer
+  const size_t CAPTURE_TOP_ADDRESSES = 10;
+
+  typedef std::chrono::steady_clock Clock;
+
+  struct Options
+  {
+    const char *device = nullptr;
+    const char *image = nullptr;
+    int baudRate = 230400;
+    uint32_t start = 0;
+    bool highLane = false;
+    bool sdpProtected = false;
+    bool verify = true;
+    bool manifest = true;
+    bool erase = false;
+    bool blankCheck = false;
+    bool characterize = false;
+    uint32_t characterizeAddress = 0;
+    bool stats = false;
+    bool resetStats = false;
+    uint32_t benchmarkAddress = 0;
+    uint32_t benchmarkLength = 0;
+    const char *captureFile = nullptr;
+    bool trigger = false;
+    uint32_t triggerAddress = 0;
+    uint32_t preTrigger = 128;
+    uint32_t sampleRateHz = 1000000;
+    uint32_t captureTimeoutMs = 5000;
+    bool emulate = false;
+  };
+
+  struct Page
+  {
+    uint16_t address;
+    uint32_t offset; // Into the image
+    uint8_t length;
+  };
+
+  struct InFlight
+  {
+    uint8_t seq;
+    size_t page;
+    Clock::time_point sentAt;
+    int attempts;
+  };
+
+  bool endsWith(const std::string &text, const std::string &suffix)
+  {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  // A .hack file holds one 16-bit instruction per line as binary text; each
+  // chip of the pair gets one byte lane. Anything else is a raw binary.
+  bool loadImage(const Options &options, std::vector<uint8_t> &image)
+  {
+    std::ifstream file(options.image, std::ios::binary);
+    if (!file)
+    {
+      fprintf(stderr, "cannot open %s\n", options.image);
+      return false;
+    }
+
+    if (!endsWith(options.image, ".hack"))
+    {
+      image.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      return true;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+      lineNumber++;
+      if (!line.empty() && line.back() == '\r')
+      {
+        line.pop_back();
+      }
+      if (line.empty())
+      {
+        continue;
+      }
+      if (line.size() != 16 || line.find_first_not_of("01") != std::string::npos)
+      {
+        fprintf(stderr, "%s:%d: expected 16 binary digits\n", options.image, lineNumber);
+        return false;
+      }
+
+      uint16_t instruction = (uint16_t)strtoul(line.c_str(), nullptr, 2);
+      image.push_back(options.highLane ? (uint8_t)(instruction >> 8) : (uint8_t)(instruction & 0xFF));
+    }
+    return true;
+  }
+
+  // Split the image on page boundaries starting at the first address
+  std::vector<Page> splitPages(uint32_t start, size_t size)
+  {
+    std::vector<Page> pages;
+    uint32_t offset = 0;
+    while (offset < size)
+    {
+      uint32_t address = start + offset;
+      uint32_t length = PAGE_SIZE - (address & (PAGE_SIZE - 1));
+      if (length > size - offset)
+      {
+        length = (uint32_t)(size - offset);
+      }
+      pages.push_back({(uint16_t)address, offset, (uint8_t)length});
+      offset += length;
+    }
+    return pages;
+  }
+
+  class Client
+  {
+  public:
+    explicit Client(PosixStream &stream) : stream(stream), nextSeq(0), retransmissions(0) {}
+
+    uint8_t send(uint8_t type, const uint8_t *payload, uint8_t length)
+    {
+      uint8_t seq = nextSeq++;
+      resend(type, seq, payload, length);
+      return seq;
+    }
+
+    void resend(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length)
+    {
+      uint8_t buffer[MAX_PAYLOAD + FRAME_OVERHEAD];
+      size_t size = encodeFrame(type, seq, payload, length, buffer);
+      stream.write(buffer, (uint16_t)size);
+    }
+
+    // Wait for the next valid frame from the device
+    bool receive(Frame &frame, int timeoutMs)
+    {
+      Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+      while (true)
+      {
+        int byte;
+        while ((byte = stream.read()) >= 0)
+        {
+          if (parser.push((uint8_t)byte) == FrameParser::PARSE_FRAME)
+          {
+            frame = parser.frame();
+            return true;
+          }
+        }
+
+        int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0 || !stream.waitReadable(remaining))
+        {
+          return false;
+        }
+      }
+    }
+
+    // Stop-and-wait exchange for the non-streaming frames
+    bool request(uint8_t type, const uint8_t *payload, uint8_t length, uint8_t replyType, Frame &reply,
+                 int timeoutMs = REPLY_TIMEOUT_MS)
+    {
+      uint8_t seq = send(type, payload, length);
+      for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++)
+      {
+        Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (Clock::now() < deadline)
+        {
+          int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+          if (receive(reply, remaining) && reply.seq == seq && reply.type == replyType)
+          {
+            return true;
+          }
+        }
+
+        retransmissions++;
+        resend(type, seq, payload, length);
+      }
+      return false;
+    }
+
+    // Pages go out as FRAME_WRITE, or FRAME_EMULATE_LOAD for the emulated ROM
+    bool program(const std::vector<uint8_t> &image, const std::vector<Page> &pages, uint8_t frameType = FRAME_WRITE)
+    {
+      std::deque<InFlight> inFlight;
+      size_t next = 0;
+
+      while (next < pages.size() || !inFlight.empty())
+      {
+        while (inFlight.size() < WINDOW && next < pages.size())
+        {
+          inFlight.push_back({sendPage(image, pages[next], nextSeq++, frameType), next, Clock::now(), 1});
+          next++;
+        }
+
+        Frame frame;
+        int waitMs = ACK_TIMEOUT_MS - (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - inFlight.front().sentAt).count();
+        if (waitMs > 0 && receive(frame, waitMs))
+        {
+          if (frame.type != FRAME_ACK || frame.length < 3)
+          {
+            continue;
+          }
+
+          for (auto it = inFlight.begin(); it != inFlight.end(); ++it)
+          {
+            if (it->seq != frame.seq)
+            {
+              continue;
+            }
+
+            uint8_t status = frame.payload[0];
+            if (status == STATUS_OK)
+            {
+              inFlight.erase(it);
+            }
+            else if (status == STATUS_BAD_CRC)
+            {
+              if (!retry(image, pages, *it, frameType))
+              {
+                return false;
+              }
+            }
+            else if (status == STATUS_WRITE_FAILED)
+            {
+              fprintf(stderr, "write failed at 0x%04X\n", readLE16(frame.payload + 1));
+              return false;
+            }
+            else
+            {
+              fprintf(stderr, "device rejected page at 0x%04X (status %u)\n", pages[it->page].address, status);
+              return false;
+            }
+            break;
+          }
+          continue;
+        }
+
+        // No acknowledgement in time: send everything in flight again. The
+        // device may see a page twice, which rewrites it with the same data.
+        for (InFlight &entry : inFlight)
+        {
+          if (!retry(image, pages, entry, frameType))
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    int retransmissionCount() const
+    {
+      return retransmissions;
+    }
+
+  private:
+    PosixStream &stream;
+    FrameParser parser;
+    uint8_t nextSeq;
+    int retransmissions;
+
+    uint8_t sendPage(const std::vector<uint8_t> &image, const Page &page, uint8_t seq, uint8_t frameType)
+    {
+      uint8_t payload[2 + PAGE_SIZE];
+      writeLE16(payload, page.address);
+      memcpy(payload + 2, image.data() + page.offset, page.length);
+      resend(frameType, seq, payload, (uint8_t)(2 + page.length));
+      return seq;
+    }
+
+    bool retry(const std::vector<uint8_t> &image, const std::vector<Page> &pages, InFlight &entry, uint8_t frameType)
+    {
+      if (++entry.attempts > MAX_ATTEMPTS)
+      {
+        fprintf(stderr, "no acknowledgement for page at 0x%04X\n", pages[entry.page].address);
+        return false;
+      }
+
+      retransmissions++;
+      sendPage(image, pages[entry.page], entry.seq, frameType);
+      entry.sentAt = Clock::now();
+      return true;
+    }
+  };
+
+  void usage()
+  {
+    fprintf(stderr, "usage: programmer-client [--baud N] [--start ADDR] [--lane low|high] [--protected] [--no-verify]\n"
+                    "                         [--no-manifest] [--erase] [--blank-check] [--characterize ADDR] [--benchmark ADDR:LEN]\n"
+                    "                         [--stats] [--reset-stats] [--capture FILE [--trigger ADDR]\n"
+                    "                         [--pre-trigger N] [--rate HZ] [--capture-timeout MS]] [--emulate]\n"
+                    "                         <serial-device> [image]\n");
+  }
+
+  bool parseOptions(int argc, char **argv, Options &options)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      std::string arg = argv[i];
+      if (arg == "--baud" && i + 1 < argc)
+      {
+        options.baudRate = atoi(argv[++i]);
+      }
+      else if (arg == "--start" && i + 1 < argc)
+      {
+        options.start = (uint32_t)strtoul(argv[++i], nullptr, 0);
+      }
+      else if (arg == "--lane" && i + 1 < argc)
+      {
+        std::string lane = argv[++i];
+        if (lane != "low" && lane != "high")
+        {
+          return false;
+        }
+        options.highLane = lane == "high";
+      }
+      else if (arg == "--protected")
+      {
+        options.sdpProtected = true;
+      }
+      else if (arg == "--no-verify")
+      {
+        options.verify = false;
+      }
+      else if (arg == "--no-manifest")
+      {
+        options.manifest = false;
+      }
+      else if (arg == "--erase")
+      {
+        options.erase = true;
+      }
+      else if (arg == "--blank-check")
+      {
+        options.blankCheck = true;
+      }
+      else if (arg == "--characterize" && i + 1 < argc)
+      {
+        options.characterize = true;
+        options.characterizeAddress = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        if (options.characterizeAddress >= EEPROM_SIZE)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--benchmark" && i + 1 < argc)
+      {
+        char *end;
+        options.benchmarkAddress = (uint32_t)strtoul(argv[++i], &end, 0);
+        if (*end != ':')
+        {
+          return false;
+        }
+        options.benchmarkLength = (uint32_t)strtoul(end + 1, nullptr, 0);
+        if (options.benchmarkLength == 0 || options.benchmarkAddress + options.benchmarkLength > EEPROM_SIZE)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--stats" || arg == "--reset-stats")
+      {
+        options.stats = true;
+        options.resetStats = arg == "--reset-stats";
+      }
+      else if (arg == "--capture" && i + 1 < argc)
+      {
+        options.captureFile = argv[++i];
+      }
+      else if (arg == "--trigger" && i + 1 < argc)
+      {
+        options.trigger = true;
+        options.triggerAddress = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        if (options.triggerAddress >= EEPROM_SIZE)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--pre-trigger" && i + 1 < argc)
+      {
+        options.preTrigger = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        if (options.preTrigger > 0xFFFF)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--rate" && i + 1 < argc)
+      {
+        options.sampleRateHz = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        if (options.sampleRateHz == 0)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--capture-timeout" && i + 1 < argc)
+      {
+        options.captureTimeoutMs = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        if (options.captureTimeoutMs > 0xFFFF)
+        {
+          return false;
+        }
+      }
+      else if (arg == "--emulate")
+      {
+        options.emulate = true;
+      }
+      else if (!options.device)
+      {
+        options.device = argv[i];
+      }
+      else if (!options.image)
+      {
+        options.image = argv[i];
+      }
+      else
+      {
+        return false;
+      }
+    }
+    if (options.emulate && !options.image)
+    {
+      return false;
+    }
+    return options.device &&
+           (options.image || options.erase || options.blankCheck || options.characterize || options.benchmarkLength ||
+            options.stats || options.captureFile);
+  }
+
+  double millisecondsSince(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  double bytesPerSecond(uint32_t bytes, uint32_t micros)
+  {
+    return bytes * 1e6 / (micros > 0 ? micros : 1);
+  }
+
+  bool eraseChip(Client &client)
+  {
+    Frame reply;
+    Clock::time_point started = Clock::now();
+    if (!client.request(FRAME_ERASE, nullptr, 0, FRAME_ACK, reply) || reply.length < 1)
+    {
+      fprintf(stderr, "erase not supported or no result\n");
+      return false;
+    }
+    if (reply.payload[0] != STATUS_OK)
+    {
+      fprintf(stderr, "chip erase failed\n");
+      return false;
+    }
+
+    printf("Erased chip in %.1f ms\n", millisecondsSince(started));
+    return true;
+  }
+
+  bool blankCheck(Client &client)
+  {
+    uint8_t payload[4];
+    writeLE16(payload, 0);
+    writeLE16(payload + 2, (uint16_t)EEPROM_SIZE);
+
+    Frame reply;
+    Clock::time_point started = Clock::now();
+    if (!client.request(FRAME_BLANK_CHECK, payload, sizeof(payload), FRAME_BLANK_RESULT, reply) || reply.length < 3)
+    {
+      fprintf(stderr, "blank check not supported or no result\n");
+      return false;
+    }
+
+    double elapsedMs = millisecondsSince(started);
+    if (!reply.payload[0])
+    {
+      printf("Not blank: 0x%04X holds data (%.1f ms)\n", readLE16(reply.payload + 1), elapsedMs);
+      return false;
+    }
+    printf("Chip is blank (%.1f ms)\n", elapsedMs);
+    return true;
+  }
+
+  bool readChip(Client &client, uint16_t address, uint16_t length, uint8_t *data)
+  {
+    for (uint16_t offset = 0; offset < length;)
+    {
+      uint8_t chunk = (uint8_t)std::min<uint16_t>(length - offset, PAGE_SIZE);
+      uint8_t payload[3];
+      writeLE16(payload, (uint16_t)(address + offset));
+      payload[2] = chunk;
+
+      Frame reply;
+      if (!client.request(FRAME_READ, payload, sizeof(payload), FRAME_DATA, reply) || reply.length != 2 + chunk)
+      {
+        fprintf(stderr, "read failed at 0x%04X\n", address + offset);
+        return false;
+      }
+      memcpy(data + offset, reply.payload + 2, chunk);
+      offset += chunk;
+    }
+    return true;
+  }
+
+  // Drop the pages whose hash matches the chip's manifest, and append the
+  // new manifest to tail: tablePages to write after the image, then the
+  // header page. Reads the header and, if the image changed, the table.
+  bool applyManifest(Client &client, uint16_t start, const std::vector<uint8_t> &image, std::vector<Page> &pages,
+                     std::vector<uint8_t> &tail, std::vector<Page> &tablePages, std::vector<Page> &headerPage)
+  {
+    std::vector<uint32_t> crcs;
+    for (const Page &page : pages)
+    {
+      crcs.push_back(ImageManifest::crc32(image.data() + page.offset, page.length));
+    }
+
+    ImageManifest::Header manifest;
+    manifest.imageId = ImageManifest::crc32(image.data(), image.size());
+    manifest.start = start;
+    manifest.length = (uint16_t)image.size();
+
+    uint8_t header[ImageManifest::HEADER_SIZE];
+    ImageManifest::Header stored;
+    if (!readChip(client, ImageManifest::HEADER_ADDRESS, sizeof(header), header))
+    {
+      return false;
+    }
+    bool known = ImageManifest::decodeHeader(header, stored) && stored.start == start;
+
+    std::vector<bool> same(pages.size(), false);
+    if (known && stored.imageId == manifest.imageId && stored.length == manifest.length)
+    {
+      printf("Manifest: image unchanged, nothing to write\n");
+      pages.clear();
+      return true;
+    }
+    if (known)
+    {
+      uint16_t storedPages = ImageManifest::pageCount(stored.start, stored.length);
+      std::vector<uint8_t> table(storedPages * ImageManifest::ENTRY_SIZE);
+      if (!readChip(client, ImageManifest::entryAddress(start), (uint16_t)table.size(), table.data()))
+      {
+        return false;
+      }
+
+      known = ImageManifest::crc32(table.data(), table.size()) == stored.tableCrc;
+      for (size_t i = 0; known && i < pages.size() && i < storedPages; i++)
+      {
+        same[i] = readLE32(table.data() + i * ImageManifest::ENTRY_SIZE) == crcs[i];
+      }
+    }
+
+    std::vector<Page> changed;
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+      if (!same[i])
+      {
+        changed.push_back(pages[i]);
+      }
+    }
+    if (known)
+    {
+      printf("Manifest: %zu of %zu pages changed\n", changed.size(), pages.size());
+    }
+    else
+    {
+      printf("Manifest: none on the chip for this image, writing every page\n");
+    }
+    pages = changed;
+
+    tail.resize(crcs.size() * ImageManifest::ENTRY_SIZE + ImageManifest::HEADER_SIZE);
+    for (size_t i = 0; i < crcs.size(); i++)
+    {
+      writeLE32(tail.data() + i * ImageManifest::ENTRY_SIZE, crcs[i]);
+    }
+    manifest.tableCrc = ImageManifest::crc32(tail.data(), crcs.size() * ImageManifest::ENTRY_SIZE);
+    ImageManifest::encodeHeader(manifest, tail.data() + crcs.size() * ImageManifest::ENTRY_SIZE);
+
+    tablePages = splitPages(ImageManifest::entryAddress(start), crcs.size() * ImageManifest::ENTRY_SIZE);
+    headerPage = {{ImageManifest::HEADER_ADDRESS, (uint32_t)(crcs.size() * ImageManifest::ENTRY_SIZE),
+                   (uint8_t)ImageManifest::HEADER_SIZE}};
+    return true;
+  }
+
+  bool programImage(Client &client, const Options &options, const std::vector<uint8_t> &image)
+  {
+    Frame reply;
+    std::vector<Page> pages = splitPages(options.start, image.size());
+    printf("Programming %zu bytes (%zu pages) at 0x%04X\n", image.size(), pages.size(), options.start);
+
+    // The device invalidates the manifest on the first write of the
+    // session, and the header goes out on its own after everything else
+    Clock::time_point started = Clock::now();
+    std::vector<uint8_t> tail;
+    std::vector<Page> tablePages, headerPage;
+    if (options.manifest && ImageManifest::fits((uint16_t)options.start, (uint16_t)image.size()) &&
+        !applyManifest(client, (uint16_t)options.start, image, pages, tail, tablePages, headerPage))
+    {
+      return false;
+    }
+    if (pages.empty() && tablePages.empty())
+    {
+      return true;
+    }
+
+    bool streamed = client.program(image, pages) && client.program(tail, tablePages) &&
+                    client.program(tail, headerPage);
+
+    if (!client.request(FRAME_FINISH, nullptr, 0, FRAME_RESULT, reply) || reply.length < 5)
+    {
+      fprintf(stderr, "no result from programmer\n");
+      return false;
+    }
+    double elapsedMs = millisecondsSince(started);
+
+    uint16_t pagesWritten = readLE16(reply.payload + 1);
+    uint16_t pagesFailed = readLE16(reply.payload + 3);
+    uint16_t pagesUnchanged = reply.length >= 7 ? readLE16(reply.payload + 5) : 0;
+    if (!streamed || reply.payload[0] != STATUS_OK)
+    {
+      fprintf(stderr, "Programming failed (%s): wrote %u pages, skipped %u unchanged, %u failed\n",
+              streamed ? "device reported an error" : "pages not acknowledged", pagesWritten, pagesUnchanged,
+              pagesFailed);
+      return false;
+    }
+
+    // Manifest-skipped pages never went out; the device's own skips did
+    size_t bytesSent = 0;
+    for (const std::vector<Page> *sent : {&pages, &tablePages, &headerPage})
+    {
+      for (const Page &page : *sent)
+      {
+        bytesSent += page.length;
+      }
+    }
+    printf("Wrote %u pages, skipped %u unchanged (%u failed) in %.1f ms, %.0f bytes/s, %d retransmissions\n",
+           pagesWritten, pagesUnchanged, pagesFailed, elapsedMs, bytesSent * 1000.0 / elapsedMs,
+           client.retransmissionCount());
+
+    if (options.verify)
+    {
+      started = Clock::now();
+      size_t mismatches = 0;
+      for (const Page &page : pages)
+      {
+        uint8_t payload[3];
+        writeLE16(payload, page.address);
+        payload[2] = page.length;
+        if (!client.request(FRAME_READ, payload, sizeof(payload), FRAME_DATA, reply) || reply.length != 2 + page.length)
+        {
+          fprintf(stderr, "read back failed at 0x%04X\n", page.address);
+          return false;
+        }
+
+        for (uint8_t i = 0; i < page.length; i++)
+        {
+          if (reply.payload[2 + i] != image[page.offset + i] && mismatches++ < 16)
+          {
+            fprintf(stderr, "mismatch at 0x%04X: expected 0x%02X, read 0x%02X\n",
+                    page.address + i, image[page.offset + i], reply.payload[2 + i]);
+          }
+        }
+      }
+
+      printf("Verified %zu pages in %.1f ms: %zu mismatched bytes\n", pages.size(), millisecondsSince(started),
+             mismatches);
+      if (mismatches)
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool characterize(Client &client, const Options &options)
+  {
+    uint8_t payload[2];
+    writeLE16(payload, (uint16_t)options.characterizeAddress);
+
+    Frame reply;
+    TimingReport report;
+    if (!client.request(FRAME_CHARACTERIZE, payload, sizeof(payload), FRAME_TIMING, reply, CHARACTERIZE_TIMEOUT_MS) ||
+        !decodeTiming(reply.payload, reply.length, report))
+    {
+      fprintf(stderr, "characterization not supported or no result\n");
+      return false;
+    }
+    if (report.status != STATUS_OK)
+    {
+      fprintf(stderr, "characterization failed; the device keeps its previous timing\n");
+      return false;
+    }
+
+    printf("Timing with margin, on top of the bus accesses\n");
+    printf("  address to data  %6u ns\n", report.accessNs);
+    printf("  output enable    %6u ns\n", report.outputEnableNs);
+    printf("  first read       %6u ns\n", report.firstReadNs);
+    printf("  first write      %6u ns\n", report.firstWriteNs);
+    printf("  write cycle      %6u us, timeout %u us\n", report.writeCycleMicros, report.writeTimeoutMicros);
+    return true;
+  }
+
+  bool runBenchmark(Client &client, const Options &options)
+  {
+    uint8_t payload[4];
+    writeLE16(payload, (uint16_t)options.benchmarkAddress);
+    writeLE16(payload + 2, (uint16_t)options.benchmarkLength);
+
+    Frame reply;
+    BenchmarkResult result;
+    int timeoutMs = REPLY_TIMEOUT_MS + (int)(options.benchmarkLength / PAGE_SIZE + 2) * BENCHMARK_MS_PER_PAGE;
+    if (!client.request(FRAME_BENCHMARK, payload, sizeof(payload), FRAME_BENCHMARK_RESULT, reply, timeoutMs) ||
+        !decodeBenchmark(reply.payload, reply.length, result))
+    {
+      fprintf(stderr, "benchmark not supported or no result\n");
+      return false;
+    }
+
+    printf("Benchmark of %u bytes at 0x%04X%s\n", result.length, options.benchmarkAddress,
+           result.status == STATUS_OK ? "" : " (FAILED)");
+    printf("  write  %10.1f ms %10.0f bytes/s\n", result.writeMicros / 1000.0,
+           bytesPerSecond(result.length, result.writeMicros));
+    printf("  verify %10.1f ms %10.0f bytes/s\n", result.verifyMicros / 1000.0,
+           bytesPerSecond(result.length, result.verifyMicros));
+    printf("  dump   %10.1f ms %10.0f bytes/s\n", result.dumpMicros / 1000.0,
+           bytesPerSecond(result.length, result.dumpMicros));
+    return result.status == STATUS_OK;
+  }
+
+  // Trace as a VCD file (GTKWave, PulseView); control lines are active low
+  bool writeVcd(const char *path, const std::vector<CaptureSample> &samples, const CaptureInfo &info)
+  {
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+      fprintf(stderr, "cannot write %s\n", path);
+      return false;
+    }
+
+    fprintf(file, "$timescale 1 ns $end\n$scope module rom $end\n");
+    fprintf(file, "$var wire 15 a address $end\n$var wire 8 d data $end\n");
+    fprintf(file, "$var wire 1 c ce_n $end\n$var wire 1 o oe_n $end\n$var wire 1 w we_n $end\n");
+    fprintf(file, "$var wire 1 t trigger $end\n$upscope $end\n$enddefinitions $end\n");
+
+    // Values only where they change, as VCD readers expect
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+      const CaptureSample &sample = samples[i];
+      const CaptureSample *previous = i > 0 ? &samples[i - 1] : nullptr;
+      bool trigger = info.triggered && i == info.triggerIndex;
+      bool triggerEdge = i == 0 || trigger || (info.triggered && i == info.triggerIndex + 1u);
+      if (previous && previous->address == sample.address && previous->data == sample.data &&
+          previous->control == sample.control && !triggerEdge)
+      {
+        continue;
+      }
+
+      fprintf(file, "#%llu\n", (unsigned long long)(i * 1000000000ULL / info.sampleRateHz));
+      if (!previous || previous->address != sample.address)
+      {
+        fputc('b', file);
+        for (int bit = 14; bit >= 0; bit--)
+        {
+          fputc('0' + ((sample.address >> bit) & 1), file);
+        }
+        fprintf(file, " a\n");
+      }
+      if (!previous || previous->data != sample.data)
+      {
+        fputc('b', file);
+        for (int bit = 7; bit >= 0; bit--)
+        {
+          fputc('0' + ((sample.data >> bit) & 1), file);
+        }
+        fprintf(file, " d\n");
+      }
+      if (!previous || previous->control != sample.control)
+      {
+        fprintf(file, "%dc\n%do\n%dw\n", (sample.control & CAPTURE_CE) ? 1 : 0, (sample.control & CAPTURE_OE) ? 1 : 0,
+                (sample.control & CAPTURE_WE) ? 1 : 0);
+      }
+      if (triggerEdge)
+      {
+        fprintf(file, "%dt\n", trigger ? 1 : 0);
+      }
+    }
+
+    fclose(file);
+    return true;
+  }
+
+  // Each run of samples on one address counts as a fetch; its last sample
+  // is the settled data. An address that settles to different values on
+  // different fetches points at bus timing trouble.
+  void printFetchProfile(const std::vector<CaptureSample> &samples, const CaptureInfo &info)
+  {
+    struct AddressStats
+    {
+      uint32_t fetches = 0;
+      int settled = -1;
+      bool unstable = false;
+    };
+
+    std::map<uint16_t, AddressStats> addresses;
+    uint32_t fetches = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+      bool runEnds = i + 1 == samples.size() || samples[i + 1].address != samples[i].address;
+      bool runStarts = i == 0 || samples[i - 1].address != samples[i].address;
+      if (!runEnds)
+      {
+        continue;
+      }
+
+      AddressStats &entry = addresses[samples[i].address];
+      entry.fetches++;
+      fetches++;
+      if (!runStarts) // Single samples may have caught the address mid-change
+      {
+        if (entry.settled >= 0 && entry.settled != samples[i].data)
+        {
+          entry.unstable = true;
+        }
+        entry.settled = samples[i].data;
+      }
+    }
+
+    double seconds = samples.size() / (double)info.sampleRateHz;
+    printf("Captured %zu samples at %u Hz (%.3f ms)", samples.size(), info.sampleRateHz, seconds * 1000);
+    if (info.triggered)
+    {
+      printf(", trigger at sample %u", info.triggerIndex);
+    }
+    printf("\n  %u fetches of %zu addresses, %.0f fetches/s\n", fetches, addresses.size(),
+           seconds > 0 ? fetches / seconds : 0.0);
+    if (info.missedSamples)
+    {
+      printf("  %u samples were not checked for the trigger (rate too high for the scan)\n", info.missedSamples);
+    }
+
+    std::vector<std::pair<uint16_t, AddressStats>> ranked(addresses.begin(), addresses.end());
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const std::pair<uint16_t, AddressStats> &a, const std::pair<uint16_t, AddressStats> &b)
+                     { return a.second.fetches > b.second.fetches; });
+    for (size_t i = 0; i < ranked.size() && i < CAPTURE_TOP_ADDRESSES; i++)
+    {
+      printf("  0x%04X %8u fetches\n", ranked[i].first, ranked[i].second.fetches);
+    }
+    for (const auto &entry : ranked)
+    {
+      if (entry.second.unstable)
+      {
+        printf("  0x%04X settled to different data on different fetches\n", entry.first);
+      }
+    }
+  }
+
+  bool captureBus(Client &client, const Options &options)
+  {
+    CaptureRequest request;
+    request.flags = options.trigger ? FLAG_CAPTURE_TRIGGER : 0;
+    request.triggerAddress = (uint16_t)options.triggerAddress;
+    request.preTrigger = (uint16_t)options.preTrigger;
+    request.sampleRateHz = options.sampleRateHz;
+    request.timeoutMs = (uint16_t)options.captureTimeoutMs;
+
+    uint8_t payload[CAPTURE_REQUEST_SIZE];
+    Frame reply;
+    CaptureInfo info;
+    int timeoutMs = (int)options.captureTimeoutMs + CAPTURE_MARGIN_MS;
+    if (!client.request(FRAME_CAPTURE, payload, encodeCaptureRequest(request, payload), FRAME_CAPTURE_INFO, reply,
+                        timeoutMs) ||
+        !decodeCaptureInfo(reply.payload, reply.length, info))
+    {
+      fprintf(stderr, "capture not supported or no result\n");
+      return false;
+    }
+    if (info.status == STATUS_TIMEOUT)
+    {
+      fprintf(stderr, "no fetch of 0x%04X within %u ms; saving the samples before the timeout\n",
+              options.triggerAddress, options.captureTimeoutMs);
+    }
+
+    std::vector<CaptureSample> samples;
+    while (samples.size() < info.sampleCount)
+    {
+      uint8_t read[3];
+      writeLE16(read, (uint16_t)samples.size());
+      read[2] = (uint8_t)std::min<size_t>(CAPTURE_SAMPLES_PER_FRAME, info.sampleCount - samples.size());
+      if (!client.request(FRAME_CAPTURE_READ, read, sizeof(read), FRAME_CAPTURE_DATA, reply) || reply.length < 2 ||
+          readLE16(reply.payload) != samples.size() || reply.length == 2)
+      {
+        fprintf(stderr, "reading the capture failed at sample %zu\n", samples.size());
+        return false;
+      }
+      for (uint8_t offset = 2; offset + CAPTURE_SAMPLE_SIZE <= reply.length; offset += CAPTURE_SAMPLE_SIZE)
+      {
+        samples.push_back(decodeCaptureSample(reply.payload + offset));
+      }
+    }
+
+    printFetchProfile(samples, info);
+    return writeVcd(options.captureFile, samples, info) && info.status == STATUS_OK;
+  }
+
+  bool describeEmulation(Client &client, uint8_t flags, EmulationInfo &info)
+  {
+    Frame reply;
+    if (!client.request(FRAME_EMULATE, &flags, 1, FRAME_EMULATION_INFO, reply) ||
+        !decodeEmulationInfo(reply.payload, reply.length, info) || info.status != STATUS_OK)
+    {
+      fprintf(stderr, "ROM emulation not supported\n");
+      return false;
+    }
+    return true;
+  }
+
+  // Load the image into the device's RAM and leave it serving; the next
+  // frame from any client stops it
+  bool emulateImage(Client &client, const Options &options, const std::vector<uint8_t> &image)
+  {
+    EmulationInfo info;
+    if (!describeEmulation(client, 0, info))
+    {
+      return false;
+    }
+    if (options.start + image.size() > info.capacity)
+    {
+      fprintf(stderr, "image of %zu bytes at 0x%04X does not fit the %u byte emulated ROM\n", image.size(),
+              options.start, info.capacity);
+      return false;
+    }
+
+    std::vector<Page> pages = splitPages(options.start, image.size());
+    Clock::time_point started = Clock::now();
+    if (!client.program(image, pages, FRAME_EMULATE_LOAD) || !describeEmulation(client, FLAG_EMULATE_RUN, info))
+    {
+      return false;
+    }
+
+    printf("Serving %zu bytes as ROM after %.1f ms, %d retransmissions\n", image.size(), millisecondsSince(started),
+           client.retransmissionCount());
+    printf("Access time %u ns (%u cycles per pass), CPU clock up to %.3f MHz\n", info.accessNs, info.loopCycles,
+           info.maxClockHz / 1e6);
+    if (info.capacity < EEPROM_SIZE)
+    {
+      printf("Addresses from 0x%04X on mirror the image (address modulo %u); code there runs the mirrored bytes\n",
+             info.capacity, info.capacity);
+    }
+    if (info.lanes < 2)
+    {
+      printf("Only the clipped socket's byte lane is emulated; the other lane's chip must hold its half\n");
+    }
+    return true;
+  }
+
+  bool printStats(Client &client, bool reset)
+  {
+    static const char *const PHASES[STATS_PHASES] = {"address setup", "bus turnaround", "WE pulse",
+                                                     "completion polling"};
+
+    uint8_t flags = reset ? FLAG_RESET_STATS : 0;
+    Frame reply;
+    DeviceStats stats;
+    if (!client.request(FRAME_STATS, &flags, 1, FRAME_STATS_DATA, reply) ||
+        !decodeStats(reply.payload, reply.length, stats))
+    {
+      fprintf(stderr, "statistics not supported or no result\n");
+      return false;
+    }
+
+    printf("Write path instrumentation\n");
+    for (uint8_t phase = 0; phase < STATS_PHASES; phase++)
+    {
+      printf("  %-20s %10.1f ms %8u times\n", PHASES[phase], stats.phaseMicros[phase] / 1000.0,
+             stats.phaseCount[phase]);
+    }
+    printf("  %u write cycles, %u retries, %u timeouts\n", stats.writeCycles, stats.retries, stats.timeouts);
+    for (uint8_t bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; bucket++)
+    {
+      if (bucket + 1 < STATS_HISTOGRAM_BUCKETS)
+      {
+        printf("  < %6u us %8u\n", STATS_HISTOGRAM_BASE_US << bucket, stats.histogram[bucket]);
+      }
+      else
+      {
+        printf("  longer    %8u\n", stats.histogram[bucket]);
+      }
+    }
+    return true;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Options options;
+  if (!parseOptions(argc, argv, options))
+  {
+    usage();
+    return 2;
+  }
+
+  std::vector<uint8_t> image;
+  if (options.image)
+  {
+    if (!loadImage(options, image))
+    {
+      return 1;
+    }
+    if (image.empty() || options.start + image.size() > EEPROM_SIZE)
+    {
+      fprintf(stderr, "image of %zu bytes does not fit at 0x%04X\n", image.size(), options.start);
+      return 1;
+    }
+  }
+
+  int fd = open(options.device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0 || !PosixStream::configureRaw(fd, options.baudRate))
+  {
+    fprintf(stderr, "cannot open %s\n", options.device);
+    return 1;
+  }
+
+  PosixStream stream(fd);
+  Client client(stream);
+  Frame reply;
+
+  uint8_t hello[2] = {(uint8_t)(options.sdpProtected ? FLAG_SDP_PROTECTED : 0), VERSION};
+  if (!client.request(FRAME_HELLO, hello, sizeof(hello), FRAME_HELLO, reply))
+  {
+    fprintf(stderr, "no response from programmer\n");
+    return 1;
+  }
+  if (reply.length < 4 || reply.payload[0] != VERSION || reply.payload[1] != PAGE_SIZE ||
+      reply.payload[3] != STATUS_OK)
+  {
+    fprintf(stderr, "unsupported programmer (protocol version %u, client %u)\n", reply.length ? reply.payload[0] : 0,
+            VERSION);
+    return 1;
+  }
+
+  if (options.erase && !eraseChip(client))
+  {
+    return 1;
+  }
+  if (options.blankCheck && !blankCheck(client))
+  {
+    return 1;
+  }
+  if (options.characterize && !characterize(client, options))
+  {
+    return 1;
+  }
+  if (options.image && !options.emulate && !programImage(client, options, image))
+  {
+    return 1;
+  }
+  if (options.benchmarkLength && !runBenchmark(client, options))
+  {
+    return 1;
+  }
+  if (options.stats && !printStats(client, options.resetStats))
+  {
+    return 1;
+  }
+  if (options.captureFile && !captureBus(client, options))
+  {
+    return 1;
+  }
+  if (options.emulate && !emulateImage(client, options, image))
+  {
+    return 1;
+  }
+
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef BURST_READER_H
+#define BURST_READER_H
+
+#include "stm32f1xx_hal.h"
+#include "EEPROMProgrammer.h"
+#include "DataSink.h"
+#include "ImageSource.h"
+
+// Timer-paced DMA reads for full-chip dumps and verification. TIM2 runs one
+// period per byte: its update event has DMA1 channel 2 copy the next address
+// word from a table in flash into GPIOA->BSRR (A0-A9), and its CC3/CC4
+// events, tACC later, have channels 1 and 7 sample GPIOB->IDR and
+// GPIOC->IDR (the data pins) into RAM. A10-A14 on GPIOB only change every
+// 1 KB and are set by the CPU between blocks. The CPU just remaps sampled
+// port words to bytes, overlapped with the next block's DMA run.
+//
+// Uses TIM2 and DMA1 channels 1, 2 and 7 (SerialLink keeps channel 3).
+class BurstReader
+{
+public:
+  static const uint16_t BLOCK_SIZE = 256;         // Bytes per DMA run, divides TABLE_SIZE
+  static const uint16_t TABLE_SIZE = 1024;        // One address word per A0-A9 value
+  static const uint32_t DMA_TRANSFER_CYCLES = 6;  // Arbitration, APB2 access and SRAM access
+  static const uint32_t BLOCK_TIMEOUT_US = 10000; // A block takes well under 1ms
+
+  BurstReader(EEPROMProgrammer &programmer);
+
+  // Enable the clocks and derive the timer period from SystemCoreClock
+  // (TIM2 runs at HCLK while the APB1 prescaler is 1 or 2)
+  void begin();
+
+  // As EEPROMProgrammer::dump/verify; false if a DMA run did not finish.
+  // verify always reads the whole range, even without a mismatch sink.
+  bool dump(uint16_t startAddress, uint16_t length, DataSink &sink);
+  bool verify(uint16_t startAddress, ImageSource &source, uint16_t length, MismatchSink *mismatches = nullptr);
+
+  uint32_t getPeriodCycles() const; // Core clock cycles per byte
+  uint32_t getSampleCycles() const; // From the address DMA request to the data samples
+
+private:
+  EEPROMProgrammer &programmer;
+  uint32_t periodCycles;
+  uint32_t sampleCycles;
+
+  // Sampled IDR words, double-buffered so remapping overlaps the next run
+  uint16_t samplesB[2][BLOCK_SIZE];
+  uint16_t samplesC[2][BLOCK_SIZE];
+
+  bool run(uint16_t startAddress, uint16_t length, DataSink &sink, bool shouldDelay);
+  void startBlock(uint16_t address, uint16_t count, int buffer, bool shouldDelay);
+  bool finishBlock();
+  void stop();
+  void emitBlock(uint16_t address, uint16_t count, int buffer, DataSink &sink);
+};
+
+#endif // BURST_READER_H
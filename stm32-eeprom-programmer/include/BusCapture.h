@@ -0,0 +1,97 @@
+#ifndef BUS_CAPTURE_H
+#define BUS_CAPTURE_H
+
+#include "stm32f1xx_hal.h"
+#include "BurstReader.h"
+#include "EEPROMProgrammer.h"
+#include "SharedBuffer.h"
+
+// Logic-analyzer mode for the ROM bus of another board, e.g. the homemade
+// CPU with the programmer clipped onto its ROM socket. Every programmer pin
+// is a floating input. TIM2 paces DMA1 channels 1, 2 and 7, which copy
+// GPIOA->IDR (A0-A9, CE, OE, WE), GPIOB->IDR (A10-A14, most data bits) and
+// GPIOC->IDR (D2) into three circular buffers on each sample. The CPU only
+// watches the newest samples for the trigger address and stops the timer
+// once enough samples follow it; decoding waits until the host reads them.
+//
+// The ports are read one DMA transfer apart, so a sample taken while the
+// bus changes can mix old and new values. Uses the same timer and DMA
+// channels as BurstReader; the two never run at once. The samples live in
+// a SharedBuffer, so they are gone once another mode takes it.
+class BusCapture
+{
+public:
+  static const uint16_t DEPTH = 1024; // Samples per buffer; one is lost to the partial sample at the stop
+  static const uint32_t MIN_PERIOD_CYCLES = 3 * BurstReader::DMA_TRANSFER_CYCLES;
+  static const uint32_t MAX_PERIOD_CYCLES = 65536; // TIM2 without prescaler
+  static const uint32_t MAX_TIMEOUT_US = 30000000; // Well inside the cycle counter's wrap at 72 MHz
+
+  struct Settings
+  {
+    uint32_t sampleRateHz;
+    bool useTrigger;
+    uint16_t triggerAddress;
+    uint16_t preTrigger; // Samples kept before the trigger, which is armed after them; at most DEPTH - 2
+    uint32_t timeoutUs;  // For the trigger, or for the DMA to fill the buffer
+  };
+
+  struct Result
+  {
+    bool triggered;
+    uint16_t sampleCount;
+    uint16_t triggerIndex; // Into the captured samples, valid if triggered
+    uint32_t periodCycles;
+    uint32_t missedSamples; // Skipped by the trigger scan because it fell behind
+  };
+
+  struct Sample
+  {
+    uint16_t address;
+    uint8_t data;
+    uint8_t control; // Line levels, see CONTROL_*
+  };
+
+  // Raw IDR words, one set per sample
+  struct Buffers
+  {
+    uint16_t samplesA[DEPTH];
+    uint16_t samplesB[DEPTH];
+    uint16_t samplesC[DEPTH];
+  };
+
+  static const uint8_t CONTROL_CE = 0x01;
+  static const uint8_t CONTROL_OE = 0x02;
+  static const uint8_t CONTROL_WE = 0x04;
+
+  BusCapture(EEPROMProgrammer &programmer, SharedBuffer &buffer); // At least sizeof(Buffers)
+
+  void begin();
+
+  // Release the bus and sample it; the pins stay inputs afterwards, until
+  // EEPROMProgrammer::claimBus. False if the trigger never came, in which
+  // case the buffer holds the samples just before the timeout.
+  bool capture(const Settings &settings, Result &result);
+
+  // Decode samples of the last capture, oldest first; returns how many
+  // there were, none once another mode has taken the buffer
+  uint16_t readSamples(uint16_t index, Sample *samples, uint16_t count) const;
+
+private:
+  EEPROMProgrammer &programmer;
+
+  SharedBuffer &buffer;
+
+  uint16_t firstSlot; // Of the oldest captured sample
+  uint16_t sampleCount;
+
+  Buffers &buffers() const
+  {
+    return *reinterpret_cast<Buffers *>(buffer.data());
+  }
+
+  uint32_t countWritten(uint32_t total, uint16_t &lastSlot) const;
+  void start(uint32_t periodCycles);
+  void stop();
+};
+
+#endif // BUS_CAPTURE_H
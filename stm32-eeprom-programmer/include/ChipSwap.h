@@ -0,0 +1,60 @@
+#ifndef CHIP_SWAP_H
+#define CHIP_SWAP_H
+
+#include "stm32f1xx_hal.h"
+#include "EEPROMProgrammer.h"
+#include "ProgrammingProtocol.h"
+
+// Burns both chips of a 16-bit program from one word image with one socket:
+// the lower lane goes in first, then the LED blinks until the chip has been
+// swapped and the swap confirmed, with the button on PB3 or any byte on the
+// console, and the upper lane follows. Each chip is written through its
+// manifest and then checked against every page CRC of its lane. CE stays
+// high during the swap, so the chip ignores the bus while it goes in.
+class ChipSwap
+{
+public:
+  static const uint16_t BUTTON_PIN = GPIO_PIN_3; // PB3 to GND, internal pull-up; free since JTAG is off
+  static const uint32_t DEBOUNCE_MS = 20;        // The button must read low this long
+  static const uint32_t BLINK_MS = 250;          // LED toggle period while waiting
+
+  // A 16-bit word image (low byte first, as in the .hack file) and the
+  // build's per-lane values from page-crc.js
+  struct WordImage
+  {
+    ImageSource *words;
+    uint16_t start;
+    uint16_t length; // Words, i.e. bytes per chip
+    const uint32_t *pageCrcs[2];
+    uint32_t imageIds[2];
+  };
+
+  // Prompts go to the console, and a byte from it confirms the swap
+  ChipSwap(EEPROMProgrammer &programmer, ByteStream *console = nullptr);
+
+  void begin();
+
+  // Lower chip, swap, upper chip
+  bool run(const WordImage &image);
+
+  // Write one lane to the chip in the socket and verify it
+  bool burn(const WordImage &image, LaneImage::Lane lane);
+
+  // Blink until a swap is confirmed with a chip that does not hold the lower
+  // lane; a confirmation with the lower chip still in place is ignored,
+  // unless both lanes start with the same page
+  void waitForSwap(const WordImage &image);
+
+  // Whether the first page of the socket matches the lane
+  bool holdsLane(const WordImage &image, LaneImage::Lane lane);
+
+private:
+  EEPROMProgrammer &programmer;
+  ByteStream *console;
+
+  bool confirmed();
+  bool buttonDown();
+  void print(const char *text);
+};
+
+#endif // CHIP_SWAP_H
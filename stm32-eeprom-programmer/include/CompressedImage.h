@@ -0,0 +1,36 @@
+#ifndef COMPRESSED_IMAGE_H
+#define COMPRESSED_IMAGE_H
+
+#include "ImageSource.h"
+
+// LZ77 image produced by toolchain/image-compressor.js (format described
+// there). Decoding needs only the last WINDOW_SIZE output bytes, kept in a
+// ring buffer, so an image of any size streams through a fixed 1 KB of RAM.
+class CompressedImage : public ImageSource
+{
+public:
+  static const uint16_t WINDOW_SIZE = 1024; // Must match image-compressor.js
+  static const uint16_t WINDOW_MASK = WINDOW_SIZE - 1;
+  static const uint8_t MIN_MATCH = 3;
+
+  CompressedImage(const uint8_t *data, uint32_t size);
+
+  void rewind() override;
+  uint16_t read(uint8_t *out, uint16_t length) override;
+
+private:
+  const uint8_t *data;
+  uint32_t size;
+  uint32_t position;
+
+  uint8_t window[WINDOW_SIZE];
+  uint16_t windowHead; // Next slot to fill
+
+  uint8_t flags; // Remaining flag bits of the current group, LSB next
+  uint8_t flagsLeft;
+
+  uint16_t matchDistance; // Match being copied out across read() calls
+  uint8_t matchLeft;
+};
+
+#endif // COMPRESSED_IMAGE_H
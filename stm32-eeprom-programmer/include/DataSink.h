@@ -0,0 +1,55 @@
+#ifndef DATA_SINK_H
+#define DATA_SINK_H
+
+#include <stdint.h>
+#include "ProgrammingProtocol.h"
+
+// Receives chip contents from EEPROMProgrammer::dump, one chunk of up to
+// EEPROMProgrammer::STREAM_CHUNK_SIZE bytes at a time
+class DataSink
+{
+public:
+  virtual ~DataSink() {}
+
+  virtual void write(uint16_t address, const uint8_t *data, uint16_t length) = 0;
+};
+
+// Receives every byte that differs in EEPROMProgrammer::verify, in address order
+class MismatchSink
+{
+public:
+  virtual ~MismatchSink() {}
+
+  virtual void mismatch(uint16_t address, uint8_t expected, uint8_t actual) = 0;
+};
+
+// Raw bytes out of a ByteStream (USART3 on the device)
+class StreamSink : public DataSink
+{
+public:
+  StreamSink(ByteStream &stream);
+
+  void write(uint16_t address, const uint8_t *data, uint16_t length) override;
+
+private:
+  ByteStream &stream;
+};
+
+// Caller-owned buffer; bytes beyond its capacity are dropped and counted
+class BufferSink : public DataSink
+{
+public:
+  BufferSink(uint8_t *buffer, uint16_t capacity);
+
+  void write(uint16_t address, const uint8_t *data, uint16_t length) override;
+  uint16_t size() const;
+  uint16_t overflow() const;
+
+private:
+  uint8_t *buffer;
+  uint16_t capacity;
+  uint16_t used;
+  uint16_t dropped;
+};
+
+#endif // DATA_SINK_H
@@ -3,17 +3,61 @@
 
 #include "stm32f1xx_hal.h"
 
+// Busy-wait delays and elapsed time measurement based on the core clock.
+// Uses the DWT cycle counter when available and falls back to SysTick as a
+// free-running counter otherwise (HAL_Init is not used, so SysTick is ours).
 class DelayUtil
 {
 public:
-  // Basic delay functions
-  static void delay(uint32_t cycles);
+  enum TimeSource
+  {
+    SOURCE_DWT,
+    SOURCE_SYSTICK,
+  };
+
+  // Select the time source and run the self-calibration check: the delay
+  // loop against the cycle counter, and the core clock SystemCoreClock
+  // claims against the RTC clock (LSE, or LSI, which is only good to 2x)
+  static bool begin();
+  static bool isCalibrated();
+  static TimeSource getTimeSource();
+
+  // Basic delay functions (never shorter than requested)
+  static void delayCycles(uint32_t cycles);
+  static void delayNanoseconds(uint32_t nanoseconds); // For waits below 1ms
   static void delayMicroseconds(uint32_t microseconds);
   static void delayMilliseconds(uint32_t milliseconds);
 
+  // Elapsed time measurement. With the SysTick source, cycles() must be
+  // called at least once every 2^24 cycles to keep counting correctly.
+  static uint32_t cycles();
+  static uint32_t nanosecondsToCycles(uint32_t nanoseconds);
+  static uint32_t microsecondsToCycles(uint32_t microseconds);
+  static uint32_t cyclesToMicroseconds(uint32_t cycles);
+  static uint32_t cyclesToNanoseconds(uint32_t cycles);
+
 private:
-  static const uint32_t CYCLES_PER_MICROSECOND = 72; // Assuming 72MHz clock
-  static const uint32_t CYCLES_PER_MILLISECOND = 72000;
+  static const uint32_t CALIBRATION_US = 1000;
+  static const uint32_t CALIBRATION_TOLERANCE_PERCENT = 1;
+  static const uint32_t REFERENCE_TICKS = 256; // RTC clocks timed, about 6 ms on LSI
+  static const uint32_t REFERENCE_TIMEOUT_US = 50000;
+  static const uint32_t REFERENCE_LSE_HZ = 32768;
+  static const uint32_t REFERENCE_LSI_MIN_HZ = 30000;
+  static const uint32_t REFERENCE_LSI_MAX_HZ = 60000;
+  static const uint32_t REFERENCE_CRYSTAL_TOLERANCE_PERCENT = 2; // Crystal, plus one tick of 256 read late
+
+  static TimeSource source;
+  static bool calibrated;
+  static uint32_t cyclesPerMicrosecond;
+  static uint32_t overheadCycles; // Cost of a zero-length delayCycles() call
+
+  // SysTick fallback state
+  static uint32_t lastSysTick;
+  static uint32_t sysTickCycles;
+
+  static uint32_t sysTickValue();
+  static bool checkCalibration();
+  static bool checkCoreClock();
 };
 
 #endif // DELAY_UTIL_H
\ No newline at end of file
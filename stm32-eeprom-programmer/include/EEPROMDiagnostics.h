@@ -0,0 +1,30 @@
+#ifndef EEPROM_DIAGNOSTICS_H
+#define EEPROM_DIAGNOSTICS_H
+
+#include "BusCapture.h"
+#include "EEPROMProgrammer.h"
+#include "ProgrammingProtocol.h"
+
+// Diagnostics for the resident firmware: reports EEPROMProgrammer's
+// instrumentation, benchmarks writing, verifying and dumping a scratch
+// region (its contents are lost), characterizes the chip's timing, and
+// captures another board's bus when given a BusCapture
+class EEPROMDiagnostics : public Diagnostics
+{
+public:
+  EEPROMDiagnostics(EEPROMProgrammer &programmer, BusCapture *busCapture = nullptr);
+
+  void readStats(ProgrammingProtocol::DeviceStats &stats, bool reset) override;
+  void runBenchmark(uint16_t address, uint16_t length, ProgrammingProtocol::BenchmarkResult &result) override;
+  void characterize(uint16_t address, ProgrammingProtocol::TimingReport &report) override;
+  bool capture(const ProgrammingProtocol::CaptureRequest &request, ProgrammingProtocol::CaptureInfo &info) override;
+  uint8_t readCapture(uint16_t index, ProgrammingProtocol::CaptureSample *samples, uint8_t count) override;
+  void endCapture() override;
+
+private:
+  EEPROMProgrammer &programmer;
+  BusCapture *busCapture;
+  uint32_t benchmarkRuns; // Seeds the pattern, so each run really changes the chip
+};
+
+#endif // EEPROM_DIAGNOSTICS_H
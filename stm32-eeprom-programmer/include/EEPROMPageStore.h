@@ -0,0 +1,27 @@
+#ifndef EEPROM_PAGE_STORE_H
+#define EEPROM_PAGE_STORE_H
+
+#include "EEPROMProgrammer.h"
+#include "ProgrammingProtocol.h"
+
+// PageStore backed by the 28C256 on the programmer. Pages are written
+// differentially: only bytes that differ from the chip are programmed. The
+// first write of a session invalidates the chip's image manifest; a client
+// updating through it rewrites the header last.
+class EEPROMPageStore : public PageStore
+{
+public:
+  EEPROMPageStore(EEPROMProgrammer &programmer);
+
+  void beginSession() override;
+  WriteResult writePage(uint16_t address, const uint8_t *data, uint16_t length, bool sdpProtected) override;
+  void readBlock(uint16_t address, uint8_t *data, uint16_t length) override;
+  bool erase() override;
+  bool isBlank(uint16_t address, uint16_t length, uint16_t &firstUsed) override;
+
+private:
+  EEPROMProgrammer &programmer;
+  bool manifestChecked;
+};
+
+#endif // EEPROM_PAGE_STORE_H
@@ -2,13 +2,20 @@
 #define EEPROM_PROGRAMMER_H
 
 #include "stm32f1xx_hal.h"
+#include "PinMap.h"
+#include "ImageSource.h"
+#include "DataSink.h"
+#include "Instrumentation.h"
+#include "ImageManifest.h"
+
+class ProgressJournal;
 
 class EEPROMProgrammer
 {
 public:
   // Pin definitions for STM32 Blue Pill
   // Address pins A0-A14 (using GPIOA and GPIOB pins)
-  // Note: Avoided JTAG pins (PB3, PB4) to preserve debugging functionality
+  // Note: JTAG is disabled at begin() to free PB3/PB4/PA15; SWD (PA13/PA14) still works
   static const uint16_t ADDRESS_PIN_A0 = GPIO_PIN_0;  // PA0
   static const uint16_t ADDRESS_PIN_A1 = GPIO_PIN_1;  // PA1
   static const uint16_t ADDRESS_PIN_A2 = GPIO_PIN_2;  // PA2
@@ -29,22 +36,165 @@ public:
   static const uint16_t DATA_PIN_D0 = GPIO_PIN_0;  // PB0
   static const uint16_t DATA_PIN_D1 = GPIO_PIN_1;  // PB1
   static const uint16_t DATA_PIN_D2 = GPIO_PIN_15; // PC15 (was PB10)
-  static const uint16_t DATA_PIN_D3 = GPIO_PIN_11; // PB11
+  static const uint16_t DATA_PIN_D3 = GPIO_PIN_4;  // PB4 (was PB11, now USART3 RX)
   static const uint16_t DATA_PIN_D4 = GPIO_PIN_12; // PB12
   static const uint16_t DATA_PIN_D5 = GPIO_PIN_13; // PB13
   static const uint16_t DATA_PIN_D6 = GPIO_PIN_14; // PB14
   static const uint16_t DATA_PIN_D7 = GPIO_PIN_15; // PB15
 
+  // Bus layout (bit order and port of every line). The scatter/gather tables
+  // used by setAddress/writeData/readData are generated from these at compile time.
+  static constexpr PinDef ADDRESS_PINS[15] = {
+      {PIN_PORT_A, ADDRESS_PIN_A0},
+      {PIN_PORT_A, ADDRESS_PIN_A1},
+      {PIN_PORT_A, ADDRESS_PIN_A2},
+      {PIN_PORT_A, ADDRESS_PIN_A3},
+      {PIN_PORT_A, ADDRESS_PIN_A4},
+      {PIN_PORT_A, ADDRESS_PIN_A5},
+      {PIN_PORT_A, ADDRESS_PIN_A6},
+      {PIN_PORT_A, ADDRESS_PIN_A7},
+      {PIN_PORT_A, ADDRESS_PIN_A8},
+      {PIN_PORT_A, ADDRESS_PIN_A9},
+      {PIN_PORT_B, ADDRESS_PIN_A10},
+      {PIN_PORT_B, ADDRESS_PIN_A11},
+      {PIN_PORT_B, ADDRESS_PIN_A12},
+      {PIN_PORT_B, ADDRESS_PIN_A13},
+      {PIN_PORT_B, ADDRESS_PIN_A14},
+  };
+
+  static constexpr PinDef DATA_PINS[8] = {
+      {PIN_PORT_B, DATA_PIN_D0},
+      {PIN_PORT_B, DATA_PIN_D1},
+      {PIN_PORT_C, DATA_PIN_D2},
+      {PIN_PORT_B, DATA_PIN_D3},
+      {PIN_PORT_B, DATA_PIN_D4},
+      {PIN_PORT_B, DATA_PIN_D5},
+      {PIN_PORT_B, DATA_PIN_D6},
+      {PIN_PORT_B, DATA_PIN_D7},
+  };
+
   // Control pins
   static const uint16_t EEPROM_WE_PIN = GPIO_PIN_5;   // PA5 - Write Enable (active low)
   static const uint16_t EEPROM_OE_PIN = GPIO_PIN_6;   // PA6 - Output Enable (active low)
   static const uint16_t EEPROM_CE_PIN = GPIO_PIN_7;   // PA7 - Chip Enable (active low)
   static const uint16_t STATUS_LED_PIN = GPIO_PIN_13; // PC13 - Built-in LED
 
+  // Dual mode: a second chip shares every line but CE
+  static const uint16_t EEPROM_CE_UPPER_PIN = GPIO_PIN_15; // PA15 - Chip Enable of the upper chip (active low)
+
+  // Chip selected by CE; every operation acts on the selected chip
+  enum Chip
+  {
+    CHIP_LOWER, // Bits 0-7 of each instruction, the only chip in single mode
+    CHIP_UPPER, // Bits 8-15
+  };
+
   // EEPROM specifications
   static const uint16_t EEPROM_SIZE = 32768;       // 32KB = 32768 bytes
   static const int ADDRESS_BITS = 15;              // 15 address lines (A0-A14)
   static const int PROGRAMMABLE_ADDRESS_BITS = 15; // All 15 address bits are programmable
+  static const uint16_t PAGE_SIZE = 64;            // Bytes per page write cycle (A6-A14 select the page)
+  static const uint16_t PAGE_MASK = PAGE_SIZE - 1;
+
+  // Software data protection command sequence (28C256)
+  static const uint16_t SDP_ADDRESS_1 = 0x5555;
+  static const uint16_t SDP_ADDRESS_2 = 0x2AAA;
+  static const uint8_t SDP_UNLOCK_1 = 0xAA;
+  static const uint8_t SDP_UNLOCK_2 = 0x55;
+  static const uint8_t SDP_PROTECTED_WRITE = 0xA0; // Unlocks a page write and leaves SDP enabled
+  static const uint8_t SDP_DISABLE_1 = 0x80;
+  static const uint8_t SDP_DISABLE_2 = 0x20;
+  static const uint8_t SDP_CHIP_ERASE = 0x10; // AA/55/80/AA/55/10 clears the whole chip
+
+  // Write strategies for writeDataBlock
+  enum WriteMode
+  {
+    WRITE_MODE_BYTE,           // One byte per write cycle (slow fallback)
+    WRITE_MODE_PAGE,           // Up to 64 bytes per write cycle, chip must not be SDP-protected
+    WRITE_MODE_PAGE_PROTECTED, // Each page is preceded by the SDP unlock sequence
+  };
+
+  // How the end of the internal write cycle is detected
+  enum CompletionMethod
+  {
+    COMPLETION_DATA_POLLING, // I/O7 reads back inverted until the cycle ends
+    COMPLETION_TOGGLE_BIT,   // I/O6 flips on every read while the cycle runs
+  };
+
+  static const uint32_t WRITE_CYCLE_TIMEOUT_US = 20000; // tWC is 10ms max
+  static const uint32_t CHIP_ERASE_TIMEOUT_US = 50000;  // tEC is 20ms max
+  static const uint8_t PAGE_WRITE_RETRIES = 1;          // Reloads of a page whose write cycle failed
+  static const uint16_t STREAM_CHUNK_SIZE = PAGE_SIZE;  // Stack buffer used by dump and verify
+
+  // Result of verifyPageCrcs. Mismatching bytes are merged into runs of
+  // (start address, length); only the first MAX_MISMATCH_RANGES are kept.
+  static const uint8_t MAX_MISMATCH_RANGES = 16;
+
+  struct MismatchRange
+  {
+    uint16_t start;
+    uint16_t length;
+  };
+
+  struct VerifyResult
+  {
+    uint16_t pagesChecked;
+    uint16_t pagesFailed;
+    uint8_t rangeCount;
+    bool truncated; // More ranges than fit in the buffer
+    MismatchRange ranges[MAX_MISMATCH_RANGES];
+  };
+
+  // Outcome of the last writeImageDifferential or writeImageManifest
+  struct DiffStats
+  {
+    uint16_t pagesWritten;
+    uint16_t pagesSkipped; // Already held the new data, no write cycle
+    uint16_t bytesWritten;
+    uint16_t bytesSkipped;
+    uint16_t pagesRead; // Image pages read from the chip to compare them
+  };
+
+  // Current data bus direction, tracked so turnarounds only happen on change
+  enum BusDirection
+  {
+    BUS_UNKNOWN,
+    BUS_INPUT,
+    BUS_OUTPUT,
+  };
+
+  // 28C256 timing parameters (datasheet worst case for the -15 grade)
+  static const uint32_t T_AS_NS = 10;   // Address setup to WE low (0ns min, padded for wiring)
+  static const uint32_t T_AH_NS = 50;   // Address hold after WE low
+  static const uint32_t T_DS_NS = 50;   // Data setup to WE high
+  static const uint32_t T_WP_NS = 100;  // WE pulse width
+  static const uint32_t T_ACC_NS = 150; // Address to output valid
+  static const uint32_t T_OE_NS = 70;   // OE low to output valid
+  static const uint32_t T_DF_NS = 50;   // OE high to output float
+
+  // Settling time for the first access after the bus has been idle
+  static const uint32_t FIRST_READ_SETTLE_US = 1000;
+  static const uint32_t FIRST_WRITE_SETTLE_US = 2000;
+  static const uint32_t BLINK_MS = 100;
+
+  // Waits the bus operations use, in core clock cycles on top of the
+  // register accesses themselves. begin() loads the datasheet values above;
+  // characterizeTiming() replaces them with what one chip actually needs.
+  struct TimingProfile
+  {
+    uint32_t accessCycles;       // Address to data, readAddress
+    uint32_t outputEnableCycles; // OE low to data, status reads
+    uint32_t firstReadCycles;    // First read of a session
+    uint32_t firstWriteCycles;   // CE low to the first WE pulse of a session
+    uint32_t writeCycleMicros;   // Longest write cycle measured, 0 if unknown
+    uint32_t writeTimeoutMicros; // Completion polling gives up after this, never below the datasheet tWC
+    bool characterized;
+  };
+
+  // Measured delays get this much on top (a chip that needs no added wait
+  // keeps none)
+  static const uint32_t TIMING_MARGIN_PERCENT = 50;
+  static const uint8_t CHARACTERIZE_PASSES = 4; // Reads of the test page per probed delay
 
   // Constructor
   EEPROMProgrammer();
@@ -52,47 +202,173 @@ public:
   // Initialization
   void begin();
 
+  // Make every bus and control pin a floating input, e.g. to watch another
+  // board drive the bus, and drive them again (all chips deselected)
+  void releaseBus();
+  void claimBus();
+
   // Data bus direction control
   void setDataBusInput();
   void setDataBusOutput();
 
+  // Read session for bulk reads - CE/OE stay asserted and only the address steps
+  void beginRead();
+  uint8_t readAddress(uint16_t address, bool shouldDelay = false);
+  void endRead();
+
   // Address and data handling
   void setAddress(uint16_t address);
   uint8_t readData();
   void writeData(uint8_t data);
 
   // Write completion detection
-  bool waitForWriteComplete(uint8_t expectedData);
+  bool waitForWriteComplete(uint8_t expectedData, CompletionMethod method = COMPLETION_DATA_POLLING,
+                            uint32_t timeoutUs = 0); // 0: the profile's write timeout
+  uint32_t getLastWriteCycleMicros() const; // Duration of the most recent write cycle
 
   // Software data protection
   void disableSoftwareDataProtection();
 
+  // Software chip erase: every byte becomes 0xFF in one erase cycle
+  bool eraseChip();
+
+  // Bulk read that stops at the first byte other than 0xFF. If the range is
+  // not blank, that byte's address goes to *firstUsed.
+  bool isBlank(uint16_t startAddress, uint16_t length, uint16_t *firstUsed = nullptr);
+
   // Basic operations
   uint8_t readByte(uint16_t address, bool shouldDelay = false);
-  bool writeByte(uint16_t address, uint8_t data, bool shouldDelay = false);
+  bool writeByte(uint16_t address, uint8_t data, bool shouldDelay = false,
+                 CompletionMethod method = COMPLETION_DATA_POLLING);
+
+  // Page write - all bytes must lie within one 64-byte page
+  bool writePage(uint16_t address, const uint8_t *data, uint16_t length, bool sdpProtected = false,
+                 bool shouldDelay = false, CompletionMethod method = COMPLETION_DATA_POLLING);
+
+  // Differential page write: reads the page and loads only the bytes that
+  // differ (none: no write cycle at all). The count is returned in *changed.
+  bool updatePage(uint16_t address, const uint8_t *data, uint16_t length, uint16_t *changed, bool sdpProtected = false,
+                  bool shouldDelay = false, CompletionMethod method = COMPLETION_DATA_POLLING);
 
   // Bulk operations
-  bool writeDataBlock(uint16_t startAddress, const uint8_t *data, uint16_t length);
+  bool writeDataBlock(uint16_t startAddress, const uint8_t *data, uint16_t length, WriteMode mode = WRITE_MODE_PAGE,
+                      CompletionMethod method = COMPLETION_DATA_POLLING, ProgressJournal *journal = nullptr);
   bool verifyData(uint16_t startAddress, const uint8_t *data, uint16_t length);
-  uint16_t *findMismatchedIndices(uint16_t startAddress, const uint8_t *data, uint16_t length);
+
+  // Select the chip that CE drives (CHIP_LOWER after begin)
+  void selectChip(Chip chip);
+  Chip getSelectedChip() const;
+
+  // Dual mode: write both halves of a 16-bit image in one pass, then verify
+  // both. Each chip is loaded with its page while the other one runs its
+  // write cycle, so a pair of pages takes about one tWC.
+  bool writeImagePair(uint16_t startAddress, ImageSource &lower, ImageSource &upper, uint16_t length,
+                      bool sdpProtected = false, CompletionMethod method = COMPLETION_DATA_POLLING);
+
+  // Stream an image (plain or compressed) through a one-page buffer, then
+  // verify it. With a journal, each confirmed page is recorded in flash; a
+  // run of the same image after a reset skips the recorded pages, except
+  // the last one, which is verified and rewritten if it does not match.
+  bool writeImage(uint16_t startAddress, ImageSource &source, uint16_t length, WriteMode mode = WRITE_MODE_PAGE,
+                  CompletionMethod method = COMPLETION_DATA_POLLING, ProgressJournal *journal = nullptr);
+  bool verifyImage(uint16_t startAddress, ImageSource &source, uint16_t length);
+  uint32_t getLastSourceCyclesPerPage() const; // Average cost of fetching one page in the last writeImage
+  uint16_t getLastResumedPages() const;        // Pages the last writeImage found done in its journal
+
+  // As writeImage, but only pages and bytes that differ from the chip are programmed
+  bool writeImageDifferential(uint16_t startAddress, ImageSource &source, uint16_t length,
+                              WriteMode mode = WRITE_MODE_PAGE, CompletionMethod method = COMPLETION_DATA_POLLING);
+  const DiffStats &getLastDiffStats() const;
+
+  // Incremental update through the manifest in the chip's tail (see
+  // ImageManifest.h): the stored page hashes are compared with pageCrcs
+  // (page-crc.js), only pages that differ are read, written and verified,
+  // and the manifest is rewritten for the new image. Nothing but the header
+  // is read if imageId matches. Without a valid manifest every page is
+  // written differentially; an image that cannot carry one (unaligned,
+  // reaching the table, byte mode) goes through writeImageDifferential.
+  bool writeImageManifest(uint16_t startAddress, ImageSource &source, uint16_t length, const uint32_t *pageCrcs,
+                          uint32_t imageId, WriteMode mode = WRITE_MODE_PAGE,
+                          CompletionMethod method = COMPLETION_DATA_POLLING);
+
+  // Make a manifest on the selected chip stale. Every image writer does this
+  // first; call it before changing the chip with the single-page functions.
+  bool invalidateManifest(bool sdpProtected = false);
+
+  // One read pass through the CRC unit, compared with per-page CRCs from the
+  // build (toolchain/page-crc.js). Only failing pages are read again and
+  // compared with the image to find the mismatching ranges.
+  bool verifyPageCrcs(uint16_t startAddress, uint16_t length, const uint32_t *pageCrcs, ImageSource &source,
+                      VerifyResult *result);
+
+  // Streaming access without heap use. dump hands the chip's contents to the
+  // sink a chunk at a time. verify compares in one pass and reports every
+  // differing byte to mismatches; without a sink it stops at the first one.
+  void dump(uint16_t startAddress, uint16_t length, DataSink &sink);
+  bool verify(uint16_t startAddress, ImageSource &source, uint16_t length, MismatchSink *mismatches = nullptr);
+
+  // Sweep the read delays and the write settle against a test pattern on
+  // one scratch page (its contents are put back), and run all later bus
+  // operations with the measured values plus margin. False if the chip
+  // failed even at the datasheet timings; the profile is then unchanged.
+  bool characterizeTiming(uint16_t scratchAddress);
+  const TimingProfile &getTimingProfile() const;
+  void setTimingProfile(const TimingProfile &profile); // E.g. one measured earlier
+  void resetTimingProfile();                           // Back to the datasheet values
+
+  // Per-phase cycle counts, write cycle histogram, retries and timeouts
+  const Instrumentation &getInstrumentation() const;
+  void resetInstrumentation();
 
   // Utility functions
-  uint8_t *dumpMemory(uint16_t startAddress, uint16_t length);
   void blinkLED(int times = 1);
 
-  // GPIO port pointers
-  GPIO_TypeDef *addressPortA;
-  GPIO_TypeDef *addressPortB;
-  GPIO_TypeDef *dataPort;
-  GPIO_TypeDef *dataPortC; // For D2 which is now on PC15
+  // GPIO port pointers (address and data ports come from ADDRESS_PINS/DATA_PINS)
   GPIO_TypeDef *controlPort;
   GPIO_TypeDef *ledPort;
 
-  // Data bus pin array for easy iteration
-  uint16_t dataPins[8];
+  BusDirection busDirection;
+  Chip selectedChip;
+  uint16_t chipEnablePin;
+
+  // Write cycle timing
+  uint32_t lastWriteCycleMicros;
+  uint32_t lastSourceCyclesPerPage;
+  uint16_t lastResumedPages;
+  DiffStats lastDiffStats;
+  TimingProfile timingProfile;
+  Instrumentation instrumentation;
+  bool timingCalibrated;
 
   // Helper functions
   void configureGPIO();
+  void loadByte(uint16_t address, uint8_t data);
+  void loadCommand(uint8_t command);
+  void addMismatch(VerifyResult *result, uint16_t address);
+  void readRange(uint16_t address, uint8_t *data, uint16_t length, bool shouldDelay);
+  bool writeVerified(uint16_t address, const uint8_t *data, uint16_t length, uint16_t *changed, bool sdpProtected,
+                     bool shouldDelay, CompletionMethod method);
+  bool programPage(uint16_t address, const uint8_t *data, const uint8_t *current, uint16_t length, bool sdpProtected,
+                   bool shouldDelay, CompletionMethod method);
+  bool isCommitted(ProgressJournal *journal, uint16_t index, uint16_t address, const uint8_t *data, uint16_t length);
+  uint16_t loadPage(uint16_t address, const uint8_t *data, const uint8_t *current, uint16_t length,
+                    bool sdpProtected);
+  bool completePage(uint16_t address, const uint8_t *data, uint16_t length, uint16_t last, bool sdpProtected,
+                    CompletionMethod method);
+  uint8_t readStatus();
+
+  // Timing characterization: one probe tries a delay on the test page
+  enum TimingProbe
+  {
+    PROBE_ACCESS,
+    PROBE_OUTPUT_ENABLE,
+    PROBE_FIRST_READ,
+    PROBE_FIRST_WRITE, // Writes the complement of pattern, then reads it back
+  };
+
+  bool probeTiming(TimingProbe probe, uint32_t delayCycles, uint16_t address, uint8_t *pattern);
+  bool findMinimumDelay(TimingProbe probe, uint32_t maxCycles, uint16_t address, uint8_t *pattern, uint32_t *found);
+
   void setPinHigh(GPIO_TypeDef *port, uint16_t pin);
   void setPinLow(GPIO_TypeDef *port, uint16_t pin);
   uint8_t readPin(GPIO_TypeDef *port, uint16_t pin);
@@ -0,0 +1,27 @@
+#ifndef HARDWARE_CRC_H
+#define HARDWARE_CRC_H
+
+#include "stm32f1xx_hal.h"
+
+// The STM32F1 CRC unit: CRC-32/MPEG-2 (polynomial 0x04C11DB7, initial value
+// 0xFFFFFFFF, no reflection, no final XOR) over 32-bit words. The F1 unit
+// only takes whole words, so bytes are packed little-endian and a partial
+// last word is padded with 0xFF. toolchain/page-crc.js computes the same
+// values at build time.
+class HardwareCRC
+{
+public:
+  static void begin();
+  static void reset();
+  static void feed(uint32_t word);
+  static uint32_t value();
+
+  // CRC of a byte buffer using the packing above
+  static uint32_t compute(const uint8_t *data, uint16_t length);
+
+  // Continue the running CRC with more bytes, packed as above. Every buffer
+  // but the last must be a whole number of words.
+  static uint32_t update(const uint8_t *data, uint16_t length);
+};
+
+#endif // HARDWARE_CRC_H
@@ -0,0 +1,57 @@
+#ifndef IMAGE_MANIFEST_H
+#define IMAGE_MANIFEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Manifest kept in the tail of each EEPROM, so an update can tell which
+// pages changed without reading the chip. Shared by the firmware and the
+// host tools, so it must not depend on the HAL.
+//
+// Layout:
+//   0x0000-0x77FF  image area; a manifest only describes images inside it
+//   0x7800-0x7F7F  hash table, one CRC (LE32) per 64-byte page of the image
+//                  area, at entryAddress(page address)
+//   0x7FC0         header, see Header; the rest of its page stays 0xFF
+//
+// The hash is the per-page CRC-32/MPEG-2 that HardwareCRC and
+// toolchain/page-crc.js already compute; the image id is the same CRC over
+// the whole image. The header is invalidated before any page changes and
+// written last, so an interrupted update leaves no manifest at all.
+namespace ImageManifest
+{
+  static const uint16_t PAGE_SIZE = 64;
+  static const uint16_t TABLE_ADDRESS = 0x7800;
+  static const uint16_t HEADER_ADDRESS = 0x7FC0;
+  static const uint16_t IMAGE_LIMIT = TABLE_ADDRESS; // Images must end at or below this
+  static const uint16_t ENTRY_SIZE = 4;
+  static const uint16_t HEADER_SIZE = 24;
+  static const uint32_t MAGIC = 0x31464D45; // "EMF1"
+  static const uint8_t INVALID_MAGIC = 0x00; // Written over the first magic byte
+
+  struct Header
+  {
+    uint32_t imageId; // CRC of the whole image
+    uint16_t start;   // Page aligned
+    uint16_t length;
+    uint32_t tableCrc; // CRC of the image's table entries, as stored
+  };
+
+  // True if the image can carry a manifest: page aligned and below the table
+  bool fits(uint16_t start, uint16_t length);
+  uint16_t pageCount(uint16_t start, uint16_t length);
+  uint16_t entryAddress(uint16_t pageAddress);
+
+  // Header bytes: magic, imageId, start, length, tableCrc (LE) and a CRC of
+  // those 20 bytes
+  void encodeHeader(const Header &header, uint8_t *out);
+  bool decodeHeader(const uint8_t *in, Header &header);
+
+  // CRC-32/MPEG-2 in software, packed as HardwareCRC::compute does. update
+  // continues a running value; every buffer but the last must be a whole
+  // number of words.
+  uint32_t crc32(const uint8_t *data, size_t length);
+  uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length);
+}
+
+#endif // IMAGE_MANIFEST_H
@@ -0,0 +1,61 @@
+#ifndef IMAGE_SOURCE_H
+#define IMAGE_SOURCE_H
+
+#include <stdint.h>
+
+// Sequential reader over a program image, consumed by
+// EEPROMProgrammer::writeImage/verifyImage one page at a time
+class ImageSource
+{
+public:
+  virtual ~ImageSource() {}
+
+  // Restart from the first byte
+  virtual void rewind() = 0;
+
+  // Copy up to length bytes into out; returns the number copied, which is
+  // short only at the end of the image or on corrupt data
+  virtual uint16_t read(uint8_t *out, uint16_t length) = 0;
+};
+
+// Uncompressed image held in an array
+class ArrayImage : public ImageSource
+{
+public:
+  ArrayImage(const uint8_t *data, uint16_t size);
+
+  void rewind() override;
+  uint16_t read(uint8_t *out, uint16_t length) override;
+
+private:
+  const uint8_t *data;
+  uint16_t size;
+  uint16_t position;
+};
+
+// One byte lane of a 16-bit word image, the same data as the .hack file
+// with the low byte of each word first. The words come from another source
+// (e.g. a CompressedImage) a chunk at a time, and every other byte is kept,
+// so both chips are written from one image.
+class LaneImage : public ImageSource
+{
+public:
+  enum Lane
+  {
+    LANE_LOW,  // Bits 0-7, the lower chip
+    LANE_HIGH, // Bits 8-15, the upper chip
+  };
+
+  static const uint16_t CHUNK_WORDS = 32;
+
+  LaneImage(ImageSource &words, Lane lane);
+
+  void rewind() override;
+  uint16_t read(uint8_t *out, uint16_t length) override;
+
+private:
+  ImageSource &words;
+  Lane lane;
+};
+
+#endif // IMAGE_SOURCE_H
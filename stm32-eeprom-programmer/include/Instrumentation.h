@@ -0,0 +1,53 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <stdint.h>
+
+// Where programming time goes. EEPROMProgrammer adds the core clock cycles
+// (DelayUtil::cycles) spent in each phase of a write, and sorts every write
+// cycle into a histogram of completion times. Reads are not instrumented,
+// so the read loops stay as tight as before.
+class Instrumentation
+{
+public:
+  enum Phase
+  {
+    PHASE_ADDRESS_SETUP,   // Address and data onto the bus, through tAS
+    PHASE_BUS_TURNAROUND,  // Data pins switched between input and output
+    PHASE_WRITE_PULSE,     // WE low through tWP
+    PHASE_COMPLETION_POLL, // DATA# or toggle-bit polling until the write cycle ends
+    PHASE_COUNT,
+  };
+
+  // Write cycle times: below 125us, then doubling buckets, the last open-ended
+  static const uint8_t HISTOGRAM_BUCKETS = 10;
+  static const uint32_t HISTOGRAM_BASE_US = 125;
+
+  Instrumentation();
+
+  void reset();
+
+  void addPhase(Phase phase, uint32_t cycles);
+  void recordWriteCycle(uint32_t microseconds, bool timedOut);
+  void recordRetry();
+
+  uint64_t getPhaseCycles(Phase phase) const;
+  uint32_t getPhaseCount(Phase phase) const;
+  uint32_t getHistogram(uint8_t bucket) const;
+  uint32_t getWriteCycles() const;
+  uint32_t getRetries() const;
+  uint32_t getTimeouts() const;
+
+  static const char *phaseName(Phase phase);
+  static uint32_t bucketLimitMicros(uint8_t bucket); // Upper bound, 0 for the last bucket
+
+private:
+  uint64_t phaseCycles[PHASE_COUNT];
+  uint32_t phaseCount[PHASE_COUNT];
+  uint32_t histogram[HISTOGRAM_BUCKETS];
+  uint32_t writeCycles;
+  uint32_t retries;
+  uint32_t timeouts;
+};
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,98 @@
+#ifndef PIN_MAP_H
+#define PIN_MAP_H
+
+#include <stdint.h>
+
+// GPIO ports a bus pin can live on
+enum PinPort : uint8_t
+{
+  PIN_PORT_A,
+  PIN_PORT_B,
+  PIN_PORT_C,
+};
+
+// One bus line: the port it is wired to and its GPIO_PIN_x mask
+struct PinDef
+{
+  uint8_t port;
+  uint16_t pin;
+};
+
+// Compile-time scatter/gather tables for buses whose bits are spread across
+// several GPIO ports. The tables are built from the PinDef arrays, so moving a
+// pin only needs the array entry to change.
+namespace PinMap
+{
+  // For each value of an 8-bit slice of the bus, the pins to set on one port
+  struct ScatterTable
+  {
+    uint16_t set[256];
+  };
+
+  // For each value of one byte of a port's IDR, the bus bits it carries
+  template <typename T>
+  struct GatherTable
+  {
+    T bits[256];
+  };
+
+  // All pins of the bus that sit on the given port
+  template <int N>
+  constexpr uint16_t portMask(const PinDef (&pins)[N], uint8_t port)
+  {
+    uint16_t mask = 0;
+    for (int i = 0; i < N; i++)
+    {
+      if (pins[i].port == port)
+      {
+        mask |= pins[i].pin;
+      }
+    }
+    return mask;
+  }
+
+  // Scatter bus bits [firstBit, firstBit + 8) onto the pins of one port
+  template <int N>
+  constexpr ScatterTable scatter(const PinDef (&pins)[N], uint8_t port, int firstBit)
+  {
+    ScatterTable table = {};
+    for (int value = 0; value < 256; value++)
+    {
+      for (int bit = 0; bit < 8 && firstBit + bit < N; bit++)
+      {
+        if (((value >> bit) & 1) && pins[firstBit + bit].port == port)
+        {
+          table.set[value] |= pins[firstBit + bit].pin;
+        }
+      }
+    }
+    return table;
+  }
+
+  // Gather bus bits from the low (IDR bits 0-7) or high (IDR bits 8-15) byte of one port
+  template <typename T, int N>
+  constexpr GatherTable<T> gather(const PinDef (&pins)[N], uint8_t port, bool highByte)
+  {
+    GatherTable<T> table = {};
+    for (int value = 0; value < 256; value++)
+    {
+      uint16_t idr = highByte ? (uint16_t)(value << 8) : (uint16_t)value;
+      for (int bit = 0; bit < N; bit++)
+      {
+        if (pins[bit].port == port && (pins[bit].pin & idr))
+        {
+          table.bits[value] |= (T)(1u << bit);
+        }
+      }
+    }
+    return table;
+  }
+
+  // BSRR word that sets `set` and resets the rest of `mask` in one store
+  constexpr uint32_t bsrr(uint16_t set, uint16_t mask)
+  {
+    return set | ((uint32_t)(uint16_t)(mask & ~set) << 16);
+  }
+}
+
+#endif // PIN_MAP_H
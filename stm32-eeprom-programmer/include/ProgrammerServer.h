@@ -0,0 +1,80 @@
+#ifndef PROGRAMMER_SERVER_H
+#define PROGRAMMER_SERVER_H
+
+#include "ProgrammingProtocol.h"
+
+// Device side of the streaming protocol. Write frames are acknowledged as
+// soon as they are copied into one of two page slots, so the host can send
+// the next page while the current one is in its write cycle. The transport
+// keeps receiving in the background (DMA on the STM32) during the write.
+// STATS and BENCHMARK frames are answered when a Diagnostics is attached.
+// A capture leaves the pins as inputs, so the programmer does not fight the
+// bus it was watching; they are driven again by the next frame that needs
+// the chip. ROM emulation, with an Emulator attached, releases them the
+// same way once it stops serving.
+class ProgrammerServer
+{
+public:
+  static const uint8_t SLOT_COUNT = ProgrammingProtocol::WINDOW;
+
+  ProgrammerServer(ByteStream &stream, PageStore &store, Diagnostics *diagnostics = nullptr,
+                   Emulator *emulator = nullptr);
+
+  // Handle received frames and run at most one pending page write
+  void poll();
+
+  // Write any pages still waiting in the slots
+  void flush();
+
+private:
+  // Who has the bus pins when they are not driven for the chip
+  enum BusOwner
+  {
+    BUS_CHIP,
+    BUS_CAPTURE,
+    BUS_EMULATION,
+  };
+
+  struct PageSlot
+  {
+    uint16_t address;
+    uint8_t length;
+    uint8_t data[ProgrammingProtocol::PAGE_SIZE];
+  };
+
+  ByteStream &stream;
+  PageStore &store;
+  Diagnostics *diagnostics;
+  Emulator *emulator;
+  FrameParser parser;
+
+  PageSlot slots[SLOT_COUNT];
+  uint8_t slotHead;  // Oldest filled slot
+  uint8_t slotCount; // Filled slots
+
+  bool sdpProtected;
+  uint8_t status; // Sticky until the next HELLO
+  uint16_t failedAddress;
+  uint16_t pagesWritten;
+  uint16_t pagesFailed;
+  uint16_t pagesUnchanged;
+  BusOwner busOwner;
+
+  void handleFrame(const Frame &frame);
+  void handleWrite(const Frame &frame);
+  void handleRead(const Frame &frame);
+  void handleStats(const Frame &frame);
+  void handleBenchmark(const Frame &frame);
+  void handleBlankCheck(const Frame &frame);
+  void handleCharacterize(const Frame &frame);
+  void handleCapture(const Frame &frame);
+  void handleCaptureRead(const Frame &frame);
+  void handleEmulate(const Frame &frame);
+  void handleEmulateLoad(const Frame &frame);
+  void claimBus(uint8_t frameType);
+  void writeNextSlot();
+  void sendAck(uint8_t seq, uint8_t ackStatus);
+  void send(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length);
+};
+
+#endif // PROGRAMMER_SERVER_H
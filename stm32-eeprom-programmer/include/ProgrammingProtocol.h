@@ -0,0 +1,336 @@
+#ifndef PROGRAMMING_PROTOCOL_H
+#define PROGRAMMING_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Framed serial protocol between the host client and the resident programmer
+// firmware. Shared by the STM32 build and the host tools, so it must not
+// depend on the HAL.
+//
+// Frame layout:
+//   SYNC | type | seq | length | payload[length] | crc16 (low, high)
+// The CRC (CRC-16/CCITT-FALSE) covers type, seq, length and payload.
+namespace ProgrammingProtocol
+{
+  static const uint8_t VERSION = 2; // Bumped on every incompatible payload change
+  static const uint8_t SYNC = 0xA5;
+  static const uint8_t MAX_PAYLOAD = 80;
+  static const uint8_t FRAME_OVERHEAD = 6;
+  static const uint16_t PAGE_SIZE = 64;
+  static const uint32_t CHIP_SIZE = 32768;
+  static const uint8_t WINDOW = 2; // Write frames in flight, matches the device's page slots
+
+  // Host -> device
+  static const uint8_t FRAME_HELLO = 0x01;        // payload: flags, VERSION
+  static const uint8_t FRAME_WRITE = 0x02;        // payload: address (LE16), data (1-64 bytes, one page)
+  static const uint8_t FRAME_FINISH = 0x03;       // no payload; flushes pending writes
+  static const uint8_t FRAME_READ = 0x04;         // payload: address (LE16), length (1-64)
+  static const uint8_t FRAME_STATS = 0x05;        // payload: flags (optional)
+  static const uint8_t FRAME_BENCHMARK = 0x06;    // payload: scratch address (LE16), length (LE16); overwrites it
+  static const uint8_t FRAME_ERASE = 0x07;        // no payload; software chip erase, answered with an ACK
+  static const uint8_t FRAME_BLANK_CHECK = 0x08;  // payload: address (LE16), length (LE16)
+  static const uint8_t FRAME_CHARACTERIZE = 0x09; // payload: scratch address (LE16); its page is restored after
+  static const uint8_t FRAME_CAPTURE = 0x0A;      // payload: CaptureRequest; leaves the pins as inputs
+  static const uint8_t FRAME_CAPTURE_READ = 0x0B; // payload: first sample (LE16), count (1-CAPTURE_SAMPLES_PER_FRAME)
+  static const uint8_t FRAME_EMULATE = 0x0C;      // payload: flags; answered with EMULATION_INFO
+  static const uint8_t FRAME_EMULATE_LOAD = 0x0D; // payload: address (LE16), data (1-64 bytes) for the emulated ROM
+
+  // Device -> host
+  static const uint8_t FRAME_ACK = 0x80;              // payload: status, failed address (LE16)
+  static const uint8_t FRAME_DATA = 0x81;             // payload: address (LE16), data
+  static const uint8_t FRAME_RESULT = 0x82;           // payload: status, pages written, failed, unchanged (LE16 each)
+  static const uint8_t FRAME_STATS_DATA = 0x83;       // payload: DeviceStats, see encodeStats
+  static const uint8_t FRAME_BENCHMARK_RESULT = 0x84; // payload: BenchmarkResult, see encodeBenchmark
+  static const uint8_t FRAME_BLANK_RESULT = 0x85;     // payload: blank (0/1), first used address (LE16)
+  static const uint8_t FRAME_TIMING = 0x86;           // payload: TimingReport, see encodeTiming
+  static const uint8_t FRAME_CAPTURE_INFO = 0x87;     // payload: CaptureInfo, see encodeCaptureInfo
+  static const uint8_t FRAME_CAPTURE_DATA = 0x88;     // payload: first sample (LE16), CAPTURE_SAMPLE_SIZE bytes each
+  static const uint8_t FRAME_EMULATION_INFO = 0x89;   // payload: EmulationInfo, see encodeEmulationInfo
+
+  // HELLO flags
+  static const uint8_t FLAG_SDP_PROTECTED = 0x01;
+
+  // STATS flags
+  static const uint8_t FLAG_RESET_STATS = 0x01; // Clear the counters after reporting them
+
+  // CAPTURE flags
+  static const uint8_t FLAG_CAPTURE_TRIGGER = 0x01; // Wait for the trigger address; otherwise start at once
+
+  // EMULATE flags
+  static const uint8_t FLAG_EMULATE_RUN = 0x01; // Serve the image after the reply, until the host sends again
+
+  // Status codes
+  static const uint8_t STATUS_OK = 0x00;
+  static const uint8_t STATUS_BAD_CRC = 0x01;
+  static const uint8_t STATUS_BAD_FRAME = 0x02;
+  static const uint8_t STATUS_WRITE_FAILED = 0x03;
+  static const uint8_t STATUS_TIMEOUT = 0x04;
+  static const uint8_t STATUS_BAD_VERSION = 0x05; // HELLO from a client built for another VERSION
+
+  // Instrumentation snapshot: per-phase time of the write path, write cycle
+  // completion histogram (below 125us, then doubling buckets, the last
+  // open-ended), retries and timeouts
+  static const uint8_t STATS_PHASES = 4; // Address setup, bus turnaround, WE pulse, completion polling
+  static const uint8_t STATS_HISTOGRAM_BUCKETS = 10;
+  static const uint32_t STATS_HISTOGRAM_BASE_US = 125;
+  static const uint8_t STATS_PAYLOAD_SIZE = STATS_PHASES * 8 + 8 + STATS_HISTOGRAM_BUCKETS * 2;
+
+  struct DeviceStats
+  {
+    uint32_t phaseMicros[STATS_PHASES];
+    uint32_t phaseCount[STATS_PHASES];
+    uint32_t writeCycles;
+    uint16_t retries;
+    uint16_t timeouts;
+    uint16_t histogram[STATS_HISTOGRAM_BUCKETS]; // Saturates at 0xFFFF
+  };
+
+  // Timings of the scratch-region benchmark (write, verify, dump)
+  static const uint8_t BENCHMARK_PAYLOAD_SIZE = 15;
+
+  struct BenchmarkResult
+  {
+    uint8_t status; // STATUS_WRITE_FAILED if a write or the verify failed
+    uint16_t length;
+    uint32_t writeMicros;
+    uint32_t verifyMicros;
+    uint32_t dumpMicros;
+  };
+
+  // Bus timing measured by FRAME_CHARACTERIZE, margin included. Delays are
+  // on top of the register accesses the firmware makes anyway.
+  static const uint8_t TIMING_PAYLOAD_SIZE = 21;
+
+  struct TimingReport
+  {
+    uint8_t status; // STATUS_WRITE_FAILED if the chip failed even at datasheet timings
+    uint16_t accessNs;
+    uint16_t outputEnableNs;
+    uint32_t firstReadNs;
+    uint32_t firstWriteNs;
+    uint32_t writeCycleMicros; // Longest write cycle seen
+    uint32_t writeTimeoutMicros;
+  };
+
+  // Logic-analyzer capture of another board's ROM bus. Every programmer
+  // pin is an input while it runs, and stays one until a frame needs the
+  // chip again. Samples are read back in frames after the capture.
+  static const uint8_t CAPTURE_REQUEST_SIZE = 11;
+  static const uint8_t CAPTURE_INFO_SIZE = 12;
+  static const uint8_t CAPTURE_SAMPLE_SIZE = 4;
+  static const uint8_t CAPTURE_SAMPLES_PER_FRAME = (MAX_PAYLOAD - 2) / CAPTURE_SAMPLE_SIZE;
+
+  // Levels of the control lines in CaptureSample::control, set when high
+  static const uint8_t CAPTURE_CE = 0x01;
+  static const uint8_t CAPTURE_OE = 0x02;
+  static const uint8_t CAPTURE_WE = 0x04;
+
+  struct CaptureRequest
+  {
+    uint8_t flags;
+    uint16_t triggerAddress;
+    uint16_t preTrigger; // Samples kept before the trigger
+    uint32_t sampleRateHz;
+    uint16_t timeoutMs; // How long to wait for the trigger
+  };
+
+  struct CaptureInfo
+  {
+    uint8_t status; // STATUS_TIMEOUT if the trigger address never came
+    uint8_t triggered;
+    uint16_t sampleCount;
+    uint16_t triggerIndex;
+    uint32_t sampleRateHz; // Achieved rate
+    uint16_t missedSamples; // Not checked for the trigger, the scan fell behind (saturates)
+  };
+
+  struct CaptureSample
+  {
+    uint16_t address;
+    uint8_t data;
+    uint8_t control;
+  };
+
+  // ROM emulation: the image is loaded into the device's RAM, which then
+  // answers the target CPU's reads in place of a chip. accessNs is the
+  // worst case from an address change to valid data, like a ROM's tACC.
+  static const uint8_t EMULATION_INFO_SIZE = 14;
+
+  struct EmulationInfo
+  {
+    uint8_t status;
+    uint16_t capacity; // Image bytes; higher addresses mirror it (address modulo capacity)
+    uint16_t loopCycles;
+    uint32_t accessNs;
+    uint32_t maxClockHz; // For a CPU that gives the ROM one full clock period
+    uint8_t lanes;       // Byte lanes of the 16-bit ROM it serves; chips must fill the others
+  };
+
+  uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+  uint8_t encodeStats(const DeviceStats &stats, uint8_t *out);
+  bool decodeStats(const uint8_t *payload, uint8_t length, DeviceStats &stats);
+  uint8_t encodeBenchmark(const BenchmarkResult &result, uint8_t *out);
+  bool decodeBenchmark(const uint8_t *payload, uint8_t length, BenchmarkResult &result);
+  uint8_t encodeTiming(const TimingReport &report, uint8_t *out);
+  bool decodeTiming(const uint8_t *payload, uint8_t length, TimingReport &report);
+  uint8_t encodeCaptureRequest(const CaptureRequest &request, uint8_t *out);
+  bool decodeCaptureRequest(const uint8_t *payload, uint8_t length, CaptureRequest &request);
+  uint8_t encodeCaptureInfo(const CaptureInfo &info, uint8_t *out);
+  bool decodeCaptureInfo(const uint8_t *payload, uint8_t length, CaptureInfo &info);
+  uint8_t encodeEmulationInfo(const EmulationInfo &info, uint8_t *out);
+  bool decodeEmulationInfo(const uint8_t *payload, uint8_t length, EmulationInfo &info);
+  uint8_t encodeCaptureSample(const CaptureSample &sample, uint8_t *out);
+  CaptureSample decodeCaptureSample(const uint8_t *data);
+
+  // Encode a frame into out (at least length + FRAME_OVERHEAD bytes); returns the frame size
+  size_t encodeFrame(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length, uint8_t *out);
+
+  inline uint16_t readLE16(const uint8_t *data)
+  {
+    return (uint16_t)(data[0] | (data[1] << 8));
+  }
+
+  inline void writeLE16(uint8_t *data, uint16_t value)
+  {
+    data[0] = (uint8_t)(value & 0xFF);
+    data[1] = (uint8_t)(value >> 8);
+  }
+
+  inline uint32_t readLE32(const uint8_t *data)
+  {
+    return (uint32_t)readLE16(data) | ((uint32_t)readLE16(data + 2) << 16);
+  }
+
+  inline void writeLE32(uint8_t *data, uint32_t value)
+  {
+    writeLE16(data, (uint16_t)(value & 0xFFFF));
+    writeLE16(data + 2, (uint16_t)(value >> 16));
+  }
+}
+
+struct Frame
+{
+  uint8_t type;
+  uint8_t seq;
+  uint8_t length;
+  uint8_t payload[ProgrammingProtocol::MAX_PAYLOAD];
+};
+
+// Incremental decoder; resynchronises on the next SYNC byte after any error
+class FrameParser
+{
+public:
+  enum Result
+  {
+    PARSE_INCOMPLETE,
+    PARSE_FRAME,   // frame() holds a valid frame
+    PARSE_BAD_CRC, // frame() holds the header of the rejected frame
+  };
+
+  FrameParser();
+
+  Result push(uint8_t byte);
+  const Frame &frame() const;
+  void reset();
+
+private:
+  enum State
+  {
+    WAIT_SYNC,
+    READ_TYPE,
+    READ_SEQ,
+    READ_LENGTH,
+    READ_PAYLOAD,
+    READ_CRC_LOW,
+    READ_CRC_HIGH,
+  };
+
+  State state;
+  Frame current;
+  uint8_t received;
+  uint16_t crc;
+};
+
+// Byte transport (USART on the device, a tty or pty on the host)
+class ByteStream
+{
+public:
+  virtual ~ByteStream() {}
+
+  // Next received byte, or -1 if nothing is waiting
+  virtual int read() = 0;
+  virtual void write(const uint8_t *data, uint16_t length) = 0;
+};
+
+// Page-level access to the chip being programmed
+class PageStore
+{
+public:
+  enum WriteResult
+  {
+    PAGE_WRITTEN,
+    PAGE_UNCHANGED, // The chip already held the data, no write cycle was spent
+    PAGE_FAILED,
+  };
+
+  virtual ~PageStore() {}
+
+  // A client said HELLO; the chip may have been swapped since the last one
+  virtual void beginSession() {}
+
+  // Write bytes that lie within one page and confirm them
+  virtual WriteResult writePage(uint16_t address, const uint8_t *data, uint16_t length, bool sdpProtected) = 0;
+  virtual void readBlock(uint16_t address, uint8_t *data, uint16_t length) = 0;
+
+  // Set every byte to 0xFF
+  virtual bool erase() = 0;
+
+  // True if every byte in the range is 0xFF; otherwise firstUsed is the first that is not
+  virtual bool isBlank(uint16_t address, uint16_t length, uint16_t &firstUsed) = 0;
+};
+
+// Optional device diagnostics behind FRAME_STATS, FRAME_BENCHMARK,
+// FRAME_CHARACTERIZE and the capture frames
+class Diagnostics
+{
+public:
+  virtual ~Diagnostics() {}
+
+  virtual void readStats(ProgrammingProtocol::DeviceStats &stats, bool reset) = 0;
+  virtual void runBenchmark(uint16_t address, uint16_t length, ProgrammingProtocol::BenchmarkResult &result) = 0;
+
+  // Measure the chip's timing on the page holding address and use it from then on
+  virtual void characterize(uint16_t address, ProgrammingProtocol::TimingReport &report) = 0;
+
+  // Sample the bus with every pin an input; false if capture is not supported
+  virtual bool capture(const ProgrammingProtocol::CaptureRequest &request, ProgrammingProtocol::CaptureInfo &info) = 0;
+
+  // Copy samples of the last capture from index on; returns how many there were
+  virtual uint8_t readCapture(uint16_t index, ProgrammingProtocol::CaptureSample *samples, uint8_t count) = 0;
+
+  // Drive the pins again after a capture
+  virtual void endCapture() = 0;
+};
+
+// Optional ROM emulation behind FRAME_EMULATE and FRAME_EMULATE_LOAD
+class Emulator
+{
+public:
+  virtual ~Emulator() {}
+
+  // Copy part of the image; false if it does not fit
+  virtual bool load(uint16_t address, const uint8_t *data, uint16_t length) = 0;
+
+  // Capacity and the measured response time
+  virtual void describe(ProgrammingProtocol::EmulationInfo &info) = 0;
+
+  // Answer reads until the host starts sending; the pins are inputs afterwards
+  virtual void run() = 0;
+
+  // Drive the pins for the chip again
+  virtual void endEmulation() = 0;
+};
+
+#endif // PROGRAMMING_PROTOCOL_H
@@ -0,0 +1,77 @@
+#ifndef PROGRESS_JOURNAL_H
+#define PROGRESS_JOURNAL_H
+
+#include "ImageSource.h"
+#include "stm32f1xx_hal.h"
+
+#include <stdint.h>
+
+// Progress of a writeImage session, kept in the last 2 KB of the STM32's
+// flash so a programming run cut short by a reset or power loss can pick up
+// where it stopped. The journal holds the image's CRC, where it goes and
+// one halfword per EEPROM page. Flash bits only go from 1 to 0 without an
+// erase, and the F1 programs whole halfwords, so a page is marked done by
+// programming its halfword to 0x0000; nothing is ever rewritten in place.
+//
+// The header's magic is programmed last, so a header torn by a reset reads
+// as no session at all.
+class ProgressJournal
+{
+public:
+  static const uint32_t JOURNAL_OFFSET = 0xF800; // From FLASH_BASE: the last two 1 KB pages of 64 KB
+  static const uint8_t JOURNAL_FLASH_PAGES = 2;
+  static const uint16_t MAX_PAGES = 512; // One 32 KB chip
+  static const uint16_t MAGIC = 0x4A52;  // "RJ"
+  static const uint8_t VERSION = 1;
+  static const uint16_t HEADER_HALFWORDS = 8; // Header fields, then one halfword per page
+
+  ProgressJournal();
+
+  // CRC-32 of the image as it will be written, through the CRC unit
+  static uint32_t hashImage(ImageSource &source, uint16_t length);
+
+  // Continue the session in flash if it is for the same image, range and
+  // chip, otherwise erase the journal and start a new one. Returns the
+  // number of pages already done.
+  uint16_t open(uint32_t imageHash, uint16_t startAddress, uint16_t length, uint8_t chip);
+
+  bool isDone(uint16_t page) const; // Page index from the session's first page
+  bool markDone(uint16_t page);
+
+  // Highest page marked done, or -1; after a resume this is the page whose
+  // write was confirmed last before the interruption
+  int32_t getLastCommitted() const;
+  bool isResumed() const;
+
+  // End the session so the next open starts over (after a verified run, or
+  // when the chip no longer matches what the journal claims)
+  void close();
+
+private:
+  enum Field
+  {
+    FIELD_MAGIC,
+    FIELD_VERSION_CHIP, // Version low byte, chip high byte
+    FIELD_HASH_LOW,
+    FIELD_HASH_HIGH,
+    FIELD_START,
+    FIELD_LENGTH,
+    FIELD_CLOSED,
+  };
+
+  static const uint16_t SESSION_OPEN = 0xFFFF;
+  static const uint16_t SESSION_CLOSED = 0x0000;
+  static const uint16_t PAGE_DONE = 0x0000;
+
+  uint16_t pageCount;
+  int32_t lastCommitted;
+  bool resumed;
+  bool active;
+
+  static volatile const uint16_t *journal();
+  static uint16_t readField(uint16_t index);
+  static bool program(uint16_t index, uint16_t value);
+  static bool eraseJournal();
+};
+
+#endif // PROGRESS_JOURNAL_H
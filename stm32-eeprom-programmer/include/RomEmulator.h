@@ -0,0 +1,65 @@
+#ifndef ROM_EMULATOR_H
+#define ROM_EMULATOR_H
+
+#include "stm32f1xx_hal.h"
+#include "EEPROMProgrammer.h"
+#include "ProgrammingProtocol.h"
+#include "SharedBuffer.h"
+
+// Stands in for the ROM of the board the programmer is clipped onto: the
+// image sits in SRAM and a polling loop answers the CPU's reads. Each pass
+// reads GPIOA and GPIOB, looks the address up, stores the byte to the data
+// pins with one BSRR write per port, and turns the data pins into outputs
+// while CE and OE are both low. Interrupts would add 12 cycles of entry
+// latency to every access, and DMA cannot do the table lookup, so the loop
+// is the fastest scheme the part has.
+//
+// A change on the bus is answered by the end of the following pass, so the
+// access time is two passes; the first describe() times the loop to
+// publish it. Serving stops on the host's next start bit (USART3 RX low),
+// and the byte still reaches SerialLink's DMA.
+//
+// Only the 8 data pins are driven, so this is one byte lane of the 16-bit
+// ROM: the chip in the other lane's socket still has to hold its half.
+// The image is the first SIZE bytes; higher addresses mirror it (address
+// modulo SIZE). It lives in a SharedBuffer with BusCapture's samples, and
+// a capture in between blanks it to 0xFF.
+class RomEmulator : public Emulator
+{
+public:
+  static const uint16_t SIZE = 14336; // What 20 KB of SRAM leaves; a 32 KB image does not fit
+  static const uint16_t HOST_RX_PIN = GPIO_PIN_11; // PB11 - USART3 RX, idles high
+  static const uint32_t CALIBRATION_PASSES = 256;
+
+  RomEmulator(EEPROMProgrammer &programmer, SharedBuffer &buffer); // At least SIZE bytes
+
+  bool load(uint16_t address, const uint8_t *data, uint16_t length) override;
+  void describe(ProgrammingProtocol::EmulationInfo &info) override;
+  void run() override;
+  void endEmulation() override;
+
+private:
+  // CRL/CRH words of the ports carrying data pins
+  struct PortModes
+  {
+    uint32_t dataLowB;
+    uint32_t dataHighB;
+    uint32_t dataHighC;
+  };
+
+  EEPROMProgrammer &programmer;
+  SharedBuffer &buffer;
+  uint32_t loopCycles; // Longest pass, 0 until measured
+
+  // Takes the buffer back, blank if another mode had it
+  uint8_t *image();
+  void measure();
+  PortModes currentModes() const;
+
+  // Calibrating runs the given number of passes with every store a no-op
+  // and the direction switch taken on each pass, the worst case
+  template <bool calibrating>
+  void serve(const PortModes &input, const PortModes &output, uint32_t passes);
+};
+
+#endif // ROM_EMULATOR_H
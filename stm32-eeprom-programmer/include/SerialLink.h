@@ -0,0 +1,33 @@
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include "stm32f1xx_hal.h"
+#include "ProgrammingProtocol.h"
+
+// USART3 link to the host (PB10 TX, PB11 RX). Reception runs on DMA1
+// channel 3 into a circular buffer, so bytes keep arriving while the CPU is
+// busy in an EEPROM write cycle.
+class SerialLink : public ByteStream
+{
+public:
+  static const uint32_t DEFAULT_BAUD_RATE = 230400;
+  static const uint16_t RX_BUFFER_SIZE = 512; // Holds several frames
+
+  static const uint16_t TX_PIN = GPIO_PIN_10; // PB10 - USART3 TX
+  static const uint16_t RX_PIN = GPIO_PIN_11; // PB11 - USART3 RX
+
+  SerialLink();
+
+  void begin(uint32_t baudRate = DEFAULT_BAUD_RATE);
+
+  int read() override;
+  void write(const uint8_t *data, uint16_t length) override;
+
+private:
+  uint8_t rxBuffer[RX_BUFFER_SIZE];
+  uint16_t rxTail; // Next byte to hand out
+
+  uint16_t rxHead(); // Next byte the DMA will fill
+};
+
+#endif // SERIAL_LINK_H
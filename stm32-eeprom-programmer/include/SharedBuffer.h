@@ -0,0 +1,39 @@
+#ifndef SHARED_BUFFER_H
+#define SHARED_BUFFER_H
+
+#include <stdint.h>
+
+// One block of SRAM lent in turn to modes that never run at once:
+// BusCapture's sample buffers and RomEmulator's image. Taking it over
+// leaves the previous holder's contents undefined, so a holder checks it
+// still has the buffer before trusting them.
+class SharedBuffer
+{
+public:
+  explicit SharedBuffer(void *data) : bytes((uint8_t *)data), holder(nullptr) {}
+
+  // Hands the buffer to client; false if someone else held it, so the
+  // contents are not the client's
+  bool take(const void *client)
+  {
+    bool kept = holder == client;
+    holder = client;
+    return kept;
+  }
+
+  bool heldBy(const void *client) const
+  {
+    return holder == client;
+  }
+
+  uint8_t *data() const
+  {
+    return bytes;
+  }
+
+private:
+  uint8_t *bytes;
+  const void *holder;
+};
+
+#endif // SHARED_BUFFER_H
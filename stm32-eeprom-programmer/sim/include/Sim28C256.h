@@ -0,0 +1,120 @@
+#ifndef SIM_28C256_H
+#define SIM_28C256_H
+
+#include <stdint.h>
+
+// Behavioural model of an AT28C256 driven pin by pin. Times are in
+// nanoseconds of virtual time, supplied by the caller with every event.
+//
+// Covered: address/OE access times (reads that come too early return the
+// previous output), byte and 64-byte page loads with the tBLC window, the
+// write cycle with DATA# polling and toggle bit, software data protection
+// (enable with AA/55/A0, disable with AA/55/80/AA/55/20) and software chip
+// erase (AA/55/80/AA/55/10).
+class Sim28C256
+{
+public:
+  static const uint32_t SIZE = 32768;
+  static const uint16_t PAGE_SIZE = 64;
+
+  struct Timing
+  {
+    uint32_t accessNs = 150;        // tACC
+    uint32_t outputEnableNs = 70;   // tOE
+    uint32_t addressSetupNs = 0;    // tAS
+    uint32_t dataSetupNs = 50;      // tDS
+    uint32_t writePulseNs = 100;    // tWP
+    uint32_t byteLoadNs = 150000;   // tBLC, page closes after this long without a load
+    uint32_t writeCycleNs = 5000000; // tWC, typical; the datasheet maximum is 10ms
+    uint32_t chipEraseNs = 10000000; // tEC, typical; the datasheet maximum is 20ms
+  };
+
+  struct Stats
+  {
+    uint32_t bytesLoaded;
+    uint32_t writeCycles;      // Page/byte programming cycles started
+    uint32_t chipErases;
+    uint32_t blockedWrites;    // Cycles that wrote nothing because SDP was on
+    uint32_t loadsWhileBusy;   // Ignored, the chip was in a write cycle
+    uint32_t pageViolations;   // Load outside the page opened by the first byte
+    uint32_t timingViolations; // tWP, tDS or tAS not met on a load
+    uint32_t earlyReads;       // Data sampled before tACC/tOE
+    uint32_t statusReads;      // Reads answered with DATA#/toggle status
+  };
+
+  Sim28C256();
+
+  void setTiming(const Timing &newTiming);
+  const Timing &getTiming() const;
+
+  // Apply new pin levels (true = high) at the given time
+  void setPins(uint64_t nowNs, uint16_t address, uint8_t data, bool ce, bool oe, bool we);
+
+  // True while the chip drives the data lines
+  bool outputEnabled() const;
+
+  // Value on the data lines; only meaningful while outputEnabled()
+  uint8_t readOutput(uint64_t nowNs);
+
+  // Finish any page load or write cycle that would have ended by now
+  void update(uint64_t nowNs);
+  bool isBusy(uint64_t nowNs);
+
+  bool isSdpEnabled() const;
+  void setSdpEnabled(bool enabled);
+
+  // Direct access to the array, for test setup and checks
+  uint8_t *contents();
+  const Stats &getStats() const;
+  void resetStats();
+
+private:
+  enum Command
+  {
+    COMMAND_NONE,
+    COMMAND_AA,
+    COMMAND_AA_55,
+    COMMAND_AA_55_80,
+    COMMAND_AA_55_80_AA,
+    COMMAND_AA_55_80_AA_55,
+  };
+
+  Timing timing;
+  Stats stats;
+  uint8_t memory[SIZE];
+
+  // Pin state and edge times
+  uint16_t address;
+  uint8_t dataIn;
+  bool ce, oe, we;
+  uint64_t addressChangedNs;
+  uint64_t dataChangedNs;
+  uint64_t ceFellNs;
+  uint64_t oeFellNs;
+  uint64_t weFellNs;
+  uint16_t latchedAddress;
+  uint8_t lastOutput;
+
+  // Programming state
+  bool sdpEnabled;
+  bool sdpUnlocked; // AA/55/A0 seen, the next page may be written
+  Command command;
+  bool pageOpen;
+  uint16_t pageBase;
+  uint8_t pageData[PAGE_SIZE];
+  uint64_t pageMask; // Loaded bytes of the page
+  bool pageBlocked;
+  uint64_t lastLoadNs;
+  uint8_t lastLoadedData;
+  bool busy;
+  bool commitOnDone;
+  bool eraseOnDone;
+  uint64_t busyUntilNs;
+  bool toggleBit;
+
+  void load(uint64_t nowNs, uint16_t loadAddress, uint8_t data);
+  bool takeCommand(uint64_t nowNs, uint16_t loadAddress, uint8_t data);
+  void startWriteCycle(uint64_t startNs, bool commit);
+};
+
+#endif // SIM_28C256_H
@@ -0,0 +1,109 @@
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include "EEPROMProgrammer.h"
+#include "Sim28C256.h"
+#include "stm32f1xx_hal.h"
+
+// The simulated Blue Pill: GPIO, SysTick, DWT, CRC, TIM2, DMA1 and RTC registers
+// and 64 KB of flash on a virtual clock, with two 28C256 wired to the pins listed in
+// EEPROMProgrammer.h. They share every line but CE, as in dual mode; single
+// chip code only ever enables the lower one.
+//
+// Every register access costs ACCESS_CYCLES; code between accesses is free.
+// Simulated times are therefore a lower bound set by bus traffic and busy
+// waits, which is what the programmer's hot paths consist of.
+//
+// The RTC runs from an LSI at LSI_HZ once selected; its prescaler divider
+// counts down from PRL, the only part of it simulated.
+//
+// TIM2 counts on the core clock and raises the DMA1 requests of its update
+// and compare events. DMA transfers run in the background, one at a time,
+// DMA_TRANSFER_CYCLES each; they do not stall the CPU.
+//
+// Flash programming and erase stall the CPU for the typical tPROG and
+// tERASE. Flash keeps its contents across reset(), like a power cycle;
+// eraseFlash() gives a factory-fresh part.
+//
+// A BusMaster stands in for another board on the same bus, such as the
+// homemade CPU whose ROM socket the programmer is clipped onto. It drives
+// the address lines, the lower chip's CE, OE and WE wherever the MCU does
+// not; the chips and the port inputs follow it. With the sockets empty,
+// the programmer itself has to answer the master's reads.
+namespace SimBoard
+{
+  static const uint32_t ACCESS_CYCLES = 2; // Load/store to APB2 or the PPB, no wait states
+  static const uint32_t DMA_TRANSFER_CYCLES = 6;    // Arbitration, APB2 access and SRAM access
+  static const uint32_t DEFAULT_CLOCK_HZ = 8000000; // HSI, as the firmware runs without SystemClock_Config
+  static const uint32_t LSI_HZ = 40000;
+  static const uint32_t FLASH_SIZE = 65536;
+  static const uint32_t FLASH_PROGRAM_NS = 52500;   // tPROG per halfword
+  static const uint32_t FLASH_ERASE_NS = 20000000;  // tERASE per 1 KB page
+
+  struct Stats
+  {
+    uint64_t registerReads;
+    uint64_t registerWrites;
+    uint32_t busContention; // Two of the MCU, the chips and the bus master drove the same lines
+    uint32_t dmaTransfers;
+    uint32_t flashPrograms; // Halfwords
+    uint32_t flashErases;   // Pages
+    uint32_t flashErrors;   // Programs of a halfword that was not erased, or while locked
+  };
+
+  // Pin levels of an external bus master, true is high
+  struct BusState
+  {
+    uint16_t address;
+    bool ce;
+    bool oe;
+    bool we;
+  };
+
+  class BusMaster
+  {
+  public:
+    virtual ~BusMaster() {}
+
+    // The bus at nowNs, and the time it last changed (never later than nowNs)
+    virtual BusState stateAt(uint64_t nowNs, uint64_t &changedNs) = 0;
+
+    // What the MCU puts on the data lines as of nowNs, after stateAt; lines
+    // it does not drive read high
+    virtual void dataChanged(uint64_t nowNs, uint8_t data)
+    {
+      (void)nowNs;
+      (void)data;
+    }
+  };
+
+  // Reset registers, clock and chip; detaches the bus master
+  void reset(uint32_t clockHz = DEFAULT_CLOCK_HZ, bool dwtPresent = true);
+
+  void eraseFlash();
+
+  // SystemCoreClockUpdate() reports this instead of the real clock, as a
+  // build for the wrong crystal would; 0 reports the real one
+  void setReportedClock(uint32_t clockHz);
+
+  // nullptr detaches it
+  void attachBusMaster(BusMaster *master);
+
+  // Neither chip responds to the bus while set; reset() puts them back
+  void setSocketsEmpty(bool empty);
+
+  // Drive an otherwise floating input pin from fromNs on, e.g. a UART line;
+  // later calls for the same pin take over once their time comes
+  void driveInput(uint8_t port, uint16_t pin, bool level, uint64_t fromNs);
+
+  Sim28C256 &chip(EEPROMProgrammer::Chip which = EEPROMProgrammer::CHIP_LOWER);
+
+  uint64_t cycles();
+  uint64_t nanoseconds();
+  uint32_t clockHz();
+
+  const Stats &getStats();
+  void resetStats();
+}
+
+#endif // SIM_BOARD_H
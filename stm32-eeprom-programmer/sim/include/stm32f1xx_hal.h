@@ -0,0 +1,366 @@
+#ifndef SIM_STM32F1XX_HAL_H
+#define SIM_STM32F1XX_HAL_H
+
+// Stand-in for the STM32Cube HAL header in the native build. Provides the
+// subset of types, registers and macros the programmer code uses; every
+// register is a SimRegister, so each access is routed to SimBoard, which
+// advances the virtual clock and drives the simulated 28C256.
+
+#include <stdint.h>
+
+class SimRegister;
+
+uint32_t simRegisterRead(SimRegister &reg);
+void simRegisterWrite(SimRegister &reg, uint32_t value);
+
+class SimRegister
+{
+public:
+  SimRegister() : value(0) {}
+
+  SimRegister &operator=(uint32_t newValue)
+  {
+    simRegisterWrite(*this, newValue);
+    return *this;
+  }
+
+  SimRegister &operator=(SimRegister &other)
+  {
+    return *this = (uint32_t)other;
+  }
+
+  SimRegister &operator|=(uint32_t bits)
+  {
+    return *this = (uint32_t)*this | bits;
+  }
+
+  SimRegister &operator&=(uint32_t bits)
+  {
+    return *this = (uint32_t)*this & bits;
+  }
+
+  // Reads have side effects (clock, toggle bit), so this is not const
+  operator uint32_t()
+  {
+    return simRegisterRead(*this);
+  }
+
+  uint32_t value; // Backing store, bypasses the simulation
+};
+
+// GPIO
+typedef struct
+{
+  SimRegister CRL;
+  SimRegister CRH;
+  SimRegister IDR;
+  SimRegister ODR;
+  SimRegister BSRR;
+  SimRegister BRR;
+  SimRegister LCKR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum
+{
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+#define GPIO_PIN_All ((uint16_t)0xFFFF)
+
+// Values differ from the real HAL; only HAL_GPIO_Init interprets them
+#define GPIO_MODE_INPUT 0x00u
+#define GPIO_MODE_OUTPUT_PP 0x01u
+#define GPIO_MODE_OUTPUT_OD 0x11u
+#define GPIO_MODE_AF_PP 0x02u
+#define GPIO_MODE_AF_OD 0x12u
+#define GPIO_MODE_AF_INPUT GPIO_MODE_INPUT
+#define GPIO_MODE_ANALOG 0x03u
+
+#define GPIO_NOPULL 0x0u
+#define GPIO_PULLUP 0x1u
+#define GPIO_PULLDOWN 0x2u
+
+// CRx MODE bits, as in the real HAL
+#define GPIO_SPEED_FREQ_MEDIUM 0x1u
+#define GPIO_SPEED_FREQ_LOW 0x2u
+#define GPIO_SPEED_FREQ_HIGH 0x3u
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+extern GPIO_TypeDef simGPIOA;
+extern GPIO_TypeDef simGPIOB;
+extern GPIO_TypeDef simGPIOC;
+
+#define GPIOA (&simGPIOA)
+#define GPIOB (&simGPIOB)
+#define GPIOC (&simGPIOC)
+
+// Clocks and remapping have no effect on the simulation
+#define __HAL_RCC_GPIOA_CLK_ENABLE() \
+  do                                 \
+  {                                  \
+  } while (0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_RCC_GPIOC_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_RCC_AFIO_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_AFIO_REMAP_SWJ_NOJTAG() __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_RCC_CRC_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+
+// CRC unit (CRC-32/MPEG-2 over words, as on the F1)
+typedef struct
+{
+  SimRegister DR;
+  SimRegister IDR;
+  SimRegister CR;
+} CRC_TypeDef;
+
+extern CRC_TypeDef simCRC;
+
+#define CRC (&simCRC)
+#define CRC_CR_RESET (1UL << 0)
+
+// General-purpose timer (only the registers the programmer touches)
+typedef struct
+{
+  SimRegister CR1;
+  SimRegister CR2;
+  SimRegister SMCR;
+  SimRegister DIER;
+  SimRegister SR;
+  SimRegister EGR;
+  SimRegister CCMR1;
+  SimRegister CCMR2;
+  SimRegister CCER;
+  SimRegister CNT;
+  SimRegister PSC;
+  SimRegister ARR;
+  SimRegister RCR;
+  SimRegister CCR1;
+  SimRegister CCR2;
+  SimRegister CCR3;
+  SimRegister CCR4;
+} TIM_TypeDef;
+
+extern TIM_TypeDef simTIM2;
+
+#define TIM2 (&simTIM2)
+#define __HAL_RCC_TIM2_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+
+#define TIM_CR1_CEN (1UL << 0)
+#define TIM_DIER_UDE (1UL << 8)
+#define TIM_DIER_CC1DE (1UL << 9)
+#define TIM_DIER_CC2DE (1UL << 10)
+#define TIM_DIER_CC3DE (1UL << 11)
+#define TIM_DIER_CC4DE (1UL << 12)
+
+// DMA1. CPAR/CMAR hold host pointers here, so they are plain fields and
+// their writes are not timed; code stores (uintptr_t) casts into them.
+typedef struct
+{
+  SimRegister CCR;
+  SimRegister CNDTR;
+  uintptr_t CPAR;
+  uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+  SimRegister ISR;
+  SimRegister IFCR;
+} DMA_TypeDef;
+
+extern DMA_TypeDef simDMA1;
+extern DMA_Channel_TypeDef simDMA1Channels[7];
+
+#define DMA1 (&simDMA1)
+#define DMA1_Channel1 (&simDMA1Channels[0])
+#define DMA1_Channel2 (&simDMA1Channels[1])
+#define DMA1_Channel3 (&simDMA1Channels[2])
+#define DMA1_Channel4 (&simDMA1Channels[3])
+#define DMA1_Channel5 (&simDMA1Channels[4])
+#define DMA1_Channel6 (&simDMA1Channels[5])
+#define DMA1_Channel7 (&simDMA1Channels[6])
+#define __HAL_RCC_DMA1_CLK_ENABLE() __HAL_RCC_GPIOA_CLK_ENABLE()
+
+#define DMA_CCR_EN (1UL << 0)
+#define DMA_CCR_TCIE (1UL << 1)
+#define DMA_CCR_DIR (1UL << 4)
+#define DMA_CCR_CIRC (1UL << 5)
+#define DMA_CCR_PINC (1UL << 6)
+#define DMA_CCR_MINC (1UL << 7)
+#define DMA_CCR_PSIZE_0 (1UL << 8)
+#define DMA_CCR_PSIZE_1 (1UL << 9)
+#define DMA_CCR_MSIZE_0 (1UL << 10)
+#define DMA_CCR_MSIZE_1 (1UL << 11)
+#define DMA_CCR_PL_0 (1UL << 12)
+#define DMA_CCR_PL_1 (1UL << 13)
+#define DMA_CCR_PL (3UL << 12)
+
+// Per-channel flags are 4 bits apart: GIF, TCIF, HTIF, TEIF
+#define DMA_ISR_TCIF1 (1UL << 1)
+#define DMA_ISR_TCIF2 (1UL << 5)
+#define DMA_ISR_TCIF7 (1UL << 25)
+#define DMA_ISR_TEIF1 (1UL << 3)
+#define DMA_ISR_TEIF2 (1UL << 7)
+#define DMA_ISR_TEIF7 (1UL << 27)
+#define DMA_IFCR_CGIF1 (1UL << 0)
+#define DMA_IFCR_CGIF2 (1UL << 4)
+#define DMA_IFCR_CGIF7 (1UL << 24)
+
+// Flash, for the programmer's own storage. Addresses are host pointers into
+// a simulated 64 KB array, so FLASH_BASE and PageAddress are uintptr_t here;
+// code passes FLASH_BASE + offset, which works with both.
+typedef enum
+{
+  HAL_OK = 0x00,
+  HAL_ERROR = 0x01,
+  HAL_BUSY = 0x02,
+  HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uintptr_t PageAddress;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+extern uint8_t simFlash[];
+
+#define FLASH_BASE ((uintptr_t)simFlash)
+#define FLASH_PAGE_SIZE 0x400U
+#define FLASH_BANK_1 1U
+#define FLASH_TYPEERASE_PAGES 0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+// Core timers
+typedef struct
+{
+  SimRegister CTRL;
+  SimRegister LOAD;
+  SimRegister VAL;
+  SimRegister CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  SimRegister CTRL;
+  SimRegister CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  SimRegister DHCSR;
+  SimRegister DCRSR;
+  SimRegister DCRDR;
+  SimRegister DEMCR;
+} CoreDebug_Type;
+
+extern SysTick_Type simSysTick;
+extern DWT_Type simDWT;
+extern CoreDebug_Type simCoreDebug;
+
+#define SysTick (&simSysTick)
+#define DWT (&simDWT)
+#define CoreDebug (&simCoreDebug)
+
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0)
+#define SysTick_CTRL_CLKSOURCE_Msk (1UL << 2)
+#define SysTick_LOAD_RELOAD_Msk 0xFFFFFFUL
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+// Reset and clock control, power and RTC, for the clock check against the
+// RTC clock. Only the LSI and the RTC prescaler are simulated.
+typedef struct
+{
+  SimRegister CR;
+  SimRegister CFGR;
+  SimRegister CIR;
+  SimRegister APB2RSTR;
+  SimRegister APB1RSTR;
+  SimRegister AHBENR;
+  SimRegister APB2ENR;
+  SimRegister APB1ENR;
+  SimRegister BDCR;
+  SimRegister CSR;
+} RCC_TypeDef;
+
+typedef struct
+{
+  SimRegister CR;
+  SimRegister CSR;
+} PWR_TypeDef;
+
+typedef struct
+{
+  SimRegister CRH;
+  SimRegister CRL;
+  SimRegister PRLH;
+  SimRegister PRLL;
+  SimRegister DIVH;
+  SimRegister DIVL;
+  SimRegister CNTH;
+  SimRegister CNTL;
+  SimRegister ALRH;
+  SimRegister ALRL;
+} RTC_TypeDef;
+
+extern RCC_TypeDef simRCC;
+extern PWR_TypeDef simPWR;
+extern RTC_TypeDef simRTC;
+
+#define RCC (&simRCC)
+#define PWR (&simPWR)
+#define RTC (&simRTC)
+
+#define HSE_VALUE 8000000U
+#define RCC_APB1ENR_BKPEN (1UL << 27)
+#define RCC_APB1ENR_PWREN (1UL << 28)
+#define RCC_BDCR_RTCSEL (3UL << 8)
+#define RCC_BDCR_RTCSEL_LSE (1UL << 8)
+#define RCC_BDCR_RTCSEL_LSI (2UL << 8)
+#define RCC_BDCR_RTCSEL_HSE (3UL << 8)
+#define RCC_BDCR_RTCEN (1UL << 15)
+#define RCC_CSR_LSION (1UL << 0)
+#define RCC_CSR_LSIRDY (1UL << 1)
+#define PWR_CR_DBP (1UL << 8)
+#define RTC_CRL_RSF (1UL << 3)
+
+extern uint32_t SystemCoreClock;
+void SystemCoreClockUpdate(void);
+
+#endif // SIM_STM32F1XX_HAL_H
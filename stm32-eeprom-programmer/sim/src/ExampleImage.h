@@ -0,0 +1,279 @@
+#ifndef EXAMPLE_IMAGE_H
+#define EXAMPLE_IMAGE_H
+
+#include <stdint.h>
+
+// Generated from toolchain/example-programs/game-and-music.asm with:
+//   node image-compressor.js build/game-and-music.hack --lane low --name exampleLower --raw
+//   node image-compressor.js build/game-and-music.hack --lane high --name exampleUpper --raw
+
+// game-and-music.hack, lower byte lane
+// 1279 bytes compressed to 1066 (1.20:1)
+const uint8_t exampleLowerCompressed[] = {
+    0x00, 0x10, 0x88, 0x11, 0x88, 0x12, 0x88, 0x13, 0x88, 0x00, 0x14, 0x88, 0x15, 0x88, 0x16, 0x88,
+    0x17, 0x88, 0x00, 0x18, 0x88, 0x19, 0x88, 0x1A, 0x88, 0x1B, 0x88, 0x00, 0x1C, 0x88, 0x1D, 0x88,
+    0x1E, 0x88, 0x1F, 0x88, 0x00, 0x20, 0x88, 0x21, 0x88, 0x22, 0x88, 0x23, 0x88, 0x00, 0x24, 0x88,
+    0x25, 0x88, 0x26, 0x88, 0x0A, 0x10, 0x00, 0x27, 0x08, 0x32, 0x10, 0x28, 0x08, 0x64, 0x10, 0x22,
+    0x29, 0x07, 0x00, 0x2A, 0x08, 0x2B, 0x11, 0x00, 0x2C, 0x08, 0x00, 0x2D, 0x88, 0x00, 0x10, 0x02,
+    0xD0, 0x2E, 0x08, 0x00, 0x2F, 0xC8, 0x02, 0x10, 0x30, 0x08, 0x31, 0x88, 0x00, 0x32, 0x88, 0x33,
+    0x88, 0x02, 0x10, 0x34, 0x08, 0x00, 0x35, 0x88, 0x36, 0x88, 0x37, 0x88, 0x38, 0x88, 0x00, 0xD2,
+    0x10, 0x39, 0x08, 0x80, 0x10, 0x3A, 0x08, 0x00, 0x0C, 0x10, 0x3B, 0x08, 0x0D, 0x10, 0x3C, 0x08,
+    0x00, 0x05, 0x10, 0x3D, 0x08, 0x0A, 0x10, 0x3E, 0x08, 0x00, 0x3F, 0x88, 0x54, 0x10, 0x20, 0x08,
+    0x2C, 0x10, 0x80, 0x40, 0x08, 0x0E, 0x10, 0x41, 0x08, 0x53, 0x49, 0x00, 0x80, 0x45, 0x10, 0x2D,
+    0x08, 0x4C, 0x10, 0x2E, 0x07, 0x00, 0x08, 0x2F, 0x08, 0x43, 0x4B, 0x00, 0x54, 0x10, 0x31, 0x08,
+    0x80, 0x20, 0x10, 0x32, 0x08, 0x41, 0x10, 0x33, 0x0F, 0x00, 0x02, 0x34, 0x0F, 0x00, 0x35, 0x08,
+    0x49, 0x10, 0x36, 0x08, 0x00, 0x4F, 0x10, 0x37, 0x08, 0x4E, 0x10, 0x38, 0x08, 0x22, 0x3A, 0x59,
+    0x00, 0x3A, 0x10, 0x42, 0x59, 0x00, 0x43, 0x08, 0xAA, 0x50, 0x61, 0x00, 0x52, 0x61, 0x00, 0x45,
+    0x61, 0x00, 0x53, 0x61, 0x00, 0x22, 0x53, 0x61, 0x00, 0x20, 0x10, 0x3F, 0x27, 0x00, 0x40, 0x08,
+    0x2A, 0x55, 0x5F, 0x00, 0x4D, 0x27, 0x00, 0x42, 0x27, 0x00, 0x45, 0x10, 0xA2, 0x44, 0x27, 0x00,
+    0x45, 0x08, 0x46, 0x07, 0x00, 0x0E, 0x07, 0x00, 0x08, 0x49, 0x10, 0x46, 0x23, 0x00, 0x47, 0x08,
+    0x56, 0x10, 0x2A, 0x48, 0x67, 0x00, 0x49, 0x7F, 0x00, 0x4A, 0x13, 0x00, 0x4B, 0x08, 0xA8, 0x44,
+    0x10, 0x4C, 0x3F, 0x00, 0x4D, 0x13, 0x00, 0x4E, 0x7B, 0x00, 0xAA, 0x4F, 0x7B, 0x00, 0x50, 0x17,
+    0x00, 0x51, 0x7B, 0x00, 0x52, 0x2F, 0x00, 0x00, 0x53, 0x08, 0x00, 0x10, 0x00, 0x08, 0x98, 0x10,
+    0x00, 0x11, 0x08, 0x48, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x40, 0x25, 0xC8, 0x10, 0x03, 0x10, 0x26,
+    0x18, 0x01, 0x11, 0x04, 0x08, 0x59, 0x10, 0x08, 0x1F, 0x10, 0x8B, 0x01, 0x1E, 0x00, 0x10, 0x75,
+    0x01, 0x67, 0x10, 0x1A, 0x08, 0xCE, 0x10, 0x87, 0x40, 0x10, 0x14, 0x48, 0x00, 0x15, 0x08, 0x89,
+    0x40, 0x10, 0x16, 0x08, 0x9B, 0x87, 0x7B, 0x13, 0x08, 0x42, 0x45, 0x13, 0x00, 0x43, 0x13, 0x18,
+    0x1F, 0xC8, 0x1E, 0x44, 0x01, 0xD0, 0x40, 0x02, 0x00, 0x10, 0x1D, 0xD0, 0x48, 0x05, 0x04, 0x08,
+    0x00, 0x1E, 0x10, 0xA1, 0x02, 0x68, 0x87, 0x00, 0x10, 0x01, 0x0D, 0x04, 0x0A, 0xD0, 0xD6, 0x02,
+    0x21, 0x10, 0x1E, 0x00, 0xD0, 0x48, 0x03, 0x20, 0x10, 0x22, 0x90, 0x23, 0x09, 0x7C, 0x00, 0x23,
+    0x20, 0x04, 0x00, 0x3F, 0x90, 0x00, 0x08, 0x00, 0x22, 0x10, 0x00, 0x90, 0x3F, 0x90, 0x01, 0x08,
+    0x00, 0xD0, 0x10, 0x1B, 0x08, 0xDF, 0x87, 0x22, 0xC8, 0x00, 0x21, 0xC8, 0x48, 0x87, 0x21, 0x10,
+    0x05, 0xD0, 0x02, 0xE4, 0x30, 0x00, 0x04, 0xD0, 0x1F, 0x02, 0x4E, 0x87, 0x02, 0x20, 0xC6, 0x00,
+    0xD0, 0x4E, 0x05, 0x20, 0x10, 0x01, 0x50, 0x90, 0x20, 0x10, 0x55, 0x09, 0x08, 0x02, 0x09, 0x00,
+    0x53, 0x55, 0x09, 0x08, 0x03, 0x09, 0x00, 0x49, 0x09, 0x08, 0x04, 0x09, 0x00, 0x43, 0x03, 0x09,
+    0x00, 0xF0, 0x05, 0x01, 0x10, 0x1E, 0x08, 0x1F, 0x88, 0xEA, 0x48, 0x3A, 0x04, 0x47, 0x3A, 0x18,
+    0x41, 0x3A, 0x18, 0x4E, 0x0C, 0x3A, 0x04, 0x8A, 0x45, 0x30, 0x10, 0x02, 0x30, 0x00, 0x48, 0x87,
+    0x54, 0xD8, 0x08, 0x6A, 0x44, 0xD8, 0x00, 0x45, 0xD8, 0x00, 0x62, 0xD8, 0x08, 0x1D, 0x04, 0x48,
+    0x11, 0xC6, 0x10, 0x31, 0xD0, 0x92, 0x05, 0x00, 0x32, 0xD0, 0x96, 0x11, 0x05, 0x00, 0x33, 0xD0,
+    0x9A, 0x05, 0x00, 0x34, 0xD0, 0x9E, 0x11, 0x05, 0x00, 0x35, 0xD0, 0xA2, 0x05, 0x00, 0x36, 0xD0,
+    0xA6, 0x40, 0x02, 0x48, 0x87, 0x43, 0x10, 0xAA, 0x41, 0x00, 0xAA, 0x54, 0x87, 0x45, 0x03, 0x00,
+    0x46, 0x03, 0x00, 0x47, 0x03, 0x00, 0x41, 0xAD, 0x03, 0x00, 0x24, 0x71, 0x05, 0xEF, 0x00, 0xC8,
+    0x62, 0x01, 0xBC, 0x62, 0x09, 0x46, 0x24, 0xFF, 0x08, 0x05, 0x05, 0x01, 0x08, 0xCE, 0xFD, 0x08,
+    0x48, 0x00, 0x87, 0x2B, 0xC8, 0x2B, 0x10, 0x2C, 0xD0, 0x48, 0x44, 0x04, 0x2B, 0x93, 0x02, 0x57,
+    0xD0, 0xEE, 0x55, 0x00, 0x53, 0x04, 0xD0, 0xFC, 0x05, 0x00, 0x54, 0xD0, 0x0C, 0x02, 0x37, 0x00,
+    0x87, 0x28, 0x10, 0x3C, 0xD0, 0x37, 0x04, 0x28, 0x20, 0x10, 0x30, 0xD0, 0x28, 0x08, 0x0D, 0x08,
+    0x90, 0x3A, 0xA8, 0xD0, 0x37, 0x01, 0x0F, 0x00, 0x90, 0x0F, 0x04, 0x04, 0x71, 0x02, 0x02, 0x05,
+    0x81, 0x02, 0x33, 0x10, 0x90, 0x37, 0x02, 0x33, 0xAC, 0xC8, 0x04, 0xE0, 0x01, 0xCF, 0x05, 0x29,
+    0x6C, 0x08, 0x03, 0x0D, 0x10, 0x02, 0x37, 0x0D, 0x08, 0x29, 0x10, 0x2E, 0x90, 0x29, 0x08, 0x00,
+    0x2A, 0x10, 0x2F, 0x90, 0x2A, 0x08, 0x32, 0x88, 0x00, 0x29, 0x10, 0x3D, 0xD0, 0x61, 0x03, 0x02,
+    0x10, 0x20, 0x2D, 0x90, 0x26, 0x90, 0x2E, 0x0E, 0x03, 0x3D, 0x10, 0x82, 0x34, 0x1D, 0x00, 0x81,
+    0x10, 0x1C, 0x08, 0xF1, 0x29, 0x00, 0x40, 0x3D, 0x90, 0x39, 0xD0, 0x81, 0x06, 0x1D, 0x0C, 0x00,
+    0x25, 0x26, 0x03, 0x39, 0x2D, 0x00, 0x34, 0xD0, 0x1F, 0x14, 0x2A, 0x10, 0x88, 0x3E, 0xD0, 0x9B,
+    0x3B, 0x10, 0x2F, 0x08, 0x3E, 0x39, 0x00, 0x58, 0x2A, 0x08, 0xBB, 0x19, 0x14, 0x9E, 0x00, 0xBB,
+    0x39, 0x18, 0x2F, 0x0D, 0xEA, 0x02, 0x3E, 0x39, 0x00, 0x1F, 0x14, 0x29, 0x10, 0x27, 0xD0, 0x00,
+    0x3B, 0xD0, 0x3D, 0xD0, 0x17, 0x01, 0x2A, 0x10, 0x40, 0x28, 0xD0, 0xE3, 0x02, 0xD9, 0x04, 0x07,
+    0x04, 0x3C, 0x40, 0xD0, 0x3E, 0xD0, 0x17, 0x03, 0xE3, 0xDC, 0x00, 0x2A, 0x61, 0x0B, 0x0C, 0x01,
+    0x33, 0x90, 0xF5, 0x00, 0x01, 0xBD, 0x0C, 0x03, 0x35, 0xBD, 0x08, 0x01, 0x0D, 0x28, 0x32, 0xB6,
+    0x03, 0xB9, 0x0C, 0x27, 0x10, 0x10, 0x3B, 0x90, 0x3D, 0x90, 0xBB, 0x04, 0x00, 0x10, 0x80, 0x45,
+    0x54, 0x02, 0x35, 0xE1, 0x00, 0x10, 0x08, 0x90, 0x01, 0x2C, 0x29, 0x05, 0x18, 0x00, 0x36, 0x23,
+    0x05, 0x4C, 0x02, 0x32, 0x10, 0x90, 0x80, 0x46, 0x02, 0x31, 0x88, 0x5B, 0x87, 0x08, 0xA7, 0x03,
+    0x44, 0x5B, 0x87, 0x0E, 0x00, 0x57, 0x02, 0x10, 0x0A, 0x08, 0x18, 0x45, 0x05, 0x00, 0x31, 0x98,
+    0x0A, 0x37, 0x08, 0x28, 0x43, 0x3C, 0x27, 0x11, 0x18, 0x00, 0x38, 0x08, 0x35, 0x86, 0x00, 0x36,
+    0x10, 0x01, 0x41, 0x52, 0x01, 0x02, 0x08, 0x38, 0x10, 0x03, 0x3F, 0x02, 0x13, 0x00, 0x88, 0x13,
+    0x10, 0x11, 0xD0, 0x12, 0x20, 0x01, 0x20, 0x13, 0xC8, 0x90, 0x87, 0x14, 0xBD, 0x03, 0x90, 0x18,
+    0x44, 0x08, 0x17, 0x05, 0x00, 0x19, 0x08, 0x18, 0x2B, 0x00, 0x19, 0x2D, 0x2B, 0x00, 0xB6, 0xE7,
+    0x09, 0x03, 0x06, 0xC0, 0xBC, 0x08, 0x14, 0xC8, 0x00, 0x17, 0xC8, 0x15, 0x88, 0x10, 0x9B, 0x01,
+    0x17, 0x58, 0x88, 0x16, 0x20, 0x65, 0x02, 0xD8, 0x0C, 0xDC, 0x1B, 0x08, 0x1A, 0x00, 0x20, 0x87,
+    0x3F, 0x10, 0x00, 0xD0, 0xE9, 0x02, 0x00, 0x3F, 0x88, 0xEE, 0x87, 0xFF, 0x10, 0xD0, 0x3F, 0xA0,
+    0x08, 0x1B, 0x20, 0x87, 0x02, 0x22, 0x10, 0x1C, 0x22, 0x08
+};
+const uint16_t EXAMPLE_LOWER_SIZE = 1279;
+const uint8_t exampleLower[] = {
+    0x10, 0x88, 0x11, 0x88, 0x12, 0x88, 0x13, 0x88, 0x14, 0x88, 0x15, 0x88, 0x16, 0x88, 0x17, 0x88,
+    0x18, 0x88, 0x19, 0x88, 0x1A, 0x88, 0x1B, 0x88, 0x1C, 0x88, 0x1D, 0x88, 0x1E, 0x88, 0x1F, 0x88,
+    0x20, 0x88, 0x21, 0x88, 0x22, 0x88, 0x23, 0x88, 0x24, 0x88, 0x25, 0x88, 0x26, 0x88, 0x0A, 0x10,
+    0x27, 0x08, 0x32, 0x10, 0x28, 0x08, 0x64, 0x10, 0x29, 0x08, 0x32, 0x10, 0x2A, 0x08, 0x2B, 0x88,
+    0x0A, 0x10, 0x2C, 0x08, 0x2D, 0x88, 0x00, 0x10, 0x02, 0xD0, 0x2E, 0x08, 0x2F, 0xC8, 0x02, 0x10,
+    0x30, 0x08, 0x31, 0x88, 0x32, 0x88, 0x33, 0x88, 0x02, 0x10, 0x34, 0x08, 0x35, 0x88, 0x36, 0x88,
+    0x37, 0x88, 0x38, 0x88, 0xD2, 0x10, 0x39, 0x08, 0x80, 0x10, 0x3A, 0x08, 0x0C, 0x10, 0x3B, 0x08,
+    0x0D, 0x10, 0x3C, 0x08, 0x05, 0x10, 0x3D, 0x08, 0x0A, 0x10, 0x3E, 0x08, 0x3F, 0x88, 0x54, 0x10,
+    0x20, 0x08, 0x2C, 0x10, 0x40, 0x08, 0x0E, 0x10, 0x41, 0x08, 0x53, 0x10, 0x2C, 0x08, 0x45, 0x10,
+    0x2D, 0x08, 0x4C, 0x10, 0x2E, 0x08, 0x45, 0x10, 0x2F, 0x08, 0x43, 0x10, 0x30, 0x08, 0x54, 0x10,
+    0x31, 0x08, 0x20, 0x10, 0x32, 0x08, 0x41, 0x10, 0x33, 0x08, 0x43, 0x10, 0x34, 0x08, 0x54, 0x10,
+    0x35, 0x08, 0x49, 0x10, 0x36, 0x08, 0x4F, 0x10, 0x37, 0x08, 0x4E, 0x10, 0x38, 0x08, 0x3A, 0x10,
+    0x39, 0x08, 0x3A, 0x10, 0x42, 0x08, 0x0C, 0x10, 0x43, 0x08, 0x50, 0x10, 0x3A, 0x08, 0x52, 0x10,
+    0x3B, 0x08, 0x45, 0x10, 0x3C, 0x08, 0x53, 0x10, 0x3D, 0x08, 0x53, 0x10, 0x3E, 0x08, 0x20, 0x10,
+    0x3F, 0x08, 0x4E, 0x10, 0x40, 0x08, 0x55, 0x10, 0x41, 0x08, 0x4D, 0x10, 0x42, 0x08, 0x42, 0x10,
+    0x43, 0x08, 0x45, 0x10, 0x44, 0x08, 0x52, 0x10, 0x45, 0x08, 0x46, 0x10, 0x44, 0x08, 0x0E, 0x10,
+    0x45, 0x08, 0x49, 0x10, 0x46, 0x08, 0x4E, 0x10, 0x47, 0x08, 0x56, 0x10, 0x48, 0x08, 0x41, 0x10,
+    0x49, 0x08, 0x4C, 0x10, 0x4A, 0x08, 0x49, 0x10, 0x4B, 0x08, 0x44, 0x10, 0x4C, 0x08, 0x20, 0x10,
+    0x4D, 0x08, 0x41, 0x10, 0x4E, 0x08, 0x43, 0x10, 0x4F, 0x08, 0x54, 0x10, 0x50, 0x08, 0x49, 0x10,
+    0x51, 0x08, 0x4F, 0x10, 0x52, 0x08, 0x4E, 0x10, 0x53, 0x08, 0x00, 0x10, 0x00, 0x08, 0x98, 0x10,
+    0x11, 0x08, 0x48, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x25, 0xC8, 0x10, 0x03, 0x10, 0x26, 0x08, 0x64,
+    0x10, 0x11, 0x08, 0x59, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x1F, 0x10, 0x8B, 0x01, 0x1E, 0x10, 0x75,
+    0x01, 0x67, 0x10, 0x1A, 0x08, 0xCE, 0x87, 0x40, 0x10, 0x14, 0x08, 0x41, 0x10, 0x15, 0x08, 0x89,
+    0x10, 0x16, 0x08, 0x9B, 0x87, 0x7B, 0x10, 0x1A, 0x08, 0xCE, 0x87, 0x42, 0x10, 0x14, 0x08, 0x43,
+    0x10, 0x15, 0x08, 0x89, 0x10, 0x16, 0x08, 0x9B, 0x87, 0x1F, 0xC8, 0x1E, 0x10, 0x02, 0xD0, 0xD0,
+    0x02, 0x00, 0x10, 0x1D, 0xD0, 0x48, 0x02, 0x00, 0x10, 0x1D, 0x08, 0x1E, 0x10, 0xA1, 0x02, 0x68,
+    0x87, 0x00, 0x10, 0x48, 0x02, 0x00, 0x10, 0x0A, 0xD0, 0xD6, 0x02, 0x21, 0x10, 0x1E, 0xD0, 0x48,
+    0x03, 0x20, 0x10, 0x22, 0x90, 0x23, 0x08, 0x00, 0x10, 0x23, 0x20, 0x08, 0x00, 0x10, 0x3F, 0x90,
+    0x00, 0x08, 0x22, 0x10, 0x00, 0x90, 0x3F, 0x90, 0x01, 0x08, 0xD0, 0x10, 0x1B, 0x08, 0xDF, 0x87,
+    0x22, 0xC8, 0x21, 0xC8, 0x48, 0x87, 0x21, 0x10, 0x05, 0xD0, 0xE4, 0x02, 0x21, 0x10, 0x04, 0xD0,
+    0x1F, 0x02, 0x4E, 0x87, 0x20, 0x20, 0x10, 0x4D, 0xD0, 0x4E, 0x05, 0x20, 0x10, 0x01, 0x90, 0x20,
+    0x10, 0x55, 0xD0, 0x4E, 0x05, 0x20, 0x10, 0x02, 0x90, 0x20, 0x10, 0x53, 0xD0, 0x4E, 0x05, 0x20,
+    0x10, 0x03, 0x90, 0x20, 0x10, 0x49, 0xD0, 0x4E, 0x05, 0x20, 0x10, 0x04, 0x90, 0x20, 0x10, 0x43,
+    0xD0, 0x4E, 0x05, 0x21, 0x88, 0x22, 0x88, 0x01, 0x10, 0x1E, 0x08, 0x1F, 0x88, 0x48, 0x87, 0x20,
+    0x20, 0x10, 0x47, 0xD0, 0x4E, 0x05, 0x20, 0x10, 0x01, 0x90, 0x20, 0x10, 0x41, 0xD0, 0x4E, 0x05,
+    0x20, 0x10, 0x02, 0x90, 0x20, 0x10, 0x4D, 0xD0, 0x4E, 0x05, 0x20, 0x10, 0x03, 0x90, 0x20, 0x10,
+    0x45, 0xD0, 0x4E, 0x05, 0x21, 0x88, 0x22, 0x88, 0x02, 0x10, 0x1E, 0x08, 0x48, 0x87, 0x54, 0x10,
+    0x1A, 0x08, 0xCE, 0x87, 0x44, 0x10, 0x14, 0x08, 0x45, 0x10, 0x15, 0x08, 0x62, 0x10, 0x16, 0x08,
+    0x9B, 0x87, 0x21, 0x88, 0x22, 0x88, 0x48, 0x87, 0x00, 0x10, 0x48, 0x02, 0x00, 0x10, 0x31, 0xD0,
+    0x92, 0x02, 0x00, 0x10, 0x32, 0xD0, 0x96, 0x02, 0x00, 0x10, 0x33, 0xD0, 0x9A, 0x02, 0x00, 0x10,
+    0x34, 0xD0, 0x9E, 0x02, 0x00, 0x10, 0x35, 0xD0, 0xA2, 0x02, 0x00, 0x10, 0x36, 0xD0, 0xA6, 0x02,
+    0x48, 0x87, 0x43, 0x10, 0xAA, 0x87, 0x44, 0x10, 0xAA, 0x87, 0x45, 0x10, 0xAA, 0x87, 0x46, 0x10,
+    0xAA, 0x87, 0x47, 0x10, 0xAA, 0x87, 0x41, 0x10, 0xAA, 0x87, 0x24, 0x08, 0x00, 0x10, 0x00, 0x90,
+    0x00, 0x08, 0xC8, 0x10, 0x11, 0x08, 0xBC, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x24, 0x10, 0x3F, 0x90,
+    0x00, 0x08, 0x00, 0x10, 0x3F, 0x90, 0x01, 0x08, 0xCE, 0x10, 0x1B, 0x08, 0xDF, 0x87, 0x48, 0x87,
+    0x2B, 0xC8, 0x2B, 0x10, 0x2C, 0xD0, 0x48, 0x04, 0x2B, 0x88, 0x00, 0x10, 0x57, 0xD0, 0xEE, 0x02,
+    0x00, 0x10, 0x53, 0xD0, 0xFC, 0x02, 0x00, 0x10, 0x54, 0xD0, 0x0C, 0x02, 0x37, 0x87, 0x28, 0x10,
+    0x3C, 0xD0, 0x37, 0x04, 0x28, 0x10, 0x30, 0xD0, 0x28, 0x08, 0x37, 0x87, 0x28, 0x10, 0x3C, 0x90,
+    0x3A, 0xD0, 0x37, 0x01, 0x28, 0x10, 0x30, 0x90, 0x28, 0x08, 0x37, 0x87, 0x04, 0x10, 0x30, 0x08,
+    0x05, 0x10, 0x2D, 0x08, 0x33, 0x10, 0x90, 0x37, 0x02, 0x33, 0xC8, 0x04, 0x10, 0x00, 0x08, 0x64,
+    0x10, 0x11, 0x08, 0x29, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x03, 0x10, 0x00, 0x08, 0x64, 0x10, 0x11,
+    0x08, 0x37, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x29, 0x10, 0x2E, 0x90, 0x29, 0x08, 0x2A, 0x10, 0x2F,
+    0x90, 0x2A, 0x08, 0x32, 0x88, 0x29, 0x10, 0x3D, 0xD0, 0x61, 0x03, 0x02, 0x10, 0x2D, 0x90, 0x26,
+    0x90, 0x2E, 0x08, 0x2D, 0x88, 0x3D, 0x10, 0x34, 0x90, 0x29, 0x08, 0x81, 0x10, 0x1C, 0x08, 0xF1,
+    0x87, 0x29, 0x10, 0x3D, 0x90, 0x39, 0xD0, 0x81, 0x06, 0x02, 0x10, 0x2D, 0x90, 0x26, 0x90, 0x00,
+    0xD0, 0x2E, 0x08, 0x39, 0x10, 0x3D, 0xD0, 0x34, 0xD0, 0x29, 0x08, 0x81, 0x10, 0x1C, 0x08, 0xF1,
+    0x87, 0x2A, 0x10, 0x3E, 0xD0, 0x9B, 0x03, 0x02, 0x10, 0x2D, 0x90, 0x26, 0x90, 0x2F, 0x08, 0x3E,
+    0x10, 0x34, 0x90, 0x2A, 0x08, 0xBB, 0x10, 0x1C, 0x08, 0xF1, 0x87, 0x2A, 0x10, 0x3E, 0x90, 0x3A,
+    0xD0, 0xBB, 0x06, 0x02, 0x10, 0x2D, 0x90, 0x26, 0x90, 0x00, 0xD0, 0x2F, 0x08, 0x3A, 0x10, 0x3E,
+    0xD0, 0x34, 0xD0, 0x2A, 0x08, 0xBB, 0x10, 0x1C, 0x08, 0xF1, 0x87, 0x29, 0x10, 0x27, 0xD0, 0x3B,
+    0xD0, 0x3D, 0xD0, 0x17, 0x01, 0x2A, 0x10, 0x28, 0xD0, 0xE3, 0x02, 0xD9, 0x04, 0x2A, 0x10, 0x28,
+    0xD0, 0x3C, 0xD0, 0x3E, 0xD0, 0x17, 0x03, 0xE3, 0x87, 0x28, 0x10, 0x2A, 0xD0, 0x3C, 0xD0, 0x3E,
+    0xD0, 0x17, 0x01, 0x33, 0x90, 0xF5, 0x02, 0x00, 0x10, 0x00, 0x08, 0x64, 0x10, 0x11, 0x08, 0x03,
+    0x10, 0x12, 0x08, 0x8E, 0x87, 0x01, 0x10, 0x00, 0x08, 0x64, 0x10, 0x11, 0x08, 0x03, 0x10, 0x12,
+    0x08, 0x8E, 0x87, 0x32, 0xC8, 0x02, 0x10, 0x2D, 0x90, 0x26, 0x90, 0x2E, 0x08, 0x27, 0x10, 0x3B,
+    0x90, 0x3D, 0x90, 0x34, 0x90, 0x29, 0x08, 0x00, 0x10, 0x80, 0x90, 0x3F, 0x90, 0x35, 0x08, 0x2A,
+    0x10, 0x10, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90,
+    0x08, 0x90, 0x29, 0x90, 0x3F, 0x90, 0x36, 0x08, 0x33, 0x10, 0x90, 0x4C, 0x02, 0x32, 0x10, 0x90,
+    0x46, 0x02, 0x31, 0x88, 0x5B, 0x87, 0x08, 0x10, 0x31, 0x08, 0x5B, 0x87, 0x32, 0x10, 0x90, 0x57,
+    0x02, 0x10, 0x10, 0x31, 0x08, 0x5B, 0x87, 0x18, 0x10, 0x31, 0x08, 0x31, 0x10, 0x00, 0x90, 0x3F,
+    0x90, 0x37, 0x08, 0x28, 0x10, 0x10, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x08, 0x90,
+    0x08, 0x90, 0x08, 0x90, 0x08, 0x90, 0x27, 0x90, 0x3F, 0x90, 0x38, 0x08, 0x35, 0x10, 0x00, 0x08,
+    0x36, 0x10, 0x01, 0x08, 0x37, 0x10, 0x02, 0x08, 0x38, 0x10, 0x03, 0x08, 0x48, 0x87, 0x13, 0x88,
+    0x13, 0x10, 0x11, 0xD0, 0x12, 0x20, 0x01, 0x13, 0xC8, 0x90, 0x87, 0x14, 0x20, 0x10, 0x3F, 0x90,
+    0x18, 0x08, 0x17, 0x10, 0x3F, 0x90, 0x19, 0x08, 0x18, 0x10, 0x00, 0x08, 0x19, 0x10, 0x01, 0x08,
+    0xB6, 0x10, 0x1B, 0x08, 0xDF, 0x87, 0xC8, 0x10, 0x11, 0x08, 0xC0, 0x10, 0x12, 0x08, 0x8E, 0x87,
+    0x14, 0xC8, 0x17, 0xC8, 0x15, 0x88, 0x10, 0x9B, 0x01, 0x17, 0x88, 0x16, 0x20, 0x87, 0x00, 0x10,
+    0x00, 0x08, 0x64, 0x10, 0x11, 0x08, 0xDC, 0x10, 0x12, 0x08, 0x8E, 0x87, 0x1A, 0x20, 0x87, 0x3F,
+    0x10, 0x00, 0xD0, 0xE9, 0x02, 0x3F, 0x88, 0xEE, 0x87, 0xFF, 0x10, 0xD0, 0x3F, 0x08, 0x1B, 0x20,
+    0x87, 0x02, 0x10, 0x00, 0x08, 0x64, 0x10, 0x11, 0x08, 0x1C, 0x10, 0x12, 0x08, 0x8E, 0x87
+};
+
+// game-and-music.hack, upper byte lane
+// 1279 bytes compressed to 401 (3.19:1)
+const uint8_t exampleUpperCompressed[] = {
+    0xC4, 0x00, 0xEA, 0x01, 0xA8, 0xEC, 0x00, 0xE3, 0x03, 0x28, 0x11, 0x0C, 0xF5, 0x05, 0x04, 0xE4,
+    0x07, 0x00, 0xEF, 0x0D, 0x10, 0x29, 0x14, 0x35, 0x54, 0x3D, 0x18, 0xEE, 0x01, 0x05, 0x00, 0x03,
+    0x04, 0x11, 0x0C, 0x01, 0x03, 0xC8, 0x3F, 0xD4, 0x77, 0xF4, 0x20, 0x18, 0xEC, 0x40, 0xE3, 0x3A,
+    0xBF, 0x10, 0x04, 0xEA, 0x60, 0x00, 0xFD, 0xFC, 0x00, 0xE0, 0x50, 0x0C, 0x10, 0x10, 0xFC, 0xFF,
+    0x26, 0x00, 0x03, 0x00, 0x0D, 0x14, 0x1B, 0x00, 0x03, 0x00, 0x0D, 0x0C, 0x13, 0x44, 0x3C, 0x01,
+    0x00, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC, 0x00, 0x8C, 0xF4, 0x01, 0x05, 0x04, 0x3D, 0x08,
+    0x02, 0xEA, 0x50, 0x05, 0x00, 0x4D, 0x0D, 0x00, 0xE4, 0x4D, 0x04, 0x05, 0x10, 0xF0, 0x00, 0x11,
+    0x04, 0xFC, 0x69, 0x04, 0x04, 0xF0, 0x40, 0x26, 0x04, 0xE0, 0x07, 0x04, 0x87, 0x14, 0x00, 0x2C,
+    0xFD, 0x01, 0x5A, 0x04, 0x30, 0x10, 0x02, 0x42, 0x00, 0x00, 0xFC, 0xF3, 0x08, 0x08, 0x0E, 0x00,
+    0xE0, 0xE3, 0x09, 0x84, 0xBE, 0x19, 0x48, 0x04, 0x30, 0xA0, 0xB8, 0x01, 0xEA, 0x02, 0xD8, 0x28,
+    0x0D, 0x10, 0x01, 0x00, 0x01, 0xC6, 0x18, 0x37, 0xE0, 0x08, 0x05, 0x60, 0x72, 0x00, 0xEC, 0xB1,
+    0x00, 0x03, 0x44, 0xE3, 0x0F, 0xFC, 0xEC, 0x50, 0xEF, 0x04, 0x55, 0x00, 0x67, 0x18, 0xF7, 0x0C,
+    0x05, 0x00, 0x11, 0x0C, 0x6D, 0x3D, 0x00, 0xFD, 0x15, 0x00, 0x40, 0x01, 0x00, 0x71, 0x00, 0x5B,
+    0x2C, 0x03, 0x24, 0xE3, 0x03, 0x31, 0x04, 0xF4, 0x03, 0x9B, 0x04, 0xF4, 0x00, 0x3D, 0x0D, 0x0C,
+    0xF0, 0x0F, 0x10, 0x52, 0x01, 0x0F, 0x00, 0x11, 0x16, 0xFC, 0xE3, 0x59, 0x14, 0x00, 0xEF, 0x0C,
+    0xE0, 0x01, 0x0E, 0x04, 0x03, 0x5A, 0x08, 0x0F, 0xFF, 0x0D, 0x28, 0x32, 0x0C, 0x05, 0x10, 0x56,
+    0x14, 0x88, 0x00, 0x0F, 0x18, 0x50, 0x04, 0x29, 0x1C, 0xF5, 0x1D, 0x1C, 0xE1, 0x35, 0x08, 0xF4,
+    0x80, 0x08, 0x1F, 0x14, 0x3B, 0x24, 0x39, 0xB0, 0xFD, 0x01, 0x04, 0x04, 0x17, 0x08, 0xDE, 0x00,
+    0x1F, 0x14, 0x11, 0x00, 0xEA, 0x0C, 0x1D, 0x14, 0xF6, 0x03, 0x3A, 0x01, 0xBD, 0x0C, 0x04, 0xCB,
+    0x28, 0x0D, 0x0C, 0xB6, 0x0B, 0x7D, 0x1C, 0x99, 0x09, 0x08, 0x20, 0xEC, 0xCD, 0x02, 0x11, 0x0C,
+    0xE3, 0xF0, 0x01, 0x2C, 0xED, 0x2A, 0x14, 0xE3, 0x59, 0x04, 0x04, 0x04, 0xEA, 0x42, 0x00, 0x90,
+    0x10, 0x0E, 0x04, 0xFB, 0x0A, 0x0C, 0x46, 0x09, 0x20, 0x43, 0x74, 0xBD, 0x06, 0x03, 0x1C, 0xBD,
+    0x01, 0xB6, 0x0C, 0xF0, 0xFC, 0xE3, 0x00, 0xFD, 0x4E, 0x04, 0x64, 0x25, 0x23, 0x10, 0xB2, 0x10,
+    0x0F, 0xBC, 0x1C, 0xEF, 0x02, 0x28, 0x00, 0x86, 0x04, 0x00, 0xFC, 0xEA, 0x10, 0x8D, 0xD8, 0x2C,
+    0xFC, 0x08, 0x0B, 0xA2, 0x0C, 0x7F, 0xEC, 0xE7, 0x45, 0x04, 0x03, 0xFB, 0x18, 0x95, 0x04, 0x04,
+    0xEA
+};
+const uint16_t EXAMPLE_UPPER_SIZE = 1279;
+const uint8_t exampleUpper[] = {
+    0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA,
+    0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA,
+    0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEC,
+    0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEA,
+    0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEA, 0x00, 0xEC, 0x00, 0xE4, 0x00, 0xE3, 0x00, 0xEF, 0x00, 0xEC,
+    0x00, 0xE3, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEA, 0x00, 0xEA,
+    0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3,
+    0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEA, 0x01, 0xEC,
+    0x00, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x00, 0xEC,
+    0x00, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC,
+    0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x00, 0xEC, 0x01, 0xE3, 0x18, 0xEC, 0x40, 0xE3, 0x3A, 0xEC,
+    0x00, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFD, 0xFC, 0x00, 0xE0, 0x00, 0xE3, 0x00,
+    0xEC, 0x00, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x01, 0xE3, 0x00, 0xFC, 0x01,
+    0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xE3, 0x00, 0xFC, 0x00, 0xE3, 0x01,
+    0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xE3, 0x00,
+    0xFC, 0x00, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xEF, 0x00, 0xFC, 0x00, 0xE4, 0x02,
+    0xE3, 0x50, 0xFC, 0x00, 0xF4, 0x01, 0xE3, 0x50, 0xFC, 0x00, 0xE3, 0x00, 0xFC, 0x01, 0xE3, 0x02,
+    0xEA, 0x50, 0xFC, 0x01, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x01, 0xE3, 0x00, 0xFC, 0x00, 0xE4, 0x01,
+    0xE3, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x50, 0xFC, 0x00, 0xFC, 0xE3, 0x50, 0xFC, 0x00, 0xF0,
+    0x40, 0xE3, 0x00, 0xFC, 0x01, 0xE0, 0x00, 0xF0, 0x40, 0xE3, 0x01, 0xEC, 0x00, 0xE3, 0x04, 0xEA,
+    0x00, 0xFD, 0x00, 0xFD, 0x01, 0xEA, 0x00, 0xFC, 0x00, 0xE4, 0x01, 0xE3, 0x00, 0xFC, 0x00, 0xE4,
+    0x02, 0xE3, 0x02, 0xEA, 0x00, 0xFC, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00, 0xFC, 0x00, 0xE0, 0xE3,
+    0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00, 0xFC, 0x00, 0xE0, 0xE3, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00,
+    0xFC, 0x00, 0xE0, 0xE3, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00, 0xFC, 0x00, 0xE0, 0xE3, 0xFC, 0x00,
+    0xE4, 0x02, 0xE3, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xEA, 0x01, 0xEA, 0x00,
+    0xFC, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00, 0xFC, 0x00, 0xE0, 0xE3, 0xFC, 0x00, 0xE4, 0x02, 0xE3,
+    0x00, 0xFC, 0x00, 0xE0, 0xE3, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x00, 0xFC, 0x00, 0xE0, 0xE3, 0xFC,
+    0x00, 0xE4, 0x02, 0xE3, 0x00, 0xEA, 0x00, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x01, 0xEA, 0x02, 0xEC,
+    0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xE3, 0x00, 0xFC, 0x00, 0xE3, 0x02, 0xEC, 0x00, 0xE3,
+    0x04, 0xEA, 0x00, 0xEA, 0x00, 0xEA, 0x01, 0xEA, 0x50, 0xFC, 0x01, 0xE3, 0x50, 0xFC, 0x00, 0xE4,
+    0x02, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC,
+    0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3,
+    0x01, 0xEA, 0x00, 0xEC, 0x02, 0xEA, 0x00, 0xEC, 0x02, 0xEA, 0x00, 0xEC, 0x02, 0xEA, 0x00, 0xEC,
+    0x02, 0xEA, 0x00, 0xEC, 0x02, 0xEA, 0x00, 0xEC, 0x02, 0xEA, 0x00, 0xE3, 0x0F, 0xEC, 0x50, 0xF0,
+    0x40, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x02, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xF0,
+    0x40, 0xE3, 0x01, 0xEC, 0x00, 0xF0, 0x40, 0xE3, 0x02, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x01, 0xEA,
+    0x00, 0xFD, 0x00, 0xFC, 0x00, 0xF4, 0x01, 0xE3, 0x00, 0xEA, 0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3,
+    0x50, 0xFC, 0x00, 0xE4, 0x02, 0xE3, 0x50, 0xFC, 0x00, 0xE4, 0x03, 0xE3, 0x03, 0xEA, 0x00, 0xFC,
+    0x00, 0xF4, 0x03, 0xE3, 0x00, 0xFC, 0x00, 0xF4, 0x00, 0xE3, 0x03, 0xEA, 0x00, 0xFC, 0x00, 0xF0,
+    0x00, 0xF4, 0x03, 0xE3, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x03, 0xEA, 0x00, 0xEC, 0x00, 0xE3,
+    0x00, 0xEC, 0x00, 0xE3, 0x00, 0xFC, 0xE3, 0x03, 0xE3, 0x00, 0xEF, 0x0C, 0xEC, 0x40, 0xE3, 0x00,
+    0xEC, 0x00, 0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x0F, 0xEC, 0x40, 0xE3, 0x00, 0xEC, 0x00,
+    0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x00, 0xFC, 0x00,
+    0xF0, 0x00, 0xE3, 0x00, 0xEA, 0x00, 0xFC, 0x00, 0xF4, 0x03, 0xE3, 0x00, 0xEC, 0x00, 0xF0, 0x00,
+    0xF0, 0x00, 0xE3, 0x00, 0xEA, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04,
+    0xEA, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xF4, 0x03, 0xE3, 0x00, 0xEC, 0x00, 0xF0, 0x00, 0xF0, 0x00,
+    0xE1, 0x00, 0xE3, 0x00, 0xFC, 0x00, 0xF4, 0x00, 0xF4, 0x00, 0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04,
+    0xEA, 0x00, 0xFC, 0x00, 0xF4, 0x03, 0xE3, 0x00, 0xEC, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE3, 0x00,
+    0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xF0, 0x00,
+    0xF4, 0x03, 0xE3, 0x00, 0xEC, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE1, 0x00, 0xE3, 0x00, 0xFC, 0x00,
+    0xF4, 0x00, 0xF4, 0x00, 0xE3, 0x03, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0x00, 0xF4, 0x00,
+    0xF4, 0x00, 0xF4, 0x04, 0xE3, 0x00, 0xFC, 0x00, 0xF4, 0x03, 0xE3, 0x03, 0xE3, 0x00, 0xFC, 0x00,
+    0xF4, 0x00, 0xF4, 0x00, 0xF4, 0x04, 0xE3, 0x03, 0xEA, 0x00, 0xFC, 0x00, 0xF4, 0x00, 0xF4, 0x00,
+    0xF4, 0x04, 0xE3, 0x00, 0xFC, 0x03, 0xE3, 0x0F, 0xEC, 0x40, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x04,
+    0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x0F, 0xEC, 0x40, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x04, 0xEC, 0x00,
+    0xE3, 0x04, 0xEA, 0x00, 0xEF, 0x00, 0xEC, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE3, 0x00, 0xFC, 0x00,
+    0xF0, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE3, 0x20, 0xEC, 0x00, 0xE0, 0x00, 0xF0, 0x00, 0xE3, 0x00,
+    0xFC, 0x00, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0,
+    0xE3, 0xF0, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE3, 0x00, 0xFC, 0xE3, 0x04, 0xE3, 0x00, 0xFC, 0xE3,
+    0x04, 0xE3, 0x00, 0xEA, 0x04, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0xE3, 0x04,
+    0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xFC, 0x20, 0xE0, 0x00,
+    0xF0, 0x00, 0xE3, 0x00, 0xFC, 0x00, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0,
+    0xE3, 0xF0, 0xE3, 0xF0, 0xE3, 0xF0, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0xE3, 0x00, 0xFC, 0x40, 0xE3,
+    0x00, 0xFC, 0x40, 0xE3, 0x00, 0xFC, 0x40, 0xE3, 0x00, 0xFC, 0x40, 0xE3, 0x01, 0xEA, 0x00, 0xEA,
+    0x00, 0xFC, 0x00, 0xF4, 0x00, 0xFC, 0xE3, 0x00, 0xFD, 0x04, 0xEA, 0x00, 0xFC, 0xFC, 0x00, 0xF0,
+    0x00, 0xE3, 0x00, 0xFC, 0x00, 0xF0, 0x00, 0xE3, 0x00, 0xFC, 0x40, 0xE3, 0x00, 0xFC, 0x40, 0xE3,
+    0x04, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xEC, 0x00, 0xE3, 0x04, 0xEC, 0x00, 0xE3, 0x04, 0xEA,
+    0x00, 0xFD, 0x00, 0xFD, 0x00, 0xFC, 0xFC, 0x04, 0xE3, 0x00, 0xEA, 0x00, 0xFC, 0xEA, 0x10, 0xEC,
+    0x40, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x04, 0xEC, 0x00, 0xE3, 0x04, 0xEA, 0x00, 0xFC, 0xEA, 0x00,
+    0xFC, 0x00, 0xE4, 0x04, 0xE3, 0x00, 0xEA, 0x04, 0xEA, 0x7F, 0xEC, 0xE7, 0x00, 0xE3, 0x00, 0xFC,
+    0xEA, 0x0F, 0xEC, 0x40, 0xE3, 0x00, 0xEC, 0x00, 0xE3, 0x00, 0xFC, 0x00, 0xE3, 0x04, 0xEA
+};
+
+#endif // EXAMPLE_IMAGE_H
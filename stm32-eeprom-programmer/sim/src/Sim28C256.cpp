@@ -0,0 +1,313 @@
+#include "Sim28C256.h"
+
+#include <string.h>
+
+namespace
+{
+  const uint16_t SDP_ADDRESS_1 = 0x5555;
+  const uint16_t SDP_ADDRESS_2 = 0x2AAA;
+  const uint16_t PAGE_MASK = Sim28C256::PAGE_SIZE - 1;
+}
+
+Sim28C256::Sim28C256()
+{
+  memset(&stats, 0, sizeof(stats));
+  memset(memory, 0xFF, sizeof(memory));
+
+  address = 0;
+  dataIn = 0xFF;
+  ce = oe = we = true;
+  addressChangedNs = dataChangedNs = ceFellNs = oeFellNs = weFellNs = 0;
+  latchedAddress = 0;
+  lastOutput = 0xFF;
+
+  sdpEnabled = false;
+  sdpUnlocked = false;
+  command = COMMAND_NONE;
+  pageOpen = false;
+  pageBase = 0;
+  pageMask = 0;
+  pageBlocked = false;
+  lastLoadNs = 0;
+  lastLoadedData = 0xFF;
+  busy = false;
+  commitOnDone = false;
+  eraseOnDone = false;
+  busyUntilNs = 0;
+  toggleBit = false;
+}
+
+void Sim28C256::setTiming(const Timing &newTiming)
+{
+  timing = newTiming;
+}
+
+const Sim28C256::Timing &Sim28C256::getTiming() const
+{
+  return timing;
+}
+
+void Sim28C256::setPins(uint64_t nowNs, uint16_t newAddress, uint8_t data, bool newCe, bool newOe, bool newWe)
+{
+  update(nowNs);
+
+  newAddress &= SIZE - 1;
+  if (newAddress != address)
+  {
+    addressChangedNs = nowNs;
+  }
+  if (data != dataIn)
+  {
+    dataChangedNs = nowNs;
+  }
+  if (ce && !newCe)
+  {
+    ceFellNs = nowNs;
+  }
+  if (oe && !newOe)
+  {
+    oeFellNs = nowNs;
+  }
+  if ((ce || oe) && !newCe && !newOe && (busy || pageOpen))
+  {
+    toggleBit = !toggleBit; // I/O6 toggles on every read during the write cycle
+  }
+
+  // Address is latched on the later falling edge of CE or WE, data on the
+  // first rising edge; OE must be high for a write
+  bool writeSelect = !newCe && !newWe;
+  bool wasWriteSelect = !ce && !we;
+  if (writeSelect && !wasWriteSelect)
+  {
+    weFellNs = nowNs;
+    latchedAddress = newAddress;
+    if (nowNs - addressChangedNs < timing.addressSetupNs)
+    {
+      stats.timingViolations++;
+    }
+  }
+
+  address = newAddress;
+  dataIn = data;
+
+  if (wasWriteSelect && !writeSelect && oe && newOe)
+  {
+    if (nowNs - weFellNs < timing.writePulseNs || nowNs - dataChangedNs < timing.dataSetupNs)
+    {
+      stats.timingViolations++;
+    }
+    load(nowNs, latchedAddress, data);
+  }
+
+  ce = newCe;
+  oe = newOe;
+  we = newWe;
+}
+
+bool Sim28C256::outputEnabled() const
+{
+  return !ce && !oe && we;
+}
+
+uint8_t Sim28C256::readOutput(uint64_t nowNs)
+{
+  update(nowNs);
+
+  if (busy || pageOpen)
+  {
+    // DATA#: I/O7 is the complement of the last byte loaded, I/O6 toggles.
+    // Polling already reports busy while the page is still open for loads.
+    stats.statusReads++;
+    lastOutput = (uint8_t)((~lastLoadedData & 0x80) | (toggleBit ? 0x40 : 0x00) | (lastLoadedData & 0x3F));
+    return lastOutput;
+  }
+
+  uint64_t accessStart = addressChangedNs > ceFellNs ? addressChangedNs : ceFellNs;
+  if (nowNs - accessStart < timing.accessNs || nowNs - oeFellNs < timing.outputEnableNs)
+  {
+    // Outputs still carry the previous value
+    stats.earlyReads++;
+    return lastOutput;
+  }
+
+  lastOutput = memory[address];
+  return lastOutput;
+}
+
+void Sim28C256::update(uint64_t nowNs)
+{
+  if (pageOpen && nowNs - lastLoadNs > timing.byteLoadNs)
+  {
+    if (pageBlocked)
+    {
+      stats.blockedWrites++;
+    }
+    startWriteCycle(lastLoadNs + timing.byteLoadNs, !pageBlocked);
+  }
+
+  if (busy && nowNs >= busyUntilNs)
+  {
+    busy = false;
+    if (eraseOnDone)
+    {
+      memset(memory, 0xFF, sizeof(memory));
+      eraseOnDone = false;
+    }
+    if (commitOnDone)
+    {
+      for (uint16_t i = 0; i < PAGE_SIZE; i++)
+      {
+        if (pageMask & (1ULL << i))
+        {
+          memory[pageBase + i] = pageData[i];
+        }
+      }
+    }
+    pageMask = 0;
+  }
+}
+
+bool Sim28C256::isBusy(uint64_t nowNs)
+{
+  update(nowNs);
+  return busy || pageOpen;
+}
+
+bool Sim28C256::isSdpEnabled() const
+{
+  return sdpEnabled;
+}
+
+void Sim28C256::setSdpEnabled(bool enabled)
+{
+  sdpEnabled = enabled;
+}
+
+uint8_t *Sim28C256::contents()
+{
+  return memory;
+}
+
+const Sim28C256::Stats &Sim28C256::getStats() const
+{
+  return stats;
+}
+
+void Sim28C256::resetStats()
+{
+  memset(&stats, 0, sizeof(stats));
+}
+
+void Sim28C256::load(uint64_t nowNs, uint16_t loadAddress, uint8_t data)
+{
+  if (busy)
+  {
+    stats.loadsWhileBusy++;
+    return;
+  }
+
+  if (!pageOpen && takeCommand(nowNs, loadAddress, data))
+  {
+    return;
+  }
+
+  if (!pageOpen)
+  {
+    // The first byte selects the page (A6-A14)
+    pageOpen = true;
+    pageBase = loadAddress & ~PAGE_MASK;
+    pageMask = 0;
+    pageBlocked = sdpEnabled && !sdpUnlocked;
+    sdpUnlocked = false;
+  }
+  else if ((loadAddress & ~PAGE_MASK) != pageBase)
+  {
+    stats.pageViolations++;
+    return;
+  }
+
+  pageData[loadAddress & PAGE_MASK] = data;
+  pageMask |= 1ULL << (loadAddress & PAGE_MASK);
+  lastLoadNs = nowNs;
+  lastLoadedData = data;
+  stats.bytesLoaded++;
+}
+
+bool Sim28C256::takeCommand(uint64_t nowNs, uint16_t loadAddress, uint8_t data)
+{
+  // Command bytes are consumed; a broken sequence is dropped and the byte
+  // is treated as data
+  switch (command)
+  {
+  case COMMAND_NONE:
+  case COMMAND_AA_55_80:
+    if (loadAddress == SDP_ADDRESS_1 && data == 0xAA)
+    {
+      command = command == COMMAND_NONE ? COMMAND_AA : COMMAND_AA_55_80_AA;
+      return true;
+    }
+    break;
+
+  case COMMAND_AA:
+  case COMMAND_AA_55_80_AA:
+    if (loadAddress == SDP_ADDRESS_2 && data == 0x55)
+    {
+      command = command == COMMAND_AA ? COMMAND_AA_55 : COMMAND_AA_55_80_AA_55;
+      return true;
+    }
+    break;
+
+  case COMMAND_AA_55:
+    if (loadAddress == SDP_ADDRESS_1 && data == 0xA0)
+    {
+      // Protection on; the page that follows is written
+      command = COMMAND_NONE;
+      sdpEnabled = true;
+      sdpUnlocked = true;
+      return true;
+    }
+    if (loadAddress == SDP_ADDRESS_1 && data == 0x80)
+    {
+      command = COMMAND_AA_55_80;
+      return true;
+    }
+    break;
+
+  case COMMAND_AA_55_80_AA_55:
+    if (loadAddress == SDP_ADDRESS_1 && data == 0x20)
+    {
+      // Disabling protection takes a write cycle
+      command = COMMAND_NONE;
+      sdpEnabled = false;
+      lastLoadedData = data;
+      pageMask = 0;
+      startWriteCycle(nowNs, false);
+      return true;
+    }
+    if (loadAddress == SDP_ADDRESS_1 && data == 0x10)
+    {
+      // Chip erase; works whether protection is on or not
+      command = COMMAND_NONE;
+      lastLoadedData = data;
+      pageMask = 0;
+      startWriteCycle(nowNs, false);
+      busyUntilNs = nowNs + timing.chipEraseNs;
+      eraseOnDone = true;
+      stats.chipErases++;
+      return true;
+    }
+    break;
+  }
+
+  command = COMMAND_NONE;
+  return false;
+}
+
+void Sim28C256::startWriteCycle(uint64_t startNs, bool commit)
+{
+  pageOpen = false;
+  busy = true;
+  commitOnDone = commit;
+  busyUntilNs = startNs + timing.writeCycleNs;
+  stats.writeCycles++;
+}
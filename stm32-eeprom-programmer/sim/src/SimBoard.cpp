@@ -0,0 +1,890 @@
+#include "SimBoard.h"
+#include "EEPROMProgrammer.h"
+
+#include <stdint.h>
+#include <string.h>
+
+GPIO_TypeDef simGPIOA;
+GPIO_TypeDef simGPIOB;
+GPIO_TypeDef simGPIOC;
+SysTick_Type simSysTick;
+DWT_Type simDWT;
+CoreDebug_Type simCoreDebug;
+CRC_TypeDef simCRC;
+TIM_TypeDef simTIM2;
+DMA_TypeDef simDMA1;
+DMA_Channel_TypeDef simDMA1Channels[7];
+RCC_TypeDef simRCC;
+PWR_TypeDef simPWR;
+RTC_TypeDef simRTC;
+uint8_t simFlash[SimBoard::FLASH_SIZE];
+uint32_t SystemCoreClock = SimBoard::DEFAULT_CLOCK_HZ;
+
+namespace
+{
+  // Both chips share the bus; only CE is separate
+  Sim28C256 eeproms[2];
+  const uint16_t CE_PINS[2] = {EEPROMProgrammer::EEPROM_CE_PIN, EEPROMProgrammer::EEPROM_CE_UPPER_PIN};
+  SimBoard::Stats stats;
+  uint64_t clockCycles;
+  uint32_t coreClockHz = SimBoard::DEFAULT_CLOCK_HZ;
+  bool hasDwt = true;
+
+  uint64_t cycCntBase;  // clockCycles when CYCCNT was last written
+  uint64_t sysTickBase; // clockCycles when VAL was last written
+  uint64_t rtcBase;     // clockCycles when the RTC clock started
+  uint32_t reportedClockHz;
+
+  GPIO_TypeDef *const PORTS[] = {&simGPIOA, &simGPIOB, &simGPIOC};
+  uint16_t outputMasks[3]; // Pins in output mode, refreshed on CRL/CRH writes
+
+  // TIM2 state while CEN is set
+  bool timerRunning;
+  uint32_t timerCount;    // Counter value
+  uint64_t nextTickCycle; // When the counter next steps
+
+  // DMA transfers in flight, in completion order (the DMA serves one at a time)
+  struct Transfer
+  {
+    uint64_t cycle;
+    uint8_t channel; // 0-based
+  };
+
+  const int MAX_PENDING = 8;
+  Transfer pending[MAX_PENDING];
+  int pendingHead;
+  int pendingCount;
+  uint64_t dmaBusyUntil;
+  uint32_t queued[7];      // Requests accepted but not yet transferred, per channel
+  uint32_t transferred[7]; // Items moved since the channel was enabled
+  uint32_t reloadCount[7]; // CNDTR at enable, for circular mode
+
+  bool flashUnlocked;
+
+  // External bus master and the lines it drives, per port
+  SimBoard::BusMaster *busMaster;
+  uint16_t masterPins[3];
+  uint16_t masterLevels[3]; // As of the last syncChip
+  uint64_t chipSyncNs;      // Time last passed to the chips
+  bool socketsEmpty;
+
+  // Externally driven input pins, applied in order once due
+  struct DrivenInput
+  {
+    uint8_t port;
+    uint16_t pin;
+    bool level;
+    uint64_t fromNs;
+  };
+
+  const int MAX_DRIVEN_INPUTS = 8;
+  DrivenInput drivenInputs[MAX_DRIVEN_INPUTS];
+  int drivenInputCount;
+
+  bool within(const SimRegister &reg, const void *block, size_t size)
+  {
+    uintptr_t address = reinterpret_cast<uintptr_t>(&reg);
+    uintptr_t start = reinterpret_cast<uintptr_t>(block);
+    return address >= start && address < start + size;
+  }
+
+  // Index of the GPIO port a register belongs to, or -1
+  int portOf(const SimRegister &reg)
+  {
+    for (int port = 0; port < 3; port++)
+    {
+      if (within(reg, PORTS[port], sizeof(GPIO_TypeDef)))
+      {
+        return port;
+      }
+    }
+    return -1;
+  }
+
+  // Pins of a port configured as outputs (CRx MODE bits non-zero)
+  uint16_t scanOutputPins(GPIO_TypeDef *port)
+  {
+    uint16_t pins = 0;
+    for (int pin = 0; pin < 16; pin++)
+    {
+      uint32_t config = pin < 8 ? port->CRL.value >> (pin * 4) : port->CRH.value >> ((pin - 8) * 4);
+      if (config & 0x3)
+      {
+        pins |= 1u << pin;
+      }
+    }
+    return pins;
+  }
+
+  uint16_t dataPinsOn(uint8_t port)
+  {
+    uint16_t pins = 0;
+    for (const PinDef &pin : EEPROMProgrammer::DATA_PINS)
+    {
+      if (pin.port == port)
+      {
+        pins |= pin.pin;
+      }
+    }
+    return pins;
+  }
+
+  // Level of a pin as the chip sees it; undriven lines float high
+  bool pinLevel(uint8_t port, uint16_t pin)
+  {
+    if (outputMasks[port] & pin)
+    {
+      return (PORTS[port]->ODR.value & pin) != 0;
+    }
+    if (masterPins[port] & pin)
+    {
+      return (masterLevels[port] & pin) != 0;
+    }
+    return true;
+  }
+
+  // Fetch the bus master's levels; returns the time the chips should see
+  // them change, which is when the master moved if it did since the last sync
+  uint64_t sampleBusMaster(uint64_t nowNs)
+  {
+    uint64_t changedNs = nowNs;
+    SimBoard::BusState state = busMaster->stateAt(nowNs, changedNs);
+
+    memset(masterLevels, 0, sizeof(masterLevels));
+    for (int bit = 0; bit < 15; bit++)
+    {
+      const PinDef &pin = EEPROMProgrammer::ADDRESS_PINS[bit];
+      if (state.address & (1u << bit))
+      {
+        masterLevels[pin.port] |= pin.pin;
+      }
+    }
+    masterLevels[PIN_PORT_A] |= (state.ce ? EEPROMProgrammer::EEPROM_CE_PIN : 0) |
+                                (state.oe ? EEPROMProgrammer::EEPROM_OE_PIN : 0) |
+                                (state.we ? EEPROMProgrammer::EEPROM_WE_PIN : 0);
+
+    return changedNs > chipSyncNs ? changedNs : nowNs;
+  }
+
+  void clearRegisters(void *block, size_t size)
+  {
+    SimRegister *registers = static_cast<SimRegister *>(block);
+    for (size_t i = 0; i < size / sizeof(SimRegister); i++)
+    {
+      registers[i].value = 0;
+    }
+  }
+
+  // The chip driving the data lines, if any
+  Sim28C256 *outputChip()
+  {
+    if (socketsEmpty)
+    {
+      return nullptr;
+    }
+    for (Sim28C256 &eeprom : eeproms)
+    {
+      if (eeprom.outputEnabled())
+      {
+        return &eeprom;
+      }
+    }
+    return nullptr;
+  }
+
+  // Push the MCU (and bus master) side of the bus into the chips
+  void syncChip()
+  {
+    uint64_t nowNs = SimBoard::nanoseconds();
+    bool masterContention = false;
+    if (busMaster != nullptr)
+    {
+      nowNs = sampleBusMaster(nowNs);
+      for (int port = 0; port < 3; port++)
+      {
+        masterContention |= (outputMasks[port] & masterPins[port]) != 0;
+      }
+    }
+    chipSyncNs = nowNs;
+
+    uint16_t address = 0;
+    for (int bit = 0; bit < 15; bit++)
+    {
+      const PinDef &pin = EEPROMProgrammer::ADDRESS_PINS[bit];
+      if (pinLevel(pin.port, pin.pin))
+      {
+        address |= 1u << bit;
+      }
+    }
+
+    uint8_t data = 0;
+    bool driven = false;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      const PinDef &pin = EEPROMProgrammer::DATA_PINS[bit];
+      driven |= (outputMasks[pin.port] & pin.pin) != 0;
+      if (pinLevel(pin.port, pin.pin))
+      {
+        data |= 1u << bit;
+      }
+    }
+
+    int outputs = 0;
+    for (int chip = 0; chip < 2 && !socketsEmpty; chip++)
+    {
+      eeproms[chip].setPins(nowNs, address, data, pinLevel(PIN_PORT_A, CE_PINS[chip]),
+                            pinLevel(PIN_PORT_A, EEPROMProgrammer::EEPROM_OE_PIN),
+                            pinLevel(PIN_PORT_A, EEPROMProgrammer::EEPROM_WE_PIN));
+      outputs += eeproms[chip].outputEnabled();
+    }
+
+    if ((driven && outputs > 0) || outputs > 1 || masterContention)
+    {
+      stats.busContention++;
+    }
+
+    if (busMaster != nullptr)
+    {
+      busMaster->dataChanged(nowNs, data);
+    }
+  }
+
+  uint32_t readIdr(uint8_t port)
+  {
+    // The bus master moves on its own; catch the chips up with it
+    if (busMaster != nullptr)
+    {
+      syncChip();
+    }
+
+    GPIO_TypeDef *gpio = PORTS[port];
+    uint16_t outputs = outputMasks[port];
+    uint16_t external = masterPins[port] & ~outputs;
+    Sim28C256 *eeprom = outputChip();
+    uint16_t chipPins = eeprom != nullptr ? dataPinsOn(port) & ~outputs : 0;
+
+    uint32_t idr = (gpio->ODR.value & outputs) | (masterLevels[port] & external) |
+                   (0xFFFF & ~outputs & ~external & ~chipPins);
+    for (int i = 0; i < drivenInputCount; i++)
+    {
+      const DrivenInput &input = drivenInputs[i];
+      bool floating = !(input.pin & (outputs | external | chipPins));
+      if (input.port == port && input.fromNs <= SimBoard::nanoseconds() && floating)
+      {
+        idr = input.level ? idr | input.pin : idr & ~(uint32_t)input.pin;
+      }
+    }
+    if (chipPins)
+    {
+      uint8_t value = eeprom->readOutput(SimBoard::nanoseconds());
+      for (int bit = 0; bit < 8; bit++)
+      {
+        const PinDef &pin = EEPROMProgrammer::DATA_PINS[bit];
+        if (pin.port == port && (value & (1u << bit)))
+        {
+          idr |= pin.pin;
+        }
+      }
+    }
+    return idr;
+  }
+
+  void writeGpio(uint8_t port, SimRegister &reg, uint32_t value)
+  {
+    GPIO_TypeDef *gpio = PORTS[port];
+    if (&reg == &gpio->BSRR)
+    {
+      // Set bits win over reset bits
+      gpio->ODR.value = (gpio->ODR.value & ~(value >> 16)) | (value & 0xFFFF);
+    }
+    else if (&reg == &gpio->BRR)
+    {
+      gpio->ODR.value &= ~(value & 0xFFFF);
+    }
+    else if (&reg != &gpio->IDR)
+    {
+      reg.value = value;
+      if (&reg == &gpio->CRL || &reg == &gpio->CRH)
+      {
+        outputMasks[port] = scanOutputPins(gpio);
+      }
+    }
+    syncChip();
+  }
+}
+
+namespace
+{
+  uint32_t readRegister(SimRegister &reg);
+  void writeRegister(SimRegister &reg, uint32_t value);
+
+  int dmaChannelOf(const SimRegister &reg)
+  {
+    for (int channel = 0; channel < 7; channel++)
+    {
+      if (&reg == &simDMA1Channels[channel].CCR)
+      {
+        return channel;
+      }
+    }
+    return -1;
+  }
+
+  void request(int channel, uint64_t cycle)
+  {
+    DMA_Channel_TypeDef &dma = simDMA1Channels[channel];
+    if (!(dma.CCR.value & DMA_CCR_EN) || dma.CNDTR.value <= queued[channel] || pendingCount == MAX_PENDING)
+    {
+      return;
+    }
+
+    uint64_t start = cycle > dmaBusyUntil ? cycle : dmaBusyUntil;
+    dmaBusyUntil = start + SimBoard::DMA_TRANSFER_CYCLES;
+    pending[(pendingHead + pendingCount) % MAX_PENDING] = {dmaBusyUntil, (uint8_t)channel};
+    pendingCount++;
+    queued[channel]++;
+  }
+
+  uint32_t sizeMask(uint32_t bytes)
+  {
+    return bytes >= 4 ? 0xFFFFFFFF : (1u << (bytes * 8)) - 1;
+  }
+
+  void completeTransfer()
+  {
+    Transfer transfer = pending[pendingHead];
+    pendingHead = (pendingHead + 1) % MAX_PENDING;
+    pendingCount--;
+
+    int channel = transfer.channel;
+    DMA_Channel_TypeDef &dma = simDMA1Channels[channel];
+    queued[channel]--;
+    if (!(dma.CCR.value & DMA_CCR_EN))
+    {
+      return;
+    }
+
+    // The transfer takes effect at its own time, which is never later than
+    // the CPU access being processed
+    uint64_t now = clockCycles;
+    clockCycles = transfer.cycle;
+
+    uint32_t ccr = dma.CCR.value;
+    uint32_t peripheralSize = 1u << ((ccr >> 8) & 3);
+    uint32_t memorySize = 1u << ((ccr >> 10) & 3);
+    uintptr_t memory = dma.CMAR + ((ccr & DMA_CCR_MINC) ? transferred[channel] * memorySize : 0);
+    SimRegister &reg = *reinterpret_cast<SimRegister *>(
+        dma.CPAR + ((ccr & DMA_CCR_PINC) ? transferred[channel] * peripheralSize : 0));
+
+    if (ccr & DMA_CCR_DIR)
+    {
+      uint32_t value = 0;
+      memcpy(&value, reinterpret_cast<const void *>(memory), memorySize);
+      writeRegister(reg, value & sizeMask(peripheralSize));
+    }
+    else
+    {
+      uint32_t value = readRegister(reg) & sizeMask(memorySize);
+      memcpy(reinterpret_cast<void *>(memory), &value, memorySize);
+    }
+
+    stats.dmaTransfers++;
+    transferred[channel]++;
+    if (--dma.CNDTR.value == 0)
+    {
+      simDMA1.ISR.value |= 0x3u << (channel * 4); // GIF | TCIF
+      if (ccr & DMA_CCR_CIRC)
+      {
+        dma.CNDTR.value = reloadCount[channel];
+        transferred[channel] = 0;
+      }
+    }
+
+    clockCycles = now;
+  }
+
+  void timerTick()
+  {
+    uint64_t cycle = nextTickCycle;
+    nextTickCycle += simTIM2.PSC.value + 1;
+    timerCount = timerCount >= simTIM2.ARR.value ? 0 : timerCount + 1;
+
+    // Requests raised on the same tick are served in channel order
+    uint32_t dier = simTIM2.DIER.value;
+    uint8_t requests = 0;
+    if (timerCount == 0)
+    {
+      simTIM2.SR.value |= 1;
+      if (dier & TIM_DIER_UDE)
+      {
+        requests |= 1u << 1; // TIM2_UP: channel 2
+      }
+    }
+    if ((dier & TIM_DIER_CC1DE) && timerCount == simTIM2.CCR1.value)
+    {
+      requests |= 1u << 4; // TIM2_CH1: channel 5
+    }
+    if ((dier & TIM_DIER_CC2DE) && timerCount == simTIM2.CCR2.value)
+    {
+      requests |= 1u << 6; // TIM2_CH2: channel 7
+    }
+    if ((dier & TIM_DIER_CC3DE) && timerCount == simTIM2.CCR3.value)
+    {
+      requests |= 1u << 0; // TIM2_CH3: channel 1
+    }
+    if ((dier & TIM_DIER_CC4DE) && timerCount == simTIM2.CCR4.value)
+    {
+      requests |= 1u << 6; // TIM2_CH4: channel 7
+    }
+
+    for (int channel = 0; channel < 7; channel++)
+    {
+      if (requests & (1u << channel))
+      {
+        request(channel, cycle);
+      }
+    }
+  }
+
+  // Bring TIM2 and DMA1 up to the given cycle
+  void runPeripherals(uint64_t until)
+  {
+    for (;;)
+    {
+      bool transferDue = pendingCount > 0 && pending[pendingHead].cycle <= until;
+      bool tickDue = timerRunning && nextTickCycle <= until;
+      if (transferDue && (!tickDue || pending[pendingHead].cycle <= nextTickCycle))
+      {
+        completeTransfer();
+      }
+      else if (tickDue)
+      {
+        timerTick();
+      }
+      else
+      {
+        break;
+      }
+    }
+  }
+
+  // The CPU waits out a flash operation; peripherals keep running
+  void stall(uint64_t nanoseconds)
+  {
+    clockCycles += (nanoseconds * coreClockHz + 999999999ULL) / 1000000000ULL;
+    runPeripherals(clockCycles);
+  }
+
+  // Offset of a flash address, or -1 outside the array
+  int32_t flashOffset(uintptr_t address, uint32_t size)
+  {
+    uintptr_t start = reinterpret_cast<uintptr_t>(simFlash);
+    if (address < start || address + size > start + SimBoard::FLASH_SIZE)
+    {
+      return -1;
+    }
+    return (int32_t)(address - start);
+  }
+
+  uint32_t readRegister(SimRegister &reg)
+  {
+    int port = portOf(reg);
+    if (port >= 0)
+    {
+      return &reg == &PORTS[port]->IDR ? readIdr((uint8_t)port) : reg.value;
+    }
+
+    if (&reg == &simDWT.CYCCNT)
+    {
+      bool running = hasDwt && (simCoreDebug.DEMCR.value & CoreDebug_DEMCR_TRCENA_Msk) &&
+                     (simDWT.CTRL.value & DWT_CTRL_CYCCNTENA_Msk);
+      return running ? (uint32_t)(reg.value + (clockCycles - cycCntBase)) : reg.value;
+    }
+
+    if (&reg == &simSysTick.VAL)
+    {
+      if (!(simSysTick.CTRL.value & SysTick_CTRL_ENABLE_Msk))
+      {
+        return reg.value;
+      }
+      // Down-counter that reloads from LOAD
+      uint64_t period = (uint64_t)simSysTick.LOAD.value + 1;
+      uint64_t elapsed = clockCycles - sysTickBase;
+      return (uint32_t)((reg.value + period - elapsed % period) % period);
+    }
+
+    if (&reg == &simRTC.DIVL || &reg == &simRTC.DIVH)
+    {
+      uint32_t enabled = RCC_BDCR_RTCEN | RCC_BDCR_RTCSEL_LSI;
+      if ((simRCC.BDCR.value & (RCC_BDCR_RTCEN | RCC_BDCR_RTCSEL)) != enabled)
+      {
+        return reg.value;
+      }
+      // Down-counter that reloads from PRL, one step per LSI period
+      uint64_t period = (((uint64_t)simRTC.PRLH.value << 16) | simRTC.PRLL.value) + 1;
+      uint64_t ticks = (clockCycles - rtcBase) * SimBoard::LSI_HZ / coreClockHz;
+      uint32_t divider = (uint32_t)(period - 1 - ticks % period);
+      return &reg == &simRTC.DIVL ? divider & 0xFFFF : divider >> 16;
+    }
+
+    if (&reg == &simTIM2.CNT && timerRunning)
+    {
+      return timerCount;
+    }
+
+    return reg.value;
+  }
+
+  void writeRegister(SimRegister &reg, uint32_t value)
+  {
+    int port = portOf(reg);
+    if (port >= 0)
+    {
+      writeGpio((uint8_t)port, reg, value);
+      return;
+    }
+
+    if (&reg == &simCRC.DR)
+    {
+      // One word per write, MSB first, as the F1 unit does it
+      uint32_t crc = reg.value ^ value;
+      for (int bit = 0; bit < 32; bit++)
+      {
+        crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+      }
+      value = crc;
+    }
+    else if (&reg == &simCRC.CR)
+    {
+      if (value & CRC_CR_RESET)
+      {
+        simCRC.DR.value = 0xFFFFFFFF;
+      }
+      value = 0; // RESET reads back as zero
+    }
+    else if (&reg == &simDWT.CYCCNT)
+    {
+      cycCntBase = clockCycles;
+    }
+    else if (&reg == &simRCC.CSR)
+    {
+      // The LSI is ready at once
+      value = (value & RCC_CSR_LSION) ? value | RCC_CSR_LSIRDY : value & ~RCC_CSR_LSIRDY;
+    }
+    else if (&reg == &simRCC.BDCR)
+    {
+      if ((value & RCC_BDCR_RTCEN) && !(reg.value & RCC_BDCR_RTCEN))
+      {
+        rtcBase = clockCycles;
+      }
+    }
+    else if (&reg == &simRTC.CRL)
+    {
+      // RSF is cleared by software and set again by the next synchronization
+      value |= RTC_CRL_RSF;
+    }
+    else if (&reg == &simSysTick.VAL)
+    {
+      // Any write clears the counter
+      sysTickBase = clockCycles;
+      value = 0;
+    }
+    else if (&reg == &simTIM2.CR1)
+    {
+      bool enable = (value & TIM_CR1_CEN) != 0;
+      if (enable && !timerRunning)
+      {
+        timerCount = simTIM2.CNT.value;
+        nextTickCycle = clockCycles + simTIM2.PSC.value + 1;
+      }
+      else if (!enable && timerRunning)
+      {
+        simTIM2.CNT.value = timerCount;
+      }
+      timerRunning = enable;
+    }
+    else if (&reg == &simTIM2.CNT)
+    {
+      timerCount = value;
+    }
+    else if (&reg == &simDMA1.IFCR)
+    {
+      // CGIFx clears every flag of the channel
+      uint32_t clear = value;
+      for (int channel = 0; channel < 7; channel++)
+      {
+        if (value & (1u << (channel * 4)))
+        {
+          clear |= 0xFu << (channel * 4);
+        }
+      }
+      simDMA1.ISR.value &= ~clear;
+      value = 0;
+    }
+    else
+    {
+      int channel = dmaChannelOf(reg);
+      if (channel >= 0 && (value & DMA_CCR_EN) && !(reg.value & DMA_CCR_EN))
+      {
+        transferred[channel] = 0;
+        reloadCount[channel] = simDMA1Channels[channel].CNDTR.value;
+      }
+    }
+    reg.value = value;
+  }
+}
+
+uint32_t simRegisterRead(SimRegister &reg)
+{
+  clockCycles += SimBoard::ACCESS_CYCLES;
+  stats.registerReads++;
+  runPeripherals(clockCycles);
+  return readRegister(reg);
+}
+
+void simRegisterWrite(SimRegister &reg, uint32_t value)
+{
+  clockCycles += SimBoard::ACCESS_CYCLES;
+  stats.registerWrites++;
+  runPeripherals(clockCycles);
+  writeRegister(reg, value);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+  for (int pin = 0; pin < 16; pin++)
+  {
+    if (!(GPIO_Init->Pin & (1u << pin)))
+    {
+      continue;
+    }
+
+    // CRx nibble: MODE[1:0] | CNF[1:0] << 2
+    uint32_t nibble;
+    switch (GPIO_Init->Mode)
+    {
+    case GPIO_MODE_OUTPUT_PP:
+      nibble = GPIO_Init->Speed;
+      break;
+    case GPIO_MODE_OUTPUT_OD:
+      nibble = GPIO_Init->Speed | 0x4;
+      break;
+    case GPIO_MODE_AF_PP:
+      nibble = GPIO_Init->Speed | 0x8;
+      break;
+    case GPIO_MODE_AF_OD:
+      nibble = GPIO_Init->Speed | 0xC;
+      break;
+    case GPIO_MODE_ANALOG:
+      nibble = 0x0;
+      break;
+    default:
+      nibble = GPIO_Init->Pull == GPIO_NOPULL ? 0x4 : 0x8;
+      if (GPIO_Init->Pull != GPIO_NOPULL)
+      {
+        GPIOx->BSRR = GPIO_Init->Pull == GPIO_PULLUP ? (1u << pin) : (1u << (pin + 16));
+      }
+      break;
+    }
+
+    SimRegister &cr = pin < 8 ? GPIOx->CRL : GPIOx->CRH;
+    int shift = (pin % 8) * 4;
+    cr = (cr & ~(0xFu << shift)) | (nibble << shift);
+  }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+  GPIOx->BSRR = PinState == GPIO_PIN_SET ? GPIO_Pin : (uint32_t)GPIO_Pin << 16;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  flashUnlocked = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  flashUnlocked = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data)
+{
+  int32_t offset = flashOffset(Address, 2);
+  if (TypeProgram != FLASH_TYPEPROGRAM_HALFWORD || offset < 0 || (offset & 1))
+  {
+    return HAL_ERROR;
+  }
+
+  // As on the F1: the halfword must be erased, unless it is being zeroed
+  uint16_t current = (uint16_t)(simFlash[offset] | (simFlash[offset + 1] << 8));
+  uint16_t value = (uint16_t)Data;
+  if (!flashUnlocked || (current != 0xFFFF && value != 0x0000))
+  {
+    stats.flashErrors++;
+    return HAL_ERROR;
+  }
+
+  stall(SimBoard::FLASH_PROGRAM_NS);
+  simFlash[offset] = (uint8_t)value;
+  simFlash[offset + 1] = (uint8_t)(value >> 8);
+  stats.flashPrograms++;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+  *PageError = 0xFFFFFFFF;
+  for (uint32_t page = 0; page < pEraseInit->NbPages; page++)
+  {
+    uintptr_t address = pEraseInit->PageAddress + page * FLASH_PAGE_SIZE;
+    int32_t offset = flashOffset(address, FLASH_PAGE_SIZE);
+    if (!flashUnlocked || offset < 0 || (offset % FLASH_PAGE_SIZE) != 0)
+    {
+      *PageError = (uint32_t)address;
+      stats.flashErrors++;
+      return HAL_ERROR;
+    }
+
+    stall(SimBoard::FLASH_ERASE_NS);
+    memset(simFlash + offset, 0xFF, FLASH_PAGE_SIZE);
+    stats.flashErases++;
+  }
+  return HAL_OK;
+}
+
+void SystemCoreClockUpdate(void)
+{
+  SystemCoreClock = reportedClockHz ? reportedClockHz : coreClockHz;
+}
+
+void SimBoard::setReportedClock(uint32_t clockHz)
+{
+  reportedClockHz = clockHz;
+}
+
+void SimBoard::reset(uint32_t clockHz, bool dwtPresent)
+{
+  for (int port = 0; port < 3; port++)
+  {
+    clearRegisters(PORTS[port], sizeof(GPIO_TypeDef));
+    PORTS[port]->CRL.value = PORTS[port]->CRH.value = 0x44444444; // Reset state: floating inputs
+    outputMasks[port] = 0;
+  }
+  clearRegisters(&simSysTick, sizeof(simSysTick));
+  clearRegisters(&simDWT, sizeof(simDWT));
+  clearRegisters(&simCoreDebug, sizeof(simCoreDebug));
+  clearRegisters(&simCRC, sizeof(simCRC));
+  simCRC.DR.value = 0xFFFFFFFF;
+  clearRegisters(&simTIM2, sizeof(simTIM2));
+  clearRegisters(&simDMA1, sizeof(simDMA1));
+  clearRegisters(&simRCC, sizeof(simRCC));
+  clearRegisters(&simPWR, sizeof(simPWR));
+  clearRegisters(&simRTC, sizeof(simRTC));
+  simRTC.PRLL.value = 0x8000; // Reset value
+  for (DMA_Channel_TypeDef &channel : simDMA1Channels)
+  {
+    channel.CCR.value = channel.CNDTR.value = 0;
+    channel.CPAR = channel.CMAR = 0;
+  }
+  timerRunning = false;
+  timerCount = 0;
+  nextTickCycle = 0;
+  pendingHead = pendingCount = 0;
+  dmaBusyUntil = 0;
+  memset(queued, 0, sizeof(queued));
+  memset(transferred, 0, sizeof(transferred));
+  memset(reloadCount, 0, sizeof(reloadCount));
+
+  clockCycles = 0;
+  cycCntBase = 0;
+  sysTickBase = 0;
+  rtcBase = 0;
+  reportedClockHz = 0;
+  coreClockHz = clockHz;
+  hasDwt = dwtPresent;
+  SystemCoreClock = SimBoard::DEFAULT_CLOCK_HZ;
+
+  eeproms[EEPROMProgrammer::CHIP_LOWER] = Sim28C256();
+  eeproms[EEPROMProgrammer::CHIP_UPPER] = Sim28C256();
+  flashUnlocked = false;
+  attachBusMaster(nullptr);
+  chipSyncNs = 0;
+  socketsEmpty = false;
+  drivenInputCount = 0;
+  resetStats();
+}
+
+void SimBoard::eraseFlash()
+{
+  memset(simFlash, 0xFF, sizeof(simFlash));
+}
+
+void SimBoard::attachBusMaster(BusMaster *master)
+{
+  busMaster = master;
+  memset(masterPins, 0, sizeof(masterPins));
+  memset(masterLevels, 0, sizeof(masterLevels));
+  if (master == nullptr)
+  {
+    return;
+  }
+
+  for (const PinDef &pin : EEPROMProgrammer::ADDRESS_PINS)
+  {
+    masterPins[pin.port] |= pin.pin;
+  }
+  masterPins[PIN_PORT_A] |=
+      EEPROMProgrammer::EEPROM_CE_PIN | EEPROMProgrammer::EEPROM_OE_PIN | EEPROMProgrammer::EEPROM_WE_PIN;
+  syncChip();
+}
+
+void SimBoard::setSocketsEmpty(bool empty)
+{
+  socketsEmpty = empty;
+}
+
+void SimBoard::driveInput(uint8_t port, uint16_t pin, bool level, uint64_t fromNs)
+{
+  if (drivenInputCount < MAX_DRIVEN_INPUTS)
+  {
+    drivenInputs[drivenInputCount++] = {port, pin, level, fromNs};
+  }
+}
+
+Sim28C256 &SimBoard::chip(EEPROMProgrammer::Chip which)
+{
+  return eeproms[which];
+}
+
+uint64_t SimBoard::cycles()
+{
+  return clockCycles;
+}
+
+uint64_t SimBoard::nanoseconds()
+{
+  return clockCycles * 1000000000ULL / coreClockHz;
+}
+
+uint32_t SimBoard::clockHz()
+{
+  return coreClockHz;
+}
+
+const SimBoard::Stats &SimBoard::getStats()
+{
+  return stats;
+}
+
+void SimBoard::resetStats()
+{
+  memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,1014 @@
+// Native benchmark and regression run for EEPROMProgrammer against the
+// simulated 28C256. Prints simulated time, simulated throughput and
+// register accesses per byte for each hot path, and exits non-zero if any
+// operation fails or the chip model saw a timing violation.
+//
+// usage: eeprom-sim [--clock-mhz N] [--write-cycle-us N] [--no-dwt]
+
+#include "BurstReader.h"
+#include "BusCapture.h"
+#include "ChipSwap.h"
+#include "CompressedImage.h"
+#include "DelayUtil.h"
+#include "EEPROMDiagnostics.h"
+#include "EEPROMProgrammer.h"
+#include "ExampleImage.h"
+#include "HardwareCRC.h"
+#include "ImageManifest.h"
+#include "ProgressJournal.h"
+#include "RomEmulator.h"
+#include "SimBoard.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+  const uint16_t IMAGE_SIZE = EEPROMProgrammer::EEPROM_SIZE;
+  uint8_t image[IMAGE_SIZE];
+
+  struct Snapshot
+  {
+    uint64_t cycles;
+    uint64_t accesses;
+  };
+
+  Snapshot snapshot()
+  {
+    const SimBoard::Stats &stats = SimBoard::getStats();
+    return {SimBoard::cycles(), stats.registerReads + stats.registerWrites};
+  }
+
+  bool allPassed = true;
+
+  // As in the firmware, capture and emulation share one buffer
+  alignas(4) uint8_t sharedMemory[RomEmulator::SIZE];
+  SharedBuffer sharedBuffer(sharedMemory);
+
+  void report(const char *name, uint32_t bytes, const Snapshot &start, bool ok)
+  {
+    Snapshot end = snapshot();
+    double seconds = (double)(end.cycles - start.cycles) / SimBoard::clockHz();
+    printf("%-28s %6u %10.1f %10.0f %8.1f  %s\n", name, bytes, seconds * 1000.0, bytes / seconds,
+           (double)(end.accesses - start.accesses) / bytes, ok ? "ok" : "FAILED");
+    allPassed &= ok;
+  }
+
+  void fillImage(uint32_t seed)
+  {
+    for (uint32_t i = 0; i < IMAGE_SIZE; i++)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      image[i] = (uint8_t)(seed >> 24);
+    }
+  }
+
+  // Remembers the first few mismatches reported by EEPROMProgrammer::verify
+  class MismatchLog : public MismatchSink
+  {
+  public:
+    uint16_t count = 0;
+    uint16_t addresses[8];
+
+    void mismatch(uint16_t address, uint8_t expected, uint8_t actual) override
+    {
+      (void)expected;
+      (void)actual;
+      if (count < 8)
+      {
+        addresses[count] = address;
+      }
+      count++;
+    }
+  };
+
+  // Where the time of the instrumented write path went
+  void printInstrumentation(const Instrumentation &counters)
+  {
+    for (int phase = 0; phase < Instrumentation::PHASE_COUNT; phase++)
+    {
+      Instrumentation::Phase id = (Instrumentation::Phase)phase;
+      printf("  %-20s %10.1f ms %8u times\n", Instrumentation::phaseName(id),
+             counters.getPhaseCycles(id) * 1000.0 / SimBoard::clockHz(), counters.getPhaseCount(id));
+    }
+    printf("  write cycles:");
+    for (uint8_t bucket = 0; bucket < Instrumentation::HISTOGRAM_BUCKETS; bucket++)
+    {
+      uint32_t count = counters.getHistogram(bucket);
+      uint32_t limit = Instrumentation::bucketLimitMicros(bucket);
+      if (count > 0 && limit > 0)
+      {
+        printf(" <%uus: %u", limit, count);
+      }
+      else if (count > 0)
+      {
+        printf(" longer: %u", count);
+      }
+    }
+    printf("; %u retries, %u timeouts\n", counters.getRetries(), counters.getTimeouts());
+  }
+
+  bool chipHolds(uint16_t start, const uint8_t *data, uint16_t length,
+                 EEPROMProgrammer::Chip which = EEPROMProgrammer::CHIP_LOWER)
+  {
+    return memcmp(SimBoard::chip(which).contents() + start, data, length) == 0;
+  }
+
+  // Register accesses per call of the bus primitives; a per-pin version
+  // takes one per line (15, 8 and 8)
+  void benchBusPrimitives(EEPROMProgrammer &eeprom)
+  {
+    const uint32_t calls = 1024;
+    Snapshot start = snapshot();
+    for (uint32_t i = 0; i < calls; i++)
+    {
+      eeprom.setAddress((uint16_t)(i * 37));
+    }
+    Snapshot afterAddress = snapshot();
+
+    eeprom.setDataBusOutput();
+    Snapshot afterDirection = snapshot();
+    for (uint32_t i = 0; i < calls; i++)
+    {
+      eeprom.writeData((uint8_t)i);
+    }
+    Snapshot afterWrite = snapshot();
+
+    eeprom.setDataBusInput();
+    Snapshot afterInput = snapshot();
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < calls; i++)
+    {
+      sum += eeprom.readData();
+    }
+    Snapshot afterRead = snapshot();
+    (void)sum;
+
+    printf("bus primitives, accesses (cycles) per call: setAddress %.1f (%.1f), writeData %.1f (%.1f), "
+           "readData %.1f (%.1f)\n",
+           (double)(afterAddress.accesses - start.accesses) / calls,
+           (double)(afterAddress.cycles - start.cycles) / calls,
+           (double)(afterWrite.accesses - afterDirection.accesses) / calls,
+           (double)(afterWrite.cycles - afterDirection.cycles) / calls,
+           (double)(afterRead.accesses - afterInput.accesses) / calls,
+           (double)(afterRead.cycles - afterInput.cycles) / calls);
+  }
+
+  // Software chip erase, and blank checks that stop at the first used byte
+  void benchErase(EEPROMProgrammer &eeprom)
+  {
+    const uint8_t *cells = SimBoard::chip().contents();
+    uint16_t expectedUsed = 0;
+    while (expectedUsed < IMAGE_SIZE - 1 && cells[expectedUsed] == 0xFF)
+    {
+      expectedUsed++;
+    }
+
+    uint16_t firstUsed = 0;
+    Snapshot start = snapshot();
+    bool ok = !eeprom.isBlank(0, IMAGE_SIZE, &firstUsed) && firstUsed == expectedUsed;
+    report("isBlank, used chip", firstUsed + 1, start, ok);
+
+    uint32_t erasesBefore = SimBoard::chip().getStats().chipErases;
+    start = snapshot();
+    ok = eeprom.eraseChip() && SimBoard::chip().getStats().chipErases == erasesBefore + 1;
+    for (uint32_t i = 0; i < IMAGE_SIZE && ok; i++)
+    {
+      ok = cells[i] == 0xFF;
+    }
+    report("eraseChip", IMAGE_SIZE, start, ok);
+
+    start = snapshot();
+    ok = eeprom.isBlank(0, IMAGE_SIZE, &firstUsed);
+    report("isBlank, erased chip", IMAGE_SIZE, start, ok);
+
+    ok = eeprom.writeByte(0x7FFE, 0x00);
+    start = snapshot();
+    ok = ok && !eeprom.isBlank(0, IMAGE_SIZE, &firstUsed) && firstUsed == 0x7FFE;
+    report("isBlank, last bytes used", IMAGE_SIZE, start, ok);
+  }
+
+  // An image source that stops delivering after a fixed number of bytes,
+  // counted over every pass: a reset partway through writeImage, which
+  // reads the image once for the journal's hash and once to write it
+  class InterruptedImage : public ImageSource
+  {
+  public:
+    InterruptedImage(const uint8_t *data, uint32_t budget) : data(data), budget(budget), position(0) {}
+
+    void rewind() override
+    {
+      position = 0;
+    }
+
+    uint16_t read(uint8_t *out, uint16_t length) override
+    {
+      uint16_t count = budget < length ? (uint16_t)budget : length;
+      memcpy(out, data + position, count);
+      position += count;
+      budget -= count;
+      return count;
+    }
+
+  private:
+    const uint8_t *data;
+    uint32_t budget;
+    uint16_t position;
+  };
+
+  // A full-chip write stops after 312 pages. The next run, with a new
+  // journal object as after a reset, writes only what is missing. The page
+  // confirmed last is damaged in between, so its check has to catch it.
+  void benchJournal(EEPROMProgrammer &eeprom)
+  {
+    const uint16_t PAGES_DONE = 312;
+    const uint16_t BOUNDARY = (PAGES_DONE - 1) * EEPROMProgrammer::PAGE_SIZE;
+    const SimBoard::Stats &board = SimBoard::getStats();
+    fillImage(6);
+
+    uint32_t programsBefore = board.flashPrograms;
+    uint32_t erasesBefore = board.flashErases;
+    InterruptedImage cutOff(image, IMAGE_SIZE + PAGES_DONE * EEPROMProgrammer::PAGE_SIZE);
+    ProgressJournal interrupted;
+    Snapshot start = snapshot();
+    bool ok = !eeprom.writeImage(0, cutOff, IMAGE_SIZE, EEPROMProgrammer::WRITE_MODE_PAGE,
+                                 EEPROMProgrammer::COMPLETION_DATA_POLLING, &interrupted);
+    ok = ok && chipHolds(0, image, PAGES_DONE * EEPROMProgrammer::PAGE_SIZE);
+    report("writeImage, interrupted", PAGES_DONE * EEPROMProgrammer::PAGE_SIZE, start, ok);
+    printf("  journal: %u flash pages erased, %u halfwords programmed\n", board.flashErases - erasesBefore,
+           board.flashPrograms - programsBefore);
+
+    SimBoard::chip().contents()[BOUNDARY + 5] ^= 0x20;
+
+    ArrayImage fullImage(image, IMAGE_SIZE);
+    ProgressJournal resumed;
+    uint32_t loadsBefore = SimBoard::chip().getStats().bytesLoaded;
+    start = snapshot();
+    ok = eeprom.writeImage(0, fullImage, IMAGE_SIZE, EEPROMProgrammer::WRITE_MODE_PAGE,
+                           EEPROMProgrammer::COMPLETION_DATA_POLLING, &resumed);
+    uint32_t loaded = SimBoard::chip().getStats().bytesLoaded - loadsBefore;
+    ok = ok && chipHolds(0, image, IMAGE_SIZE) && eeprom.getLastResumedPages() == PAGES_DONE - 1 &&
+         loaded == (IMAGE_SIZE / EEPROMProgrammer::PAGE_SIZE - PAGES_DONE + 1) * EEPROMProgrammer::PAGE_SIZE;
+    report("writeImage, resumed", IMAGE_SIZE, start, ok);
+    printf("  %u pages skipped, %u bytes written\n", eeprom.getLastResumedPages(), loaded);
+
+    // The verified session is closed: the same image starts over next time
+    ProgressJournal after;
+    ok = after.open(ProgressJournal::hashImage(fullImage, IMAGE_SIZE), 0, IMAGE_SIZE,
+                    EEPROMProgrammer::CHIP_LOWER) == 0 && !after.isResumed();
+    printf("  journal closed after the verify: %s\n", ok ? "ok" : "FAILED");
+    allPassed &= ok && board.flashErrors == 0;
+  }
+
+  // Updates through the manifest in the chip's tail: the first run compares
+  // every page and writes the manifest, later ones only touch pages whose
+  // hash changed, and a plain write in between makes the manifest stale
+  void benchManifest(EEPROMProgrammer &eeprom)
+  {
+    const uint16_t SIZE = ImageManifest::IMAGE_LIMIT; // The largest image with a manifest
+    const uint16_t PAGES = SIZE / EEPROMProgrammer::PAGE_SIZE;
+    static uint32_t crcs[PAGES];
+    const EEPROMProgrammer::DiffStats &diff = eeprom.getLastDiffStats();
+    const Sim28C256::Stats &chip = SimBoard::chip().getStats();
+    ArrayImage source(image, SIZE);
+
+    fillImage(7);
+    for (uint16_t page = 0; page < PAGES; page++)
+    {
+      crcs[page] = HardwareCRC::compute(image + page * EEPROMProgrammer::PAGE_SIZE, EEPROMProgrammer::PAGE_SIZE);
+    }
+
+    Snapshot start = snapshot();
+    bool ok = eeprom.writeImageManifest(0, source, SIZE, crcs, ImageManifest::crc32(image, SIZE));
+    report("writeImageManifest, none", SIZE, start, ok && chipHolds(0, image, SIZE) && diff.pagesRead == PAGES);
+
+    // The same small rebuild as for writeImageDifferential
+    const uint16_t changes[] = {100, 5000, 5001, 20000};
+    for (uint16_t address : changes)
+    {
+      image[address] ^= 0x21;
+      uint16_t page = address / EEPROMProgrammer::PAGE_SIZE;
+      crcs[page] = HardwareCRC::compute(image + page * EEPROMProgrammer::PAGE_SIZE, EEPROMProgrammer::PAGE_SIZE);
+    }
+
+    uint32_t loadsBefore = chip.bytesLoaded;
+    start = snapshot();
+    ok = eeprom.writeImageManifest(0, source, SIZE, crcs, ImageManifest::crc32(image, SIZE));
+    uint32_t loaded = chip.bytesLoaded - loadsBefore;
+    ok = ok && chipHolds(0, image, SIZE) && diff.pagesRead == 3 && diff.pagesWritten == 3;
+    report("writeImageManifest, 3 pages", SIZE, start, ok);
+    printf("  %u pages read, %u written; %u bytes loaded with the manifest\n", diff.pagesRead, diff.pagesWritten,
+           loaded);
+
+    loadsBefore = chip.bytesLoaded;
+    start = snapshot();
+    ok = eeprom.writeImageManifest(0, source, SIZE, crcs, ImageManifest::crc32(image, SIZE));
+    ok = ok && diff.pagesRead == 0 && chip.bytesLoaded == loadsBefore;
+    report("writeImageManifest, same", SIZE, start, ok);
+
+    // Behind the manifest's back: it must not be trusted afterwards
+    uint8_t other[EEPROMProgrammer::PAGE_SIZE];
+    memcpy(other, image + 640, sizeof(other));
+    other[7] ^= 0x01;
+    ok = eeprom.writeDataBlock(640, other, sizeof(other));
+    start = snapshot();
+    ok = ok && eeprom.writeImageManifest(0, source, SIZE, crcs, ImageManifest::crc32(image, SIZE));
+    ok = ok && chipHolds(0, image, SIZE) && diff.pagesRead == PAGES && diff.pagesWritten == 1;
+    report("writeImageManifest, stale", SIZE, start, ok);
+  }
+
+  // Both lanes of one word image through one socket: the lower lane, a swap
+  // to a blank chip confirmed with the button, then the upper lane
+  void benchSwap(EEPROMProgrammer &eeprom)
+  {
+    const uint16_t SIZE = EXAMPLE_LOWER_SIZE;
+    const uint16_t PAGES = (SIZE + EEPROMProgrammer::PAGE_SIZE - 1) / EEPROMProgrammer::PAGE_SIZE;
+    const uint64_t PRESS_AFTER_NS = 50000000;
+    const uint64_t PRESS_NS = 100000000;
+    static uint8_t words[2 * SIZE];
+    static uint32_t crcs[2][PAGES];
+    const uint8_t *lanes[2] = {exampleLower, exampleUpper};
+
+    for (uint16_t i = 0; i < SIZE; i++)
+    {
+      words[2 * i] = exampleLower[i];
+      words[2 * i + 1] = exampleUpper[i];
+    }
+    for (int lane = 0; lane < 2; lane++)
+    {
+      for (uint16_t page = 0; page < PAGES; page++)
+      {
+        uint16_t offset = page * EEPROMProgrammer::PAGE_SIZE;
+        uint16_t chunk = SIZE - offset < EEPROMProgrammer::PAGE_SIZE ? SIZE - offset : EEPROMProgrammer::PAGE_SIZE;
+        crcs[lane][page] = HardwareCRC::compute(lanes[lane] + offset, chunk);
+      }
+    }
+
+    ArrayImage source(words, sizeof(words));
+    ChipSwap::WordImage wordImage = {&source,
+                                     0,
+                                     SIZE,
+                                     {crcs[0], crcs[1]},
+                                     {ImageManifest::crc32(exampleLower, SIZE), ImageManifest::crc32(exampleUpper, SIZE)}};
+    ChipSwap swap(eeprom);
+    swap.begin();
+
+    Snapshot start = snapshot();
+    bool ok = swap.burn(wordImage, LaneImage::LANE_LOW) && chipHolds(0, exampleLower, SIZE);
+    ok = ok && swap.holdsLane(wordImage, LaneImage::LANE_LOW) && !swap.holdsLane(wordImage, LaneImage::LANE_HIGH);
+    report("ChipSwap lower lane", SIZE, start, ok);
+
+    memset(SimBoard::chip().contents(), 0xFF, EEPROMProgrammer::EEPROM_SIZE);
+    uint64_t pressNs = SimBoard::nanoseconds() + PRESS_AFTER_NS;
+    SimBoard::driveInput(PIN_PORT_B, ChipSwap::BUTTON_PIN, false, pressNs);
+    SimBoard::driveInput(PIN_PORT_B, ChipSwap::BUTTON_PIN, true, pressNs + PRESS_NS);
+    swap.waitForSwap(wordImage);
+    uint64_t releasedNs = SimBoard::nanoseconds();
+    // Released, plus the first-page read that tells the chips apart
+    ok = releasedNs >= pressNs + PRESS_NS && releasedNs < pressNs + PRESS_NS + 5000000;
+    printf("  swap confirmed, button released %.1f ms after the press: %s\n", (releasedNs - pressNs) / 1e6,
+           ok ? "ok" : "FAILED");
+    allPassed &= ok;
+
+    start = snapshot();
+    ok = swap.burn(wordImage, LaneImage::LANE_HIGH) && chipHolds(0, exampleUpper, SIZE);
+    report("ChipSwap upper lane", SIZE, start, ok);
+  }
+
+  // Reads the characterization sweeps make too early on purpose
+  uint32_t expectedEarlyReads = 0;
+
+  // A fast part on the lower socket: characterize it on a scratch page, then
+  // compare the bulk paths against the datasheet timings
+  void benchTiming(EEPROMProgrammer &eeprom, const Sim28C256::Timing &timing)
+  {
+    Sim28C256 &chip = SimBoard::chip();
+    Sim28C256::Timing fast = timing;
+    fast.accessNs = 70;
+    fast.outputEnableNs = 30;
+    chip.setTiming(fast);
+
+    static uint8_t contents[IMAGE_SIZE];
+    memcpy(contents, chip.contents(), IMAGE_SIZE);
+
+    Snapshot start = snapshot();
+    bool ok = eeprom.verifyData(0, contents, IMAGE_SIZE);
+    report("verifyData, datasheet", IMAGE_SIZE, start, ok);
+
+    static uint8_t dumped[IMAGE_SIZE];
+    BufferSink datasheetSink(dumped, IMAGE_SIZE);
+    start = snapshot();
+    eeprom.dump(0, IMAGE_SIZE, datasheetSink);
+    report("dump, datasheet", IMAGE_SIZE, start, memcmp(dumped, contents, IMAGE_SIZE) == 0);
+
+    uint32_t earlyBefore = chip.getStats().earlyReads;
+    start = snapshot();
+    ok = eeprom.characterizeTiming(0x7F00) && memcmp(chip.contents(), contents, IMAGE_SIZE) == 0;
+    report("characterizeTiming", EEPROMProgrammer::PAGE_SIZE, start, ok);
+    expectedEarlyReads += chip.getStats().earlyReads - earlyBefore;
+
+    const EEPROMProgrammer::TimingProfile &profile = eeprom.getTimingProfile();
+    printf("  tACC +%u, tOE +%u, first read +%u, first write +%u cycles; tWC %u us, timeout %u us\n",
+           profile.accessCycles, profile.outputEnableCycles, profile.firstReadCycles, profile.firstWriteCycles,
+           profile.writeCycleMicros, profile.writeTimeoutMicros);
+
+    start = snapshot();
+    ok = eeprom.verifyData(0, contents, IMAGE_SIZE);
+    report("verifyData, profiled", IMAGE_SIZE, start, ok);
+
+    memset(dumped, 0, sizeof(dumped));
+    BufferSink profiledSink(dumped, IMAGE_SIZE);
+    start = snapshot();
+    eeprom.dump(0, IMAGE_SIZE, profiledSink);
+    report("dump, profiled", IMAGE_SIZE, start, memcmp(dumped, contents, IMAGE_SIZE) == 0);
+
+    fillImage(5);
+    start = snapshot();
+    ok = eeprom.writeDataBlock(0x1000, image, 4096, EEPROMProgrammer::WRITE_MODE_PAGE);
+    report("writeDataBlock, profiled", 4096, start, ok && chipHolds(0x1000, image, 4096));
+
+    eeprom.resetTimingProfile();
+    chip.setTiming(timing);
+  }
+
+  // The homemade CPU running from the lower chip: a loop that calls a short
+  // routine, one fetch every periodNs. CE and OE stay low, WE high.
+  class FetchingCpu : public SimBoard::BusMaster
+  {
+  public:
+    static const uint16_t LOOP = 0x0100;
+    static const uint16_t ROUTINE = 0x0400;
+    static const uint32_t PROGRAM_LENGTH = 28;
+
+    FetchingCpu(uint64_t startNs, uint64_t periodNs) : startNs(startNs), periodNs(periodNs) {}
+
+    // 20 fetches of the loop, 4 of the routine, 4 more of the loop
+    static uint16_t fetchAddress(uint64_t fetch)
+    {
+      uint32_t step = (uint32_t)(fetch % PROGRAM_LENGTH);
+      if (step < 20)
+      {
+        return LOOP + step;
+      }
+      return step < 24 ? ROUTINE + (step - 20) : LOOP + (step - 4);
+    }
+
+    SimBoard::BusState stateAt(uint64_t nowNs, uint64_t &changedNs) override
+    {
+      uint64_t fetch = (nowNs - startNs) / periodNs;
+      changedNs = startNs + fetch * periodNs;
+      return {fetchAddress(fetch), false, false, true};
+    }
+
+  private:
+    uint64_t startNs;
+    uint64_t periodNs;
+  };
+
+  // Checks a capture of FetchingCpu: samples whose neighbours show the same
+  // address must hold that address's data, and the fetches must follow the
+  // program. Returns the number of fetches (runs of one address).
+  bool checkCapture(BusCapture &capture, uint16_t count, uint32_t &fetches)
+  {
+    static BusCapture::Sample samples[BusCapture::DEPTH];
+    if (capture.readSamples(0, samples, count) != count)
+    {
+      return false;
+    }
+
+    const uint8_t *cells = SimBoard::chip().contents();
+    fetches = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      const BusCapture::Sample &sample = samples[i];
+      if (sample.control != BusCapture::CONTROL_WE)
+      {
+        return false;
+      }
+      bool settled = i > 0 && i + 1 < count && samples[i - 1].address == sample.address &&
+                     samples[i + 1].address == sample.address;
+      if (settled && sample.data != cells[sample.address])
+      {
+        return false;
+      }
+
+      if (i > 0 && samples[i - 1].address != sample.address)
+      {
+        fetches++;
+        // The next address in program order (the step before is unknown)
+        bool follows = false;
+        for (uint32_t step = 0; step < FetchingCpu::PROGRAM_LENGTH; step++)
+        {
+          follows |= FetchingCpu::fetchAddress(step) == samples[i - 1].address &&
+                     FetchingCpu::fetchAddress(step + 1) == sample.address;
+        }
+        if (!follows)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Logic-analyzer capture of a CPU fetching from the lower chip, with the
+  // programmer's pins all inputs
+  void benchCapture(EEPROMProgrammer &eeprom)
+  {
+    BusCapture capture(eeprom, sharedBuffer);
+    capture.begin();
+    Sim28C256 &chip = SimBoard::chip();
+    uint32_t earlyBefore = chip.getStats().earlyReads;
+    uint32_t contentionBefore = SimBoard::getStats().busContention;
+
+    // Four samples per fetch
+    BusCapture::Settings settings;
+    settings.sampleRateHz = SimBoard::clockHz() / (2 * BusCapture::MIN_PERIOD_CYCLES);
+    settings.useTrigger = true;
+    settings.triggerAddress = FetchingCpu::ROUTINE;
+    settings.preTrigger = 100;
+    settings.timeoutUs = 100000;
+    uint64_t fetchNs = 4000000000ULL / settings.sampleRateHz;
+
+    eeprom.releaseBus();
+    FetchingCpu cpu(SimBoard::nanoseconds(), fetchNs);
+    SimBoard::attachBusMaster(&cpu);
+
+    BusCapture::Result result;
+    BusCapture::Sample first;
+    uint32_t fetches = 0;
+    Snapshot start = snapshot();
+    bool ok = capture.capture(settings, result) && result.triggered && result.missedSamples == 0 &&
+              result.sampleCount == BusCapture::DEPTH - 1 && result.triggerIndex == settings.preTrigger;
+    ok = ok && capture.readSamples(result.triggerIndex - 1, &first, 1) == 1 &&
+         first.address != FetchingCpu::ROUTINE && capture.readSamples(result.triggerIndex, &first, 1) == 1 &&
+         first.address == FetchingCpu::ROUTINE;
+    ok = ok && checkCapture(capture, result.sampleCount, fetches);
+    report("capture, trigger", result.sampleCount, start, ok);
+    printf("  %u Hz, trigger at sample %u, %u fetches (%.0f/s)\n", SimBoard::clockHz() / result.periodCycles,
+           result.triggerIndex, fetches, 1e9 / fetchNs);
+
+    settings.useTrigger = false;
+    start = snapshot();
+    ok = capture.capture(settings, result) && result.sampleCount == BusCapture::DEPTH - 1 &&
+         checkCapture(capture, result.sampleCount, fetches);
+    report("capture, untriggered", result.sampleCount, start, ok);
+
+    // An address the CPU never fetches: the buffer still holds the last samples
+    settings.useTrigger = true;
+    settings.triggerAddress = 0x7000;
+    settings.timeoutUs = 5000;
+    start = snapshot();
+    ok = !capture.capture(settings, result) && !result.triggered &&
+         result.sampleCount == BusCapture::DEPTH - 1 && checkCapture(capture, result.sampleCount, fetches);
+    report("capture, trigger timeout", result.sampleCount, start, ok);
+
+    SimBoard::attachBusMaster(nullptr);
+    eeprom.claimBus();
+    expectedEarlyReads += chip.getStats().earlyReads - earlyBefore;
+    ok = SimBoard::getStats().busContention == contentionBefore && eeprom.verifyData(0, chip.contents(), 256);
+    printf("  no contention, programmer has the bus back: %s\n", ok ? "ok" : "FAILED");
+    allPassed &= ok;
+  }
+
+  // A CPU reading the emulated ROM with both sockets empty: a new address
+  // each period with CE and OE low, except every IDLE_EVERY-th period with
+  // OE high, and the data latched at the end of the period. Reads between
+  // checkFromNs and checkUntilNs are compared with the image, mirrored as
+  // the emulator does.
+  class ReadingCpu : public SimBoard::BusMaster
+  {
+  public:
+    static const uint32_t IDLE_EVERY = 16;
+
+    ReadingCpu(uint64_t startNs, uint64_t periodNs, uint64_t checkFromNs, uint64_t checkUntilNs)
+        : startNs(startNs), periodNs(periodNs), checkFromNs(checkFromNs), checkUntilNs(checkUntilNs)
+    {
+    }
+
+    static uint16_t readAddress(uint64_t period)
+    {
+      return (uint16_t)((period * 2654435761u) >> 9) & 0x7FFF;
+    }
+
+    SimBoard::BusState stateAt(uint64_t nowNs, uint64_t &changedNs) override
+    {
+      // Latch every period that ended since the last call; the data lines
+      // have not changed since then
+      for (; startNs + (latched + 1) * periodNs <= nowNs; latched++)
+      {
+        uint64_t beginNs = startNs + latched * periodNs;
+        bool checked = beginNs >= checkFromNs && beginNs + periodNs <= checkUntilNs;
+        if (checked && latched % IDLE_EVERY != 0)
+        {
+          reads++;
+          errors += data != image[readAddress(latched) % RomEmulator::SIZE];
+        }
+      }
+
+      uint64_t period = (nowNs - startNs) / periodNs;
+      changedNs = startNs + period * periodNs;
+      return {readAddress(period), false, period % IDLE_EVERY == 0, true};
+    }
+
+    void dataChanged(uint64_t nowNs, uint8_t value) override
+    {
+      (void)nowNs;
+      data = value;
+    }
+
+    uint32_t reads = 0;
+    uint32_t errors = 0;
+
+  private:
+    uint64_t startNs;
+    uint64_t periodNs;
+    uint64_t checkFromNs;
+    uint64_t checkUntilNs;
+    uint64_t latched = 0;
+    uint8_t data = 0xFF;
+  };
+
+  // Serve `periods` reads, then send the start bit that ends emulation
+  void serveCpu(EEPROMProgrammer &eeprom, RomEmulator &emulator, uint64_t periodNs, uint32_t periods,
+                ReadingCpu *&cpu)
+  {
+    const uint64_t RESET_NS = 100000; // The CPU's reads count once the emulator is surely up
+    uint64_t startNs = SimBoard::nanoseconds();
+    uint64_t stopNs = startNs + RESET_NS + periods * periodNs;
+    static ReadingCpu instance(0, 1, 0, 0);
+    instance = ReadingCpu(startNs, periodNs, startNs + RESET_NS, stopNs);
+    cpu = &instance;
+
+    eeprom.releaseBus();
+    SimBoard::attachBusMaster(cpu);
+    SimBoard::driveInput(PIN_PORT_B, RomEmulator::HOST_RX_PIN, false, stopNs);
+    emulator.run();
+    SimBoard::driveInput(PIN_PORT_B, RomEmulator::HOST_RX_PIN, true, SimBoard::nanoseconds());
+    SimBoard::attachBusMaster(nullptr);
+  }
+
+  // ROM emulation: the programmer answers a CPU's reads from SRAM at the
+  // clock it publishes, and fails well above it
+  void benchEmulation(EEPROMProgrammer &eeprom)
+  {
+    const uint32_t PERIODS = 2000;
+    static RomEmulator emulator(eeprom, sharedBuffer);
+    fillImage(5);
+
+    Snapshot start = snapshot();
+    bool ok = true;
+    for (uint16_t address = 0; address < RomEmulator::SIZE; address += ProgrammingProtocol::PAGE_SIZE)
+    {
+      ok &= emulator.load(address, image + address, ProgrammingProtocol::PAGE_SIZE);
+    }
+    ok = ok && !emulator.load(RomEmulator::SIZE - 1, image, 2);
+    ProgrammingProtocol::EmulationInfo info;
+    emulator.describe(info);
+    report("emulator load + calibrate", RomEmulator::SIZE, start, ok);
+    printf("  %u cycles per pass, access time %u ns, CPU clock up to %.3f MHz\n", info.loopCycles, info.accessNs,
+           info.maxClockHz / 1e6);
+
+    uint32_t contentionBefore = SimBoard::getStats().busContention;
+    SimBoard::setSocketsEmpty(true);
+    ReadingCpu *cpu;
+
+    uint64_t periodNs = info.accessNs;
+    start = snapshot();
+    serveCpu(eeprom, emulator, periodNs, PERIODS, cpu);
+    ok = cpu->reads >= PERIODS * 9 / 10 && cpu->errors == 0;
+    report("emulated ROM at max clock", cpu->reads, start, ok);
+    printf("  %.3f MHz CPU clock, %u reads, %u wrong\n", 1e3 / periodNs, cpu->reads, cpu->errors);
+
+    periodNs = info.accessNs / 3;
+    start = snapshot();
+    serveCpu(eeprom, emulator, periodNs, PERIODS, cpu);
+    ok = cpu->errors > 0;
+    report("emulated ROM at 3x max", cpu->reads, start, ok);
+    printf("  %.3f MHz CPU clock, %u reads, %u wrong (expected)\n", 1e3 / periodNs, cpu->reads, cpu->errors);
+
+    SimBoard::setSocketsEmpty(false);
+    emulator.endEmulation();
+    ok = SimBoard::getStats().busContention == contentionBefore &&
+         eeprom.verifyData(0, SimBoard::chip().contents(), 256);
+    printf("  no contention, programmer has the bus back: %s\n", ok ? "ok" : "FAILED");
+    allPassed &= ok;
+
+    // Once a capture has had the shared buffer, the image starts blank again
+    sharedBuffer.take(&sharedBuffer);
+    ok = emulator.load(0, image, ProgrammingProtocol::PAGE_SIZE) &&
+         memcmp(sharedMemory, image, ProgrammingProtocol::PAGE_SIZE) == 0 &&
+         sharedMemory[RomEmulator::SIZE - 1] == 0xFF;
+    printf("  image blank after the buffer was lent out: %s\n", ok ? "ok" : "FAILED");
+    allPassed &= ok;
+  }
+
+  // A 16-bit image burned as two single-chip sessions, then in one dual-mode pass
+  void benchDual(EEPROMProgrammer &eeprom)
+  {
+    static uint8_t upper[IMAGE_SIZE];
+    fillImage(3);
+    memcpy(upper, image, IMAGE_SIZE);
+    fillImage(4);
+    ArrayImage lowerImage(image, IMAGE_SIZE);
+    ArrayImage upperImage(upper, IMAGE_SIZE);
+
+    Snapshot start = snapshot();
+    bool ok = eeprom.writeImage(0, lowerImage, IMAGE_SIZE);
+    eeprom.selectChip(EEPROMProgrammer::CHIP_UPPER);
+    ok = ok && eeprom.writeImage(0, upperImage, IMAGE_SIZE);
+    eeprom.selectChip(EEPROMProgrammer::CHIP_LOWER);
+    ok = ok && chipHolds(0, image, IMAGE_SIZE) && chipHolds(0, upper, IMAGE_SIZE, EEPROMProgrammer::CHIP_UPPER);
+    report("writeImage lower, upper", 2 * IMAGE_SIZE, start, ok);
+
+    // Swap the halves so every byte changes
+    start = snapshot();
+    ok = eeprom.writeImagePair(0, upperImage, lowerImage, IMAGE_SIZE);
+    ok = ok && chipHolds(0, upper, IMAGE_SIZE) && chipHolds(0, image, IMAGE_SIZE, EEPROMProgrammer::CHIP_UPPER) &&
+         eeprom.getSelectedChip() == EEPROMProgrammer::CHIP_LOWER;
+    report("writeImagePair", 2 * IMAGE_SIZE, start, ok);
+
+    uint8_t unaligned[100];
+    memcpy(unaligned, image + 7000, sizeof(unaligned));
+    for (uint8_t &value : unaligned)
+    {
+      value ^= 0x5A;
+    }
+    ArrayImage lowerPart(unaligned, sizeof(unaligned));
+    ArrayImage upperPart(image + 7000, sizeof(unaligned));
+    start = snapshot();
+    ok = eeprom.writeImagePair(7000, lowerPart, upperPart, sizeof(unaligned));
+    ok = ok && chipHolds(7000, unaligned, sizeof(unaligned)) &&
+         chipHolds(7000, image + 7000, sizeof(unaligned), EEPROMProgrammer::CHIP_UPPER);
+    report("writeImagePair unaligned", 2 * sizeof(unaligned), start, ok);
+  }
+
+  void benchCompressed(EEPROMProgrammer &eeprom, const char *name, const uint8_t *compressed, uint32_t compressedSize,
+                       const uint8_t *raw, uint16_t size, uint16_t address)
+  {
+    CompressedImage image(compressed, compressedSize);
+
+    Snapshot start = snapshot();
+    bool ok = eeprom.writeImage(address, image, size);
+    report(name, size, start, ok && chipHolds(address, raw, size));
+
+    // Decompression is pure CPU work, which the virtual clock does not
+    // count, so time it on this host instead
+    const int REPEATS = 200;
+    uint8_t page[EEPROMProgrammer::PAGE_SIZE];
+    uint32_t pages = 0;
+    auto hostStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; i++)
+    {
+      image.rewind();
+      while (image.read(page, sizeof(page)) > 0)
+      {
+        pages++;
+      }
+    }
+    double hostNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - hostStart).count();
+
+    printf("  %u -> %u bytes (%.2f:1), decompression %.0f ns/page on this host\n", size, compressedSize,
+           (double)size / compressedSize, hostNs / pages);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t clockHz = SimBoard::DEFAULT_CLOCK_HZ;
+  uint32_t writeCycleUs = 0;
+  bool dwtPresent = true;
+  uint32_t reportedClockHz = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--clock-mhz") && i + 1 < argc)
+    {
+      clockHz = (uint32_t)atoi(argv[++i]) * 1000000;
+    }
+    else if (!strcmp(argv[i], "--write-cycle-us") && i + 1 < argc)
+    {
+      writeCycleUs = (uint32_t)atoi(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--reported-clock-mhz") && i + 1 < argc)
+    {
+      reportedClockHz = (uint32_t)atoi(argv[++i]) * 1000000;
+    }
+    else if (!strcmp(argv[i], "--no-dwt"))
+    {
+      dwtPresent = false;
+    }
+    else
+    {
+      fprintf(stderr, "usage: eeprom-sim [--clock-mhz N] [--reported-clock-mhz N] [--write-cycle-us N] [--no-dwt]\n");
+      return 2;
+    }
+  }
+
+  SimBoard::reset(clockHz, dwtPresent);
+  SimBoard::setReportedClock(reportedClockHz);
+  SimBoard::eraseFlash();
+  Sim28C256::Timing timing = SimBoard::chip().getTiming();
+  if (writeCycleUs)
+  {
+    timing.writeCycleNs = writeCycleUs * 1000;
+  }
+  SimBoard::chip(EEPROMProgrammer::CHIP_LOWER).setTiming(timing);
+  SimBoard::chip(EEPROMProgrammer::CHIP_UPPER).setTiming(timing);
+
+  EEPROMProgrammer eeprom;
+  eeprom.begin();
+  BurstReader burst(eeprom);
+  burst.begin();
+
+  printf("%u MHz core, %s time source (%s), tWC %u us\n", clockHz / 1000000,
+         DelayUtil::getTimeSource() == DelayUtil::SOURCE_DWT ? "DWT" : "SysTick",
+         DelayUtil::isCalibrated() ? "calibrated" : "calibration FAILED", timing.writeCycleNs / 1000);
+  benchBusPrimitives(eeprom);
+  printf("%-28s %6s %10s %10s %8s\n", "operation", "bytes", "sim ms", "bytes/s", "acc/byte");
+  allPassed &= DelayUtil::isCalibrated();
+
+  fillImage(1);
+
+  eeprom.resetInstrumentation();
+  Snapshot start = snapshot();
+  bool ok = eeprom.writeDataBlock(0, image, IMAGE_SIZE, EEPROMProgrammer::WRITE_MODE_PAGE);
+  report("writeDataBlock page+verify", IMAGE_SIZE, start, ok && chipHolds(0, image, IMAGE_SIZE));
+  printInstrumentation(eeprom.getInstrumentation());
+
+  start = snapshot();
+  ok = eeprom.verifyData(0, image, IMAGE_SIZE);
+  report("verifyData", IMAGE_SIZE, start, ok);
+
+  static uint8_t dumped[IMAGE_SIZE];
+  BufferSink dumpSink(dumped, IMAGE_SIZE);
+  start = snapshot();
+  eeprom.dump(0, IMAGE_SIZE, dumpSink);
+  ok = dumpSink.size() == IMAGE_SIZE && dumpSink.overflow() == 0 && memcmp(dumped, image, IMAGE_SIZE) == 0;
+  report("dump", IMAGE_SIZE, start, ok);
+
+  // Every mismatch is reported in the same pass
+  ArrayImage expectedImage(image, IMAGE_SIZE);
+  MismatchLog mismatches;
+  SimBoard::chip().contents()[77] ^= 0x01;
+  SimBoard::chip().contents()[30000] ^= 0x80;
+  start = snapshot();
+  ok = !eeprom.verify(0, expectedImage, IMAGE_SIZE, &mismatches);
+  ok = ok && mismatches.count == 2 && mismatches.addresses[0] == 77 && mismatches.addresses[1] == 30000;
+  report("verify with mismatches", IMAGE_SIZE, start, ok);
+  SimBoard::chip().contents()[77] ^= 0x01;
+  SimBoard::chip().contents()[30000] ^= 0x80;
+
+  // Timer + DMA engine; an unaligned range exercises the partial blocks
+  memset(dumped, 0, sizeof(dumped));
+  BufferSink burstSink(dumped, IMAGE_SIZE);
+  start = snapshot();
+  ok = burst.dump(0, IMAGE_SIZE, burstSink);
+  ok = ok && burstSink.size() == IMAGE_SIZE && memcmp(dumped, image, IMAGE_SIZE) == 0;
+  report("burst dump", IMAGE_SIZE, start, ok);
+  printf("  %u cycles per byte, samples %u cycles after the address request\n", burst.getPeriodCycles(),
+         burst.getSampleCycles());
+
+  BufferSink partialSink(dumped, IMAGE_SIZE);
+  start = snapshot();
+  ok = burst.dump(1000, 3001, partialSink);
+  report("burst dump unaligned", 3001, start, ok && memcmp(dumped, image + 1000, 3001) == 0);
+
+  MismatchLog burstMismatches;
+  SimBoard::chip().contents()[1023] ^= 0x04;
+  SimBoard::chip().contents()[1024] ^= 0x08;
+  start = snapshot();
+  ok = !burst.verify(0, expectedImage, IMAGE_SIZE, &burstMismatches);
+  ok = ok && burstMismatches.count == 2 && burstMismatches.addresses[0] == 1023 &&
+       burstMismatches.addresses[1] == 1024;
+  report("burst verify", IMAGE_SIZE, start, ok);
+  SimBoard::chip().contents()[1023] ^= 0x04;
+  SimBoard::chip().contents()[1024] ^= 0x08;
+
+  // Per-page CRCs as the build pipeline would emit them
+  static uint32_t pageCrcs[IMAGE_SIZE / EEPROMProgrammer::PAGE_SIZE];
+  for (uint32_t page = 0; page < IMAGE_SIZE / EEPROMProgrammer::PAGE_SIZE; page++)
+  {
+    pageCrcs[page] = HardwareCRC::compute(image + page * EEPROMProgrammer::PAGE_SIZE, EEPROMProgrammer::PAGE_SIZE);
+  }
+
+  EEPROMProgrammer::VerifyResult verifyResult;
+  ArrayImage crcImage(image, IMAGE_SIZE);
+  start = snapshot();
+  ok = eeprom.verifyPageCrcs(0, IMAGE_SIZE, pageCrcs, crcImage, &verifyResult);
+  report("verifyPageCrcs", IMAGE_SIZE, start, ok && verifyResult.pagesChecked == 512);
+
+  // Damage one byte and a three-byte run in another page, behind the
+  // programmer's back
+  uint8_t *cells = SimBoard::chip().contents();
+  cells[1234] ^= 0x40;
+  cells[9000] ^= 0x01;
+  cells[9001] ^= 0x02;
+  cells[9002] ^= 0x04;
+
+  start = snapshot();
+  ok = !eeprom.verifyPageCrcs(0, IMAGE_SIZE, pageCrcs, crcImage, &verifyResult);
+  ok = ok && verifyResult.pagesFailed == 2 && verifyResult.rangeCount == 2 && !verifyResult.truncated &&
+       verifyResult.ranges[0].start == 1234 && verifyResult.ranges[0].length == 1 &&
+       verifyResult.ranges[1].start == 9000 && verifyResult.ranges[1].length == 3;
+  report("verifyPageCrcs 2 bad pages", IMAGE_SIZE, start, ok);
+
+  cells[1234] ^= 0x40;
+  cells[9000] ^= 0x01;
+  cells[9001] ^= 0x02;
+  cells[9002] ^= 0x04;
+
+  // A small rebuild: four bytes in three pages change
+  image[100] ^= 0x01;
+  image[5000] ^= 0xFF;
+  image[5001] ^= 0x10;
+  image[20000] += 1;
+
+  start = snapshot();
+  uint32_t loadsBefore = SimBoard::chip().getStats().bytesLoaded;
+  ArrayImage changedImage(image, IMAGE_SIZE);
+  ok = eeprom.writeImageDifferential(0, changedImage, IMAGE_SIZE);
+  const EEPROMProgrammer::DiffStats &diff = eeprom.getLastDiffStats();
+  ok = ok && chipHolds(0, image, IMAGE_SIZE) && SimBoard::chip().getStats().bytesLoaded - loadsBefore == 4 &&
+       diff.pagesWritten == 3 && diff.bytesWritten == 4;
+  report("writeImageDifferential", IMAGE_SIZE, start, ok);
+  printf("  %u pages written, %u skipped; %u bytes written, %u skipped\n", diff.pagesWritten, diff.pagesSkipped,
+         diff.bytesWritten, diff.bytesSkipped);
+
+  fillImage(2);
+
+  start = snapshot();
+  ok = eeprom.writeDataBlock(0x1000, image, 4096, EEPROMProgrammer::WRITE_MODE_PAGE,
+                             EEPROMProgrammer::COMPLETION_TOGGLE_BIT);
+  report("writeDataBlock toggle bit", 4096, start, ok && chipHolds(0x1000, image, 4096));
+
+  start = snapshot();
+  ok = eeprom.writeDataBlock(0x2010, image, 256, EEPROMProgrammer::WRITE_MODE_BYTE);
+  report("writeDataBlock byte", 256, start, ok && chipHolds(0x2010, image, 256));
+
+  start = snapshot();
+  ok = eeprom.writeDataBlock(0x3000, image, 4096, EEPROMProgrammer::WRITE_MODE_PAGE_PROTECTED);
+  report("writeDataBlock SDP page", 4096, start, ok && chipHolds(0x3000, image, 4096) &&
+                                                      SimBoard::chip().isSdpEnabled());
+
+  // With protection on, a plain write must start a cycle but change nothing
+  start = snapshot();
+  uint8_t before = SimBoard::chip().contents()[0x3000];
+  ok = !eeprom.writeByte(0x3000, (uint8_t)~before) && SimBoard::chip().contents()[0x3000] == before;
+  report("SDP blocks plain write", 1, start, ok);
+
+  // Disabling protection takes a full write cycle before the next write
+  start = snapshot();
+  eeprom.disableSoftwareDataProtection();
+  DelayUtil::delayMicroseconds(timing.writeCycleNs / 1000);
+  ok = !SimBoard::chip().isSdpEnabled() && eeprom.writeByte(0x3000, (uint8_t)~before) &&
+       SimBoard::chip().contents()[0x3000] == (uint8_t)~before;
+  report("SDP disable + write", 1, start, ok);
+
+  benchCompressed(eeprom, "writeImage compressed low", exampleLowerCompressed, sizeof(exampleLowerCompressed),
+                  exampleLower, EXAMPLE_LOWER_SIZE, 0x4000);
+  benchCompressed(eeprom, "writeImage compressed high", exampleUpperCompressed, sizeof(exampleUpperCompressed),
+                  exampleUpper, EXAMPLE_UPPER_SIZE, 0x5000);
+
+  // The diagnostics benchmark served over the serial link, on a scratch region
+  EEPROMDiagnostics diagnostics(eeprom);
+  ProgrammingProtocol::BenchmarkResult benchmark;
+  diagnostics.runBenchmark(0x6000, 4096, benchmark);
+  printf("diagnostics benchmark, %u bytes: write %.0f, verify %.0f, dump %.0f bytes/s (%s)\n", benchmark.length,
+         benchmark.length * 1e6 / benchmark.writeMicros, benchmark.length * 1e6 / benchmark.verifyMicros,
+         benchmark.length * 1e6 / benchmark.dumpMicros, benchmark.status == ProgrammingProtocol::STATUS_OK ? "ok" : "FAILED");
+  allPassed &= benchmark.status == ProgrammingProtocol::STATUS_OK;
+
+  benchErase(eeprom);
+  benchDual(eeprom);
+  benchTiming(eeprom, timing);
+  benchJournal(eeprom);
+  benchManifest(eeprom);
+  benchSwap(eeprom);
+  benchCapture(eeprom);
+  benchEmulation(eeprom);
+
+  const SimBoard::Stats &boardStats = SimBoard::getStats();
+  for (int chip = EEPROMProgrammer::CHIP_LOWER; chip <= EEPROMProgrammer::CHIP_UPPER; chip++)
+  {
+    const Sim28C256::Stats &chipStats = SimBoard::chip((EEPROMProgrammer::Chip)chip).getStats();
+    printf("%s chip: %u bytes loaded, %u write cycles (%u blocked), %u status reads\n",
+           chip == EEPROMProgrammer::CHIP_LOWER ? "lower" : "upper", chipStats.bytesLoaded, chipStats.writeCycles,
+           chipStats.blockedWrites, chipStats.statusReads);
+    printf("  violations: %u timing, %u early reads, %u page, %u loads while busy\n", chipStats.timingViolations,
+           chipStats.earlyReads, chipStats.pageViolations, chipStats.loadsWhileBusy);
+    uint32_t earlyReadsAllowed = chip == EEPROMProgrammer::CHIP_LOWER ? expectedEarlyReads : 0;
+    allPassed &= chipStats.timingViolations == 0 && chipStats.earlyReads == earlyReadsAllowed &&
+                 chipStats.pageViolations == 0 && chipStats.loadsWhileBusy == 0;
+  }
+  printf("dma: %u transfers\n", boardStats.dmaTransfers);
+  printf("flash: %u halfwords programmed, %u pages erased, %u errors\n", boardStats.flashPrograms,
+         boardStats.flashErases, boardStats.flashErrors);
+  printf("bus contention: %u\n", boardStats.busContention);
+  allPassed &= boardStats.busContention == 0;
+
+  printf("%s\n", allPassed ? "PASS" : "FAIL");
+  return allPassed ? 0 : 1;
+}
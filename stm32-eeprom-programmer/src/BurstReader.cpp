@@ -0,0 +1,282 @@
+#include "BurstReader.h"
+#include "DelayUtil.h"
+
+namespace
+{
+  // The engine relies on A0-A9 being the only address pins on GPIOA and on
+  // the data pins sitting on GPIOB/GPIOC
+  constexpr bool addressSplitsAtA10()
+  {
+    for (int bit = 0; bit < 15; bit++)
+    {
+      if ((EEPROMProgrammer::ADDRESS_PINS[bit].port == PIN_PORT_A) != (bit < 10))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static_assert(addressSplitsAtA10(), "BurstReader needs A0-A9 on GPIOA and A10-A14 elsewhere");
+  static_assert(PinMap::portMask(EEPROMProgrammer::DATA_PINS, PIN_PORT_A) == 0,
+                "BurstReader samples data pins on GPIOB and GPIOC only");
+
+  // GPIOA BSRR word for every value of A0-A9, built at compile time into flash
+  struct AddressWords
+  {
+    uint32_t word[BurstReader::TABLE_SIZE];
+  };
+
+  constexpr AddressWords addressWords()
+  {
+    AddressWords table = {};
+    uint16_t mask = PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, PIN_PORT_A);
+    for (uint16_t address = 0; address < BurstReader::TABLE_SIZE; address++)
+    {
+      uint16_t set = 0;
+      for (int bit = 0; bit < 10; bit++)
+      {
+        if (address & (1u << bit))
+        {
+          set |= EEPROMProgrammer::ADDRESS_PINS[bit].pin;
+        }
+      }
+      table.word[address] = PinMap::bsrr(set, mask);
+    }
+    return table;
+  }
+
+  constexpr AddressWords ADDRESS_WORDS = addressWords();
+
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> gatherLow = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, false);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> gatherHigh = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, true);
+
+  inline uint8_t sampleToByte(uint16_t idrB, uint16_t idrC)
+  {
+    return gatherLow<PIN_PORT_B>.bits[idrB & 0xFF] | gatherHigh<PIN_PORT_B>.bits[idrB >> 8] |
+           gatherLow<PIN_PORT_C>.bits[idrC & 0xFF] | gatherHigh<PIN_PORT_C>.bits[idrC >> 8];
+  }
+
+  // Compares burst data with an image as it arrives
+  class VerifyingSink : public DataSink
+  {
+  public:
+    VerifyingSink(ImageSource &source, MismatchSink *mismatches)
+        : source(source), mismatches(mismatches), match(true)
+    {
+    }
+
+    void write(uint16_t address, const uint8_t *data, uint16_t length) override
+    {
+      uint8_t expected[EEPROMProgrammer::STREAM_CHUNK_SIZE];
+      if (source.read(expected, length) != length)
+      {
+        match = false;
+        return;
+      }
+
+      for (uint16_t i = 0; i < length; i++)
+      {
+        if (data[i] != expected[i])
+        {
+          match = false;
+          if (mismatches != nullptr)
+          {
+            mismatches->mismatch(address + i, expected[i], data[i]);
+          }
+        }
+      }
+    }
+
+    ImageSource &source;
+    MismatchSink *mismatches;
+    bool match;
+  };
+
+  const uint32_t DMA_PRIORITY_VERY_HIGH = DMA_CCR_PL_1 | DMA_CCR_PL_0;
+}
+
+BurstReader::BurstReader(EEPROMProgrammer &programmer)
+    : programmer(programmer), periodCycles(0), sampleCycles(0)
+{
+}
+
+void BurstReader::begin()
+{
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  // The samples wait for the address transfer plus tACC, with one cycle
+  // for the compare event. Each period moves three words over the DMA, and
+  // the second sample must land before the next address does.
+  uint32_t accessCycles =
+      (uint32_t)(((uint64_t)EEPROMProgrammer::T_ACC_NS * SystemCoreClock + 999999999) / 1000000000);
+  sampleCycles = DMA_TRANSFER_CYCLES + accessCycles + 1;
+  periodCycles = 3 * DMA_TRANSFER_CYCLES;
+  if (periodCycles < sampleCycles + DMA_TRANSFER_CYCLES)
+  {
+    periodCycles = sampleCycles + DMA_TRANSFER_CYCLES;
+  }
+}
+
+bool BurstReader::dump(uint16_t startAddress, uint16_t length, DataSink &sink)
+{
+  return run(startAddress, length, sink, false);
+}
+
+bool BurstReader::verify(uint16_t startAddress, ImageSource &source, uint16_t length, MismatchSink *mismatches)
+{
+  VerifyingSink checker(source, mismatches);
+  source.rewind();
+  bool finished = run(startAddress, length, checker, true);
+  return finished && checker.match;
+}
+
+uint32_t BurstReader::getPeriodCycles() const
+{
+  return periodCycles;
+}
+
+uint32_t BurstReader::getSampleCycles() const
+{
+  return sampleCycles;
+}
+
+bool BurstReader::run(uint16_t startAddress, uint16_t length, DataSink &sink, bool shouldDelay)
+{
+  programmer.beginRead();
+
+  TIM2->CR1 = 0;
+  TIM2->PSC = 0;
+  TIM2->ARR = periodCycles - 1;
+  TIM2->CCR3 = sampleCycles;
+  TIM2->CCR4 = sampleCycles;
+  TIM2->DIER = TIM_DIER_UDE | TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+
+  // Block k samples into buffer k & 1 while block k - 1 is remapped
+  bool finished = true;
+  int buffer = 0;
+  uint16_t previousAddress = 0;
+  uint16_t previousCount = 0;
+  for (uint16_t offset = 0; finished && (offset < length || previousCount > 0); buffer ^= 1)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t count = 0;
+    if (offset < length)
+    {
+      count = BLOCK_SIZE - (address & (BLOCK_SIZE - 1));
+      if (count > length - offset)
+      {
+        count = length - offset;
+      }
+      startBlock(address, count, buffer, shouldDelay && offset == 0);
+    }
+
+    if (previousCount > 0)
+    {
+      emitBlock(previousAddress, previousCount, buffer ^ 1, sink);
+    }
+
+    if (count > 0)
+    {
+      finished = finishBlock();
+    }
+
+    previousAddress = address;
+    previousCount = count;
+    offset += count;
+  }
+
+  stop();
+  programmer.endRead();
+
+  return finished;
+}
+
+void BurstReader::startBlock(uint16_t address, uint16_t count, int buffer, bool shouldDelay)
+{
+  // The CPU sets A10-A14 for the block and the first byte's A0-A9; the
+  // first compare event samples it, and each update moves to the next byte
+  programmer.setAddress(address);
+  if (shouldDelay)
+  {
+    DelayUtil::delayCycles(programmer.getTimingProfile().firstReadCycles);
+  }
+
+  DMA1_Channel1->CCR = 0;
+  DMA1_Channel2->CCR = 0;
+  DMA1_Channel7->CCR = 0;
+  DMA1->IFCR = DMA_IFCR_CGIF1 | DMA_IFCR_CGIF2 | DMA_IFCR_CGIF7;
+
+  DMA1_Channel1->CPAR = (uintptr_t)&GPIOB->IDR;
+  DMA1_Channel1->CMAR = (uintptr_t)samplesB[buffer];
+  DMA1_Channel1->CNDTR = count;
+  DMA1_Channel1->CCR = DMA_PRIORITY_VERY_HIGH | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_EN;
+
+  DMA1_Channel7->CPAR = (uintptr_t)&GPIOC->IDR;
+  DMA1_Channel7->CMAR = (uintptr_t)samplesC[buffer];
+  DMA1_Channel7->CNDTR = count;
+  DMA1_Channel7->CCR = DMA_PRIORITY_VERY_HIGH | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_EN;
+
+  // Blocks never cross a table period, so the words are contiguous
+  if (count > 1)
+  {
+    DMA1_Channel2->CPAR = (uintptr_t)&GPIOA->BSRR;
+    DMA1_Channel2->CMAR = (uintptr_t)&ADDRESS_WORDS.word[(address + 1) & (TABLE_SIZE - 1)];
+    DMA1_Channel2->CNDTR = count - 1;
+    DMA1_Channel2->CCR = DMA_PRIORITY_VERY_HIGH | DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_DIR |
+                         DMA_CCR_EN;
+  }
+
+  TIM2->CNT = 0;
+  TIM2->CR1 = TIM_CR1_CEN;
+}
+
+bool BurstReader::finishBlock()
+{
+  const uint32_t done = DMA_ISR_TCIF1 | DMA_ISR_TCIF7;
+  const uint32_t errors = DMA_ISR_TEIF1 | DMA_ISR_TEIF2 | DMA_ISR_TEIF7;
+
+  uint32_t start = DelayUtil::cycles();
+  uint32_t timeout = DelayUtil::microsecondsToCycles(BLOCK_TIMEOUT_US);
+  uint32_t status;
+  do
+  {
+    status = DMA1->ISR;
+    if ((status & errors) || DelayUtil::cycles() - start > timeout)
+    {
+      return false;
+    }
+  } while ((status & done) != done);
+
+  TIM2->CR1 = 0;
+  return true;
+}
+
+void BurstReader::stop()
+{
+  TIM2->CR1 = 0;
+  TIM2->DIER = 0;
+  DMA1_Channel1->CCR = 0;
+  DMA1_Channel2->CCR = 0;
+  DMA1_Channel7->CCR = 0;
+  DMA1->IFCR = DMA_IFCR_CGIF1 | DMA_IFCR_CGIF2 | DMA_IFCR_CGIF7;
+}
+
+void BurstReader::emitBlock(uint16_t address, uint16_t count, int buffer, DataSink &sink)
+{
+  uint8_t chunk[EEPROMProgrammer::STREAM_CHUNK_SIZE];
+
+  for (uint16_t offset = 0; offset < count; offset += EEPROMProgrammer::STREAM_CHUNK_SIZE)
+  {
+    uint16_t length = count - offset < EEPROMProgrammer::STREAM_CHUNK_SIZE ? count - offset
+                                                                          : EEPROMProgrammer::STREAM_CHUNK_SIZE;
+    for (uint16_t i = 0; i < length; i++)
+    {
+      chunk[i] = sampleToByte(samplesB[buffer][offset + i], samplesC[buffer][offset + i]);
+    }
+    sink.write(address + offset, chunk, length);
+  }
+}
@@ -0,0 +1,232 @@
+#include "BusCapture.h"
+#include "DelayUtil.h"
+
+namespace
+{
+  static_assert(PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, PIN_PORT_C) == 0 &&
+                    PinMap::portMask(EEPROMProgrammer::DATA_PINS, PIN_PORT_A) == 0,
+                "BusCapture reads the address from GPIOA/GPIOB and the data from GPIOB/GPIOC");
+  static_assert((BusCapture::DEPTH & (BusCapture::DEPTH - 1)) == 0, "DEPTH must be a power of two");
+
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint16_t> addressLow =
+      PinMap::gather<uint16_t>(EEPROMProgrammer::ADDRESS_PINS, port, false);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint16_t> addressHigh =
+      PinMap::gather<uint16_t>(EEPROMProgrammer::ADDRESS_PINS, port, true);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> dataLow = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, false);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> dataHigh = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, true);
+
+  // Pins of one port that carry the given address
+  uint16_t addressPins(uint16_t address, uint8_t port)
+  {
+    uint16_t pins = 0;
+    for (int bit = 0; bit < 15; bit++)
+    {
+      const PinDef &pin = EEPROMProgrammer::ADDRESS_PINS[bit];
+      if (pin.port == port && (address & (1u << bit)))
+      {
+        pins |= pin.pin;
+      }
+    }
+    return pins;
+  }
+
+  const uint32_t DMA_PRIORITY_VERY_HIGH = DMA_CCR_PL_1 | DMA_CCR_PL_0;
+  const uint32_t SAMPLE_CCR =
+      DMA_PRIORITY_VERY_HIGH | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_EN;
+}
+
+BusCapture::BusCapture(EEPROMProgrammer &programmer, SharedBuffer &buffer)
+    : programmer(programmer), buffer(buffer), firstSlot(0), sampleCount(0)
+{
+}
+
+void BusCapture::begin()
+{
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+}
+
+bool BusCapture::capture(const Settings &settings, Result &result)
+{
+  uint32_t periodCycles = MAX_PERIOD_CYCLES;
+  if (settings.sampleRateHz > 0)
+  {
+    periodCycles = (SystemCoreClock + settings.sampleRateHz / 2) / settings.sampleRateHz;
+  }
+  if (periodCycles < MIN_PERIOD_CYCLES)
+  {
+    periodCycles = MIN_PERIOD_CYCLES;
+  }
+  if (periodCycles > MAX_PERIOD_CYCLES)
+  {
+    periodCycles = MAX_PERIOD_CYCLES;
+  }
+  uint16_t preTrigger = settings.preTrigger < DEPTH - 2 ? settings.preTrigger : DEPTH - 2;
+
+  // The trigger compares raw port words, so the scan needs no decoding
+  const uint16_t maskA = PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, PIN_PORT_A);
+  const uint16_t maskB = PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, PIN_PORT_B);
+  uint16_t matchA = addressPins(settings.triggerAddress, PIN_PORT_A);
+  uint16_t matchB = addressPins(settings.triggerAddress, PIN_PORT_B);
+
+  result.triggered = false;
+  result.triggerIndex = 0;
+  result.periodCycles = periodCycles;
+  result.missedSamples = 0;
+
+  buffer.take(this);
+  Buffers &raw = buffers();
+  programmer.releaseBus();
+  start(periodCycles);
+
+  // Samples are counted from the start; slot = count % DEPTH
+  uint32_t total = 0;
+  uint16_t lastSlot = 0;
+  uint32_t scanned = preTrigger; // Armed once the pre-trigger samples are in
+  uint32_t triggerAt = 0;
+  uint32_t stopAt = settings.useTrigger ? UINT32_MAX : DEPTH - 1;
+  bool timedOut = false;
+
+  uint32_t timeoutUs = settings.timeoutUs < MAX_TIMEOUT_US ? settings.timeoutUs : MAX_TIMEOUT_US;
+  uint32_t timeout = DelayUtil::microsecondsToCycles(timeoutUs);
+  uint32_t started = DelayUtil::cycles();
+  while (total < stopAt)
+  {
+    total = countWritten(total, lastSlot);
+
+    if (settings.useTrigger && !result.triggered)
+    {
+      // Unchecked samples are about to be overwritten: skip to the newest
+      if (total > scanned + DEPTH / 2)
+      {
+        result.missedSamples += total - scanned;
+        scanned = total;
+      }
+
+      for (; scanned < total; scanned++)
+      {
+        uint16_t slot = scanned & (DEPTH - 1);
+        if ((raw.samplesA[slot] & maskA) == matchA && (raw.samplesB[slot] & maskB) == matchB)
+        {
+          result.triggered = true;
+          triggerAt = scanned;
+          stopAt = scanned + DEPTH - 1 - preTrigger;
+          break;
+        }
+      }
+    }
+
+    if (DelayUtil::cycles() - started > timeout)
+    {
+      timedOut = true;
+      break;
+    }
+  }
+
+  stop();
+  total = countWritten(total, lastSlot);
+
+  // Keep the newest DEPTH - 1 samples: the oldest slot may already hold the
+  // first port of the sample that was in flight at the stop
+  sampleCount = total < DEPTH - 1 ? (uint16_t)total : DEPTH - 1;
+  firstSlot = (uint16_t)((total - sampleCount) & (DEPTH - 1));
+  result.sampleCount = sampleCount;
+
+  if (result.triggered)
+  {
+    uint32_t oldest = total - sampleCount;
+    result.triggered = triggerAt >= oldest;
+    result.triggerIndex = result.triggered ? (uint16_t)(triggerAt - oldest) : 0;
+  }
+
+  return settings.useTrigger ? result.triggered : !timedOut;
+}
+
+uint16_t BusCapture::readSamples(uint16_t index, Sample *samples, uint16_t count) const
+{
+  if (!buffer.heldBy(this) || index >= sampleCount)
+  {
+    return 0;
+  }
+  if (count > sampleCount - index)
+  {
+    count = sampleCount - index;
+  }
+
+  const Buffers &raw = buffers();
+  for (uint16_t i = 0; i < count; i++)
+  {
+    uint16_t slot = (firstSlot + index + i) & (DEPTH - 1);
+    uint16_t a = raw.samplesA[slot];
+    uint16_t b = raw.samplesB[slot];
+    uint16_t c = raw.samplesC[slot];
+
+    samples[i].address = addressLow<PIN_PORT_A>.bits[a & 0xFF] | addressHigh<PIN_PORT_A>.bits[a >> 8] |
+                         addressLow<PIN_PORT_B>.bits[b & 0xFF] | addressHigh<PIN_PORT_B>.bits[b >> 8];
+    samples[i].data = dataLow<PIN_PORT_B>.bits[b & 0xFF] | dataHigh<PIN_PORT_B>.bits[b >> 8] |
+                      dataLow<PIN_PORT_C>.bits[c & 0xFF] | dataHigh<PIN_PORT_C>.bits[c >> 8];
+    samples[i].control = ((a & EEPROMProgrammer::EEPROM_CE_PIN) ? CONTROL_CE : 0) |
+                         ((a & EEPROMProgrammer::EEPROM_OE_PIN) ? CONTROL_OE : 0) |
+                         ((a & EEPROMProgrammer::EEPROM_WE_PIN) ? CONTROL_WE : 0);
+  }
+  return count;
+}
+
+uint32_t BusCapture::countWritten(uint32_t total, uint16_t &lastSlot) const
+{
+  // Channel 7 is served last on every request, so its count covers whole samples
+  uint16_t slot = (uint16_t)((DEPTH - DMA1_Channel7->CNDTR) & (DEPTH - 1));
+  total += (uint16_t)(slot - lastSlot) & (DEPTH - 1);
+  lastSlot = slot;
+  return total;
+}
+
+void BusCapture::start(uint32_t periodCycles)
+{
+  TIM2->CR1 = 0;
+  TIM2->PSC = 0;
+  TIM2->ARR = periodCycles - 1;
+  TIM2->CCR3 = 0;
+  TIM2->CCR4 = 0;
+  TIM2->DIER = TIM_DIER_UDE | TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+
+  DMA1_Channel1->CCR = 0;
+  DMA1_Channel2->CCR = 0;
+  DMA1_Channel7->CCR = 0;
+  DMA1->IFCR = DMA_IFCR_CGIF1 | DMA_IFCR_CGIF2 | DMA_IFCR_CGIF7;
+
+  // All three requests come on the same counter value and are served in
+  // channel order: GPIOA (CC3), GPIOB (update), GPIOC (CC4)
+  Buffers &raw = buffers();
+  DMA1_Channel1->CPAR = (uintptr_t)&GPIOA->IDR;
+  DMA1_Channel1->CMAR = (uintptr_t)raw.samplesA;
+  DMA1_Channel1->CNDTR = DEPTH;
+  DMA1_Channel1->CCR = SAMPLE_CCR;
+
+  DMA1_Channel2->CPAR = (uintptr_t)&GPIOB->IDR;
+  DMA1_Channel2->CMAR = (uintptr_t)raw.samplesB;
+  DMA1_Channel2->CNDTR = DEPTH;
+  DMA1_Channel2->CCR = SAMPLE_CCR;
+
+  DMA1_Channel7->CPAR = (uintptr_t)&GPIOC->IDR;
+  DMA1_Channel7->CMAR = (uintptr_t)raw.samplesC;
+  DMA1_Channel7->CNDTR = DEPTH;
+  DMA1_Channel7->CCR = SAMPLE_CCR;
+
+  TIM2->CNT = 0;
+  TIM2->CR1 = TIM_CR1_CEN;
+}
+
+void BusCapture::stop()
+{
+  TIM2->CR1 = 0;
+  TIM2->DIER = 0;
+  DMA1_Channel1->CCR = 0;
+  DMA1_Channel2->CCR = 0;
+  DMA1_Channel7->CCR = 0;
+  DMA1->IFCR = DMA_IFCR_CGIF1 | DMA_IFCR_CGIF2 | DMA_IFCR_CGIF7;
+}
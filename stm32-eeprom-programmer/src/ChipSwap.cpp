@@ -0,0 +1,149 @@
+#include "ChipSwap.h"
+#include "DelayUtil.h"
+
+#include <string.h>
+
+ChipSwap::ChipSwap(EEPROMProgrammer &programmer, ByteStream *console) : programmer(programmer), console(console)
+{
+}
+
+void ChipSwap::begin()
+{
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+
+  GPIO_InitTypeDef init = {0};
+  init.Pin = BUTTON_PIN;
+  init.Mode = GPIO_MODE_INPUT;
+  init.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(GPIOB, &init);
+}
+
+bool ChipSwap::run(const WordImage &image)
+{
+  print("Burning the lower chip\r\n");
+  if (!burn(image, LaneImage::LANE_LOW))
+  {
+    print("Lower chip FAILED\r\n");
+    return false;
+  }
+
+  print("Insert the upper chip, then press the button or send any key\r\n");
+  waitForSwap(image);
+
+  print("Burning the upper chip\r\n");
+  if (!burn(image, LaneImage::LANE_HIGH))
+  {
+    print("Upper chip FAILED\r\n");
+    return false;
+  }
+
+  print("Both chips done\r\n");
+  return true;
+}
+
+bool ChipSwap::burn(const WordImage &image, LaneImage::Lane lane)
+{
+  LaneImage source(*image.words, lane);
+  EEPROMProgrammer::VerifyResult result;
+  return programmer.writeImageManifest(image.start, source, image.length, image.pageCrcs[lane],
+                                       image.imageIds[lane]) &&
+         programmer.verifyPageCrcs(image.start, image.length, image.pageCrcs[lane], source, &result);
+}
+
+void ChipSwap::waitForSwap(const WordImage &image)
+{
+  // Bytes that came in while the lower chip was written do not count
+  while (console != nullptr && console->read() >= 0)
+  {
+  }
+
+  // Lanes that start alike cannot tell the chips apart
+  bool distinct = image.pageCrcs[LaneImage::LANE_LOW][0] != image.pageCrcs[LaneImage::LANE_HIGH][0];
+
+  bool led = false;
+  uint32_t blinkCycles = DelayUtil::microsecondsToCycles(BLINK_MS * 1000);
+  uint32_t lastBlink = DelayUtil::cycles();
+  for (;;)
+  {
+    if (DelayUtil::cycles() - lastBlink >= blinkCycles)
+    {
+      led = !led;
+      if (led)
+      {
+        programmer.setPinLow(programmer.ledPort, EEPROMProgrammer::STATUS_LED_PIN);
+      }
+      else
+      {
+        programmer.setPinHigh(programmer.ledPort, EEPROMProgrammer::STATUS_LED_PIN);
+      }
+      lastBlink += blinkCycles;
+    }
+
+    if (!confirmed())
+    {
+      continue;
+    }
+
+    // Let go of the button before it can count again
+    while (buttonDown())
+    {
+    }
+
+    if (!distinct || !holdsLane(image, LaneImage::LANE_LOW))
+    {
+      break;
+    }
+    print("That is still the lower chip\r\n");
+  }
+
+  programmer.setPinHigh(programmer.ledPort, EEPROMProgrammer::STATUS_LED_PIN);
+}
+
+bool ChipSwap::holdsLane(const WordImage &image, LaneImage::Lane lane)
+{
+  uint16_t firstPage = EEPROMProgrammer::PAGE_SIZE - (image.start & EEPROMProgrammer::PAGE_MASK);
+  if (firstPage > image.length)
+  {
+    firstPage = image.length;
+  }
+
+  LaneImage source(*image.words, lane);
+  EEPROMProgrammer::VerifyResult result;
+  return programmer.verifyPageCrcs(image.start, firstPage, image.pageCrcs[lane], source, &result);
+}
+
+bool ChipSwap::confirmed()
+{
+  if (console != nullptr && console->read() >= 0)
+  {
+    return true;
+  }
+  if (!buttonDown())
+  {
+    return false;
+  }
+
+  uint32_t debounce = DelayUtil::microsecondsToCycles(DEBOUNCE_MS * 1000);
+  uint32_t pressed = DelayUtil::cycles();
+  while (DelayUtil::cycles() - pressed < debounce)
+  {
+    if (!buttonDown())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ChipSwap::buttonDown()
+{
+  return (GPIOB->IDR & BUTTON_PIN) == 0;
+}
+
+void ChipSwap::print(const char *text)
+{
+  if (console != nullptr)
+  {
+    console->write((const uint8_t *)text, (uint16_t)strlen(text));
+  }
+}
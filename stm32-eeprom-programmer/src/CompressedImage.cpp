@@ -0,0 +1,81 @@
+#include "CompressedImage.h"
+
+CompressedImage::CompressedImage(const uint8_t *data, uint32_t size)
+    : data(data), size(size)
+{
+  rewind();
+}
+
+void CompressedImage::rewind()
+{
+  position = 0;
+  windowHead = 0;
+  flags = 0;
+  flagsLeft = 0;
+  matchDistance = 0;
+  matchLeft = 0;
+
+  // Distances that reach before the start decode as zeros, on every pass
+  for (uint16_t i = 0; i < WINDOW_SIZE; i++)
+  {
+    window[i] = 0;
+  }
+}
+
+uint16_t CompressedImage::read(uint8_t *out, uint16_t length)
+{
+  uint16_t count = 0;
+
+  while (count < length)
+  {
+    uint8_t byte;
+
+    if (matchLeft > 0)
+    {
+      byte = window[(windowHead - matchDistance) & WINDOW_MASK];
+      matchLeft--;
+    }
+    else
+    {
+      if (flagsLeft == 0)
+      {
+        if (position >= size)
+        {
+          break;
+        }
+        flags = data[position++];
+        flagsLeft = 8;
+      }
+
+      bool isMatch = flags & 1;
+      flags >>= 1;
+      flagsLeft--;
+
+      if (isMatch)
+      {
+        if (position + 2 > size)
+        {
+          break;
+        }
+        uint16_t token = data[position] | (data[position + 1] << 8);
+        position += 2;
+
+        matchDistance = (token & WINDOW_MASK) + 1;
+        matchLeft = (token >> 10) + MIN_MATCH;
+        continue;
+      }
+
+      if (position >= size)
+      {
+        break;
+      }
+      byte = data[position++];
+    }
+
+    window[windowHead] = byte;
+    windowHead = (windowHead + 1) & WINDOW_MASK;
+    out[count++] = byte;
+  }
+
+  return count;
+}
@@ -0,0 +1,43 @@
+#include "DataSink.h"
+
+StreamSink::StreamSink(ByteStream &stream)
+    : stream(stream)
+{
+}
+
+void StreamSink::write(uint16_t address, const uint8_t *data, uint16_t length)
+{
+  (void)address;
+  stream.write(data, length);
+}
+
+BufferSink::BufferSink(uint8_t *buffer, uint16_t capacity)
+    : buffer(buffer), capacity(capacity), used(0), dropped(0)
+{
+}
+
+void BufferSink::write(uint16_t address, const uint8_t *data, uint16_t length)
+{
+  (void)address;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (used < capacity)
+    {
+      buffer[used++] = data[i];
+    }
+    else
+    {
+      dropped++;
+    }
+  }
+}
+
+uint16_t BufferSink::size() const
+{
+  return used;
+}
+
+uint16_t BufferSink::overflow() const
+{
+  return dropped;
+}
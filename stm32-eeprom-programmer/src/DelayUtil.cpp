@@ -1,22 +1,215 @@
 #include "DelayUtil.h"
 
-void DelayUtil::delay(uint32_t cycles)
+DelayUtil::TimeSource DelayUtil::source = DelayUtil::SOURCE_DWT;
+bool DelayUtil::calibrated = false;
+uint32_t DelayUtil::cyclesPerMicrosecond = 8; // HSI until begin() reads the real clock
+uint32_t DelayUtil::overheadCycles = 0;
+uint32_t DelayUtil::lastSysTick = 0;
+uint32_t DelayUtil::sysTickCycles = 0;
+
+bool DelayUtil::begin()
+{
+  SystemCoreClockUpdate();
+  cyclesPerMicrosecond = SystemCoreClock / 1000000;
+
+  // SysTick free-running over its full 24 bits, no interrupt. It is the
+  // fallback time source.
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  lastSysTick = sysTickValue();
+  sysTickCycles = 0;
+
+  // Enable the Cortex-M3 cycle counter. Some F103 clones do not implement it,
+  // so check that it actually advances before relying on it.
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  uint32_t sysTickStart = sysTickValue();
+  while (((sysTickStart - sysTickValue()) & SysTick_LOAD_RELOAD_Msk) < 100)
+  {
+  }
+  source = DWT->CYCCNT != 0 ? SOURCE_DWT : SOURCE_SYSTICK;
+
+  // Measure the fixed cost of a delay call so short waits are not padded twice
+  overheadCycles = 0;
+  uint32_t start = cycles();
+  delayCycles(0);
+  overheadCycles = cycles() - start;
+
+  calibrated = checkCalibration();
+  return calibrated;
+}
+
+bool DelayUtil::isCalibrated()
+{
+  return calibrated;
+}
+
+DelayUtil::TimeSource DelayUtil::getTimeSource()
+{
+  return source;
+}
+
+bool DelayUtil::checkCalibration()
+{
+  // The delay loop must take what it was asked for on the selected source.
+  // DWT and SysTick both count HCLK, so this alone cannot tell whether
+  // SystemCoreClock is right; checkCoreClock() does that.
+  uint32_t expected = microsecondsToCycles(CALIBRATION_US);
+  uint32_t tolerance = expected * CALIBRATION_TOLERANCE_PERCENT / 100 + overheadCycles;
+
+  uint32_t start = cycles();
+  delayMicroseconds(CALIBRATION_US);
+  uint32_t measured = cycles() - start;
+
+  return measured >= expected && measured - expected <= tolerance && checkCoreClock();
+}
+
+bool DelayUtil::checkCoreClock()
+{
+  // The RTC prescaler runs from LSE, LSI or HSE / 128, none of them HCLK.
+  // The backup domain keeps its clock selection, so only pick one if none
+  // is set yet; LSI needs no crystal and starts within microseconds.
+  RCC->APB1ENR |= RCC_APB1ENR_PWREN | RCC_APB1ENR_BKPEN;
+  PWR->CR |= PWR_CR_DBP;
+
+  uint32_t timeout = microsecondsToCycles(REFERENCE_TIMEOUT_US);
+  uint32_t start = cycles();
+  if ((RCC->BDCR & RCC_BDCR_RTCSEL) == 0)
+  {
+    RCC->CSR |= RCC_CSR_LSION;
+    while (!(RCC->CSR & RCC_CSR_LSIRDY))
+    {
+      if (cycles() - start >= timeout)
+      {
+        return false;
+      }
+    }
+    RCC->BDCR |= RCC_BDCR_RTCSEL_LSI;
+  }
+  RCC->BDCR |= RCC_BDCR_RTCEN;
+
+  // LSI is only specified to 30-60 kHz; that still tells 72 MHz from 8 MHz
+  uint32_t minHz = REFERENCE_LSI_MIN_HZ;
+  uint32_t maxHz = REFERENCE_LSI_MAX_HZ;
+  uint32_t select = RCC->BDCR & RCC_BDCR_RTCSEL;
+  if (select != RCC_BDCR_RTCSEL_LSI)
+  {
+    uint32_t nominal = select == RCC_BDCR_RTCSEL_LSE ? REFERENCE_LSE_HZ : HSE_VALUE / 128;
+    minHz = nominal - nominal * REFERENCE_CRYSTAL_TOLERANCE_PERCENT / 100;
+    maxHz = nominal + nominal * REFERENCE_CRYSTAL_TOLERANCE_PERCENT / 100;
+  }
+
+  // The prescaler divider steps once per RTC clock; reads are valid once
+  // the APB interface has resynchronized
+  RTC->CRL &= ~(uint32_t)RTC_CRL_RSF;
+  while (!(RTC->CRL & RTC_CRL_RSF))
+  {
+    if (cycles() - start >= timeout)
+    {
+      return false;
+    }
+  }
+
+  // Start on a step, then count core cycles across REFERENCE_TICKS more
+  uint32_t last = RTC->DIVL;
+  uint32_t ticks = 0;
+  uint32_t first = 0;
+  while (ticks <= REFERENCE_TICKS)
+  {
+    uint32_t now = RTC->DIVL;
+    if (now != last)
+    {
+      if (ticks == 0)
+      {
+        first = cycles();
+      }
+      ticks++;
+      last = now;
+    }
+    if (cycles() - start >= timeout)
+    {
+      return false;
+    }
+  }
+  uint32_t measured = cycles() - first;
+
+  uint64_t coreHz = (uint64_t)cyclesPerMicrosecond * 1000000;
+  return measured >= coreHz * REFERENCE_TICKS / maxHz && measured <= coreHz * REFERENCE_TICKS / minHz;
+}
+
+void DelayUtil::delayCycles(uint32_t cycles)
 {
-  volatile uint32_t delay_count;
-  for (delay_count = 0; delay_count < cycles; delay_count++)
+  uint32_t start = DelayUtil::cycles();
+
+  if (cycles <= overheadCycles)
+  {
+    return;
+  }
+  cycles -= overheadCycles;
+
+  while (DelayUtil::cycles() - start < cycles)
   {
-    // Busy wait loop
   }
 }
 
+void DelayUtil::delayNanoseconds(uint32_t nanoseconds)
+{
+  delayCycles(nanosecondsToCycles(nanoseconds));
+}
+
 void DelayUtil::delayMicroseconds(uint32_t microseconds)
 {
-  uint32_t cycles = microseconds * CYCLES_PER_MICROSECOND;
-  delay(cycles);
+  delayCycles(microsecondsToCycles(microseconds));
 }
 
 void DelayUtil::delayMilliseconds(uint32_t milliseconds)
 {
-  uint32_t cycles = milliseconds * CYCLES_PER_MILLISECOND;
-  delay(cycles);
+  // One millisecond at a time so long delays cannot overflow the cycle count
+  for (uint32_t i = 0; i < milliseconds; i++)
+  {
+    delayMicroseconds(1000);
+  }
+}
+
+uint32_t DelayUtil::cycles()
+{
+  if (source == SOURCE_DWT)
+  {
+    return DWT->CYCCNT;
+  }
+
+  // Extend the 24-bit down-counting SysTick into a 32-bit up counter
+  uint32_t now = sysTickValue();
+  sysTickCycles += (lastSysTick - now) & SysTick_LOAD_RELOAD_Msk;
+  lastSysTick = now;
+  return sysTickCycles;
+}
+
+uint32_t DelayUtil::nanosecondsToCycles(uint32_t nanoseconds)
+{
+  // Round up so a wait is never shorter than the datasheet minimum
+  return (nanoseconds * cyclesPerMicrosecond + 999) / 1000;
+}
+
+uint32_t DelayUtil::microsecondsToCycles(uint32_t microseconds)
+{
+  return microseconds * cyclesPerMicrosecond;
+}
+
+uint32_t DelayUtil::cyclesToMicroseconds(uint32_t cycles)
+{
+  return cycles / cyclesPerMicrosecond;
+}
+
+uint32_t DelayUtil::cyclesToNanoseconds(uint32_t cycles)
+{
+  return (uint32_t)((uint64_t)cycles * 1000 / cyclesPerMicrosecond);
+}
+
+uint32_t DelayUtil::sysTickValue()
+{
+  return SysTick->VAL;
 }
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "EEPROMDiagnostics.h"
+#include "DelayUtil.h"
+
+using namespace ProgrammingProtocol;
+
+static_assert(Instrumentation::PHASE_COUNT == STATS_PHASES, "phase list differs from the protocol");
+static_assert(BusCapture::CONTROL_CE == CAPTURE_CE && BusCapture::CONTROL_OE == CAPTURE_OE &&
+                  BusCapture::CONTROL_WE == CAPTURE_WE,
+              "capture control bits differ from the protocol");
+static_assert(Instrumentation::HISTOGRAM_BUCKETS == STATS_HISTOGRAM_BUCKETS &&
+                  Instrumentation::HISTOGRAM_BASE_US == STATS_HISTOGRAM_BASE_US,
+              "histogram layout differs from the protocol");
+
+namespace
+{
+  // Pseudo-random bytes from a seed, so the benchmark needs no image buffer
+  class PatternImage : public ImageSource
+  {
+  public:
+    PatternImage(uint32_t seed) : seed(seed), state(seed) {}
+
+    void rewind() override
+    {
+      state = seed;
+    }
+
+    uint16_t read(uint8_t *out, uint16_t length) override
+    {
+      for (uint16_t i = 0; i < length; i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        out[i] = (uint8_t)(state >> 24);
+      }
+      return length;
+    }
+
+  private:
+    uint32_t seed;
+    uint32_t state;
+  };
+
+  class DiscardSink : public DataSink
+  {
+  public:
+    void write(uint16_t address, const uint8_t *data, uint16_t length) override
+    {
+      (void)address;
+      (void)data;
+      (void)length;
+    }
+  };
+
+  uint32_t microsecondsSince(uint32_t start)
+  {
+    return DelayUtil::cyclesToMicroseconds(DelayUtil::cycles() - start);
+  }
+}
+
+EEPROMDiagnostics::EEPROMDiagnostics(EEPROMProgrammer &programmer, BusCapture *busCapture)
+    : programmer(programmer), busCapture(busCapture), benchmarkRuns(0)
+{
+}
+
+void EEPROMDiagnostics::readStats(DeviceStats &stats, bool reset)
+{
+  const Instrumentation &counters = programmer.getInstrumentation();
+  uint32_t cyclesPerMicrosecond = DelayUtil::microsecondsToCycles(1);
+
+  for (uint8_t phase = 0; phase < STATS_PHASES; phase++)
+  {
+    Instrumentation::Phase id = (Instrumentation::Phase)phase;
+    stats.phaseMicros[phase] = (uint32_t)(counters.getPhaseCycles(id) / cyclesPerMicrosecond);
+    stats.phaseCount[phase] = counters.getPhaseCount(id);
+  }
+  stats.writeCycles = counters.getWriteCycles();
+  stats.retries = counters.getRetries() > 0xFFFF ? 0xFFFF : (uint16_t)counters.getRetries();
+  stats.timeouts = counters.getTimeouts() > 0xFFFF ? 0xFFFF : (uint16_t)counters.getTimeouts();
+  for (uint8_t bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; bucket++)
+  {
+    uint32_t count = counters.getHistogram(bucket);
+    stats.histogram[bucket] = count > 0xFFFF ? 0xFFFF : (uint16_t)count;
+  }
+
+  if (reset)
+  {
+    programmer.resetInstrumentation();
+  }
+}
+
+void EEPROMDiagnostics::runBenchmark(uint16_t address, uint16_t length, BenchmarkResult &result)
+{
+  PatternImage pattern(0x5EED0000u + benchmarkRuns++);
+  uint8_t page[EEPROMProgrammer::PAGE_SIZE];
+  bool success = programmer.invalidateManifest(); // The pattern replaces part of any image
+
+  result.length = length;
+
+  // Plain page writes, without the read-back writeImage adds
+  uint32_t start = DelayUtil::cycles();
+  for (uint16_t offset = 0; offset < length && success;)
+  {
+    uint16_t chunk = EEPROMProgrammer::PAGE_SIZE - ((address + offset) & EEPROMProgrammer::PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+    pattern.read(page, chunk);
+    success = programmer.writePage(address + offset, page, chunk, false, offset == 0);
+    offset += chunk;
+  }
+  result.writeMicros = microsecondsSince(start);
+
+  start = DelayUtil::cycles();
+  success = programmer.verify(address, pattern, length) && success;
+  result.verifyMicros = microsecondsSince(start);
+
+  DiscardSink discard;
+  start = DelayUtil::cycles();
+  programmer.dump(address, length, discard);
+  result.dumpMicros = microsecondsSince(start);
+
+  result.status = success ? STATUS_OK : STATUS_WRITE_FAILED;
+}
+
+void EEPROMDiagnostics::characterize(uint16_t address, TimingReport &report)
+{
+  bool success = programmer.characterizeTiming(address);
+  const EEPROMProgrammer::TimingProfile &profile = programmer.getTimingProfile();
+
+  report.status = success ? STATUS_OK : STATUS_WRITE_FAILED;
+  report.accessNs = (uint16_t)DelayUtil::cyclesToNanoseconds(profile.accessCycles);
+  report.outputEnableNs = (uint16_t)DelayUtil::cyclesToNanoseconds(profile.outputEnableCycles);
+  report.firstReadNs = DelayUtil::cyclesToNanoseconds(profile.firstReadCycles);
+  report.firstWriteNs = DelayUtil::cyclesToNanoseconds(profile.firstWriteCycles);
+  report.writeCycleMicros = profile.writeCycleMicros;
+  report.writeTimeoutMicros = profile.writeTimeoutMicros;
+}
+
+bool EEPROMDiagnostics::capture(const CaptureRequest &request, CaptureInfo &info)
+{
+  if (busCapture == nullptr)
+  {
+    return false;
+  }
+
+  BusCapture::Settings settings;
+  settings.sampleRateHz = request.sampleRateHz;
+  settings.useTrigger = (request.flags & FLAG_CAPTURE_TRIGGER) != 0;
+  settings.triggerAddress = request.triggerAddress;
+  settings.preTrigger = request.preTrigger;
+  settings.timeoutUs = request.timeoutMs * 1000u;
+
+  BusCapture::Result result;
+  bool success = busCapture->capture(settings, result);
+
+  info.status = success ? STATUS_OK : STATUS_TIMEOUT;
+  info.triggered = result.triggered ? 1 : 0;
+  info.sampleCount = result.sampleCount;
+  info.triggerIndex = result.triggerIndex;
+  info.sampleRateHz = SystemCoreClock / result.periodCycles;
+  info.missedSamples = result.missedSamples > 0xFFFF ? 0xFFFF : (uint16_t)result.missedSamples;
+  return true;
+}
+
+uint8_t EEPROMDiagnostics::readCapture(uint16_t index, CaptureSample *samples, uint8_t count)
+{
+  if (busCapture == nullptr)
+  {
+    return 0;
+  }
+
+  BusCapture::Sample decoded[CAPTURE_SAMPLES_PER_FRAME];
+  if (count > CAPTURE_SAMPLES_PER_FRAME)
+  {
+    count = CAPTURE_SAMPLES_PER_FRAME;
+  }
+  count = (uint8_t)busCapture->readSamples(index, decoded, count);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    samples[i].address = decoded[i].address;
+    samples[i].data = decoded[i].data;
+    samples[i].control = decoded[i].control;
+  }
+  return count;
+}
+
+void EEPROMDiagnostics::endCapture()
+{
+  programmer.claimBus();
+}
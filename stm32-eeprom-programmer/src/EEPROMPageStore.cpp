@@ -0,0 +1,65 @@
+#include "EEPROMPageStore.h"
+
+EEPROMPageStore::EEPROMPageStore(EEPROMProgrammer &programmer)
+    : programmer(programmer), manifestChecked(false)
+{
+}
+
+void EEPROMPageStore::beginSession()
+{
+  manifestChecked = false;
+}
+
+PageStore::WriteResult EEPROMPageStore::writePage(uint16_t address, const uint8_t *data, uint16_t length,
+                                                 bool sdpProtected)
+{
+  if (!manifestChecked)
+  {
+    if (!programmer.invalidateManifest(sdpProtected))
+    {
+      return PAGE_FAILED;
+    }
+    manifestChecked = true;
+  }
+
+  uint16_t changed;
+  if (!programmer.updatePage(address, data, length, &changed, sdpProtected))
+  {
+    return PAGE_FAILED;
+  }
+  if (changed == 0)
+  {
+    return PAGE_UNCHANGED;
+  }
+
+  // updatePage only confirms the last byte, so read the whole page back
+  bool match = true;
+  programmer.beginRead();
+  for (uint16_t i = 0; i < length && match; i++)
+  {
+    match = programmer.readAddress(address + i) == data[i];
+  }
+  programmer.endRead();
+
+  return match ? PAGE_WRITTEN : PAGE_FAILED;
+}
+
+void EEPROMPageStore::readBlock(uint16_t address, uint8_t *data, uint16_t length)
+{
+  programmer.beginRead();
+  for (uint16_t i = 0; i < length; i++)
+  {
+    data[i] = programmer.readAddress(address + i);
+  }
+  programmer.endRead();
+}
+
+bool EEPROMPageStore::erase()
+{
+  return programmer.eraseChip();
+}
+
+bool EEPROMPageStore::isBlank(uint16_t address, uint16_t length, uint16_t &firstUsed)
+{
+  return programmer.isBlank(address, length, &firstUsed);
+}
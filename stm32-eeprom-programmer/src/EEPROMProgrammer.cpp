@@ -1,25 +1,147 @@
 #include "EEPROMProgrammer.h"
 #include "DelayUtil.h"
+#include "HardwareCRC.h"
+#include "ProgrammingProtocol.h"
+#include "ProgressJournal.h"
+
+#include <string.h>
+
+constexpr PinDef EEPROMProgrammer::ADDRESS_PINS[];
+constexpr PinDef EEPROMProgrammer::DATA_PINS[];
+
+namespace
+{
+  inline GPIO_TypeDef *portRegisters(uint8_t port)
+  {
+    switch (port)
+    {
+    case PIN_PORT_A:
+      return GPIOA;
+    case PIN_PORT_B:
+      return GPIOB;
+    default:
+      return GPIOC;
+    }
+  }
+
+  template <uint8_t port>
+  constexpr uint16_t addressMask = PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, port);
+  template <uint8_t port>
+  constexpr uint16_t dataMask = PinMap::portMask(EEPROMProgrammer::DATA_PINS, port);
+
+  template <uint8_t port>
+  constexpr PinMap::ScatterTable addressScatterLow = PinMap::scatter(EEPROMProgrammer::ADDRESS_PINS, port, 0);
+  template <uint8_t port>
+  constexpr PinMap::ScatterTable addressScatterHigh = PinMap::scatter(EEPROMProgrammer::ADDRESS_PINS, port, 8);
+  template <uint8_t port>
+  constexpr PinMap::ScatterTable dataScatter = PinMap::scatter(EEPROMProgrammer::DATA_PINS, port, 0);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> dataGatherLow = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, false);
+  template <uint8_t port>
+  constexpr PinMap::GatherTable<uint8_t> dataGatherHigh = PinMap::gather<uint8_t>(EEPROMProgrammer::DATA_PINS, port, true);
+
+  // The masks are compile-time constants, so ports without bus pins and
+  // unused table halves drop out of the generated code entirely
+
+  // CRL/CRH configuration nibbles (MODE[1:0] | CNF[1:0] << 2)
+  const uint32_t CR_NIBBLE_MASK = 0xF;
+  const uint32_t CR_INPUT_FLOATING = 0x4;
+  const uint32_t CR_OUTPUT_PUSH_PULL = 0x3; // 50MHz, same as GPIO_SPEED_FREQ_HIGH
+
+  // Repeat a configuration nibble for every pin of one CR register (high = CRH)
+  constexpr uint32_t configBits(uint16_t pins, bool high, uint32_t nibble)
+  {
+    uint32_t value = 0;
+    for (int pin = 0; pin < 8; pin++)
+    {
+      if (pins & (1u << (pin + (high ? 8 : 0))))
+      {
+        value |= nibble << (pin * 4);
+      }
+    }
+    return value;
+  }
+
+  // Rewrite only the data pin nibbles of a port's CRL/CRH, one store each
+  template <uint8_t port, uint32_t nibble>
+  inline void setDataPortMode()
+  {
+    constexpr uint16_t pins = dataMask<port>;
+    if (pins & 0x00FF)
+    {
+      GPIO_TypeDef *gpio = portRegisters(port);
+      gpio->CRL = (gpio->CRL & ~configBits(pins, false, CR_NIBBLE_MASK)) | configBits(pins, false, nibble);
+    }
+    if (pins & 0xFF00)
+    {
+      GPIO_TypeDef *gpio = portRegisters(port);
+      gpio->CRH = (gpio->CRH & ~configBits(pins, true, CR_NIBBLE_MASK)) | configBits(pins, true, nibble);
+    }
+  }
+
+  template <uint8_t port>
+  inline void scatterAddress(uint16_t address)
+  {
+    if (addressMask<port> != 0)
+    {
+      uint16_t set = addressScatterLow<port>.set[address & 0xFF] | addressScatterHigh<port>.set[address >> 8];
+      portRegisters(port)->BSRR = PinMap::bsrr(set, addressMask<port>);
+    }
+  }
+
+  template <uint8_t port>
+  inline void scatterData(uint8_t data)
+  {
+    if (dataMask<port> != 0)
+    {
+      portRegisters(port)->BSRR = PinMap::bsrr(dataScatter<port>.set[data], dataMask<port>);
+    }
+  }
+
+  template <uint8_t port>
+  inline uint8_t gatherData()
+  {
+    uint8_t data = 0;
+    if (dataMask<port> != 0)
+    {
+      uint16_t idr = portRegisters(port)->IDR;
+      if (dataMask<port> & 0x00FF)
+        data |= dataGatherLow<port>.bits[idr & 0xFF];
+      if (dataMask<port> & 0xFF00)
+        data |= dataGatherHigh<port>.bits[idr >> 8];
+    }
+    return data;
+  }
+
+  void initPins(uint8_t port, uint16_t pins, uint32_t mode)
+  {
+    if (pins != 0)
+    {
+      GPIO_InitTypeDef GPIO_InitStruct = {0};
+      GPIO_InitStruct.Pin = pins;
+      GPIO_InitStruct.Mode = mode;
+      GPIO_InitStruct.Pull = GPIO_NOPULL;
+      GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+      HAL_GPIO_Init(portRegisters(port), &GPIO_InitStruct);
+    }
+  }
+}
 
 EEPROMProgrammer::EEPROMProgrammer()
 {
   // Initialize GPIO port pointers
-  addressPortA = GPIOA;
-  addressPortB = GPIOB;
-  dataPort = GPIOB;
-  dataPortC = GPIOC; // For D2 which is now on PC15
   controlPort = GPIOA;
   ledPort = GPIOC;
 
-  // Initialize data pin array
-  dataPins[0] = DATA_PIN_D0;
-  dataPins[1] = DATA_PIN_D1;
-  dataPins[2] = DATA_PIN_D2;
-  dataPins[3] = DATA_PIN_D3;
-  dataPins[4] = DATA_PIN_D4;
-  dataPins[5] = DATA_PIN_D5;
-  dataPins[6] = DATA_PIN_D6;
-  dataPins[7] = DATA_PIN_D7;
+  busDirection = BUS_UNKNOWN;
+  selectedChip = CHIP_LOWER;
+  chipEnablePin = EEPROM_CE_PIN;
+  lastWriteCycleMicros = 0;
+  lastSourceCyclesPerPage = 0;
+  lastResumedPages = 0;
+  lastDiffStats = DiffStats();
+  timingProfile = TimingProfile();
+  timingCalibrated = false;
 }
 
 void EEPROMProgrammer::begin()
@@ -28,9 +150,38 @@ void EEPROMProgrammer::begin()
   __HAL_RCC_GPIOA_CLK_ENABLE();
   __HAL_RCC_GPIOB_CLK_ENABLE();
   __HAL_RCC_GPIOC_CLK_ENABLE();
+  __HAL_RCC_AFIO_CLK_ENABLE();
+
+  // Release PB3/PB4/PA15 from JTAG (D3 is on PB4), keeping SWD for debugging
+  __HAL_AFIO_REMAP_SWJ_NOJTAG();
+
+  // Start the timing layer before any bus access relies on it
+  timingCalibrated = DelayUtil::begin();
+  resetTimingProfile();
+  HardwareCRC::begin();
+
+  claimBus();
+
+  // Blink LED to indicate initialization (six blinks: timing self-check failed)
+  blinkLED(timingCalibrated ? 3 : 6);
+}
 
-  // Need to set WE high early to avoid accidental writes
+void EEPROMProgrammer::releaseBus()
+{
+  initPins(PIN_PORT_A, addressMask<PIN_PORT_A>, GPIO_MODE_INPUT);
+  initPins(PIN_PORT_B, addressMask<PIN_PORT_B>, GPIO_MODE_INPUT);
+  initPins(PIN_PORT_C, addressMask<PIN_PORT_C>, GPIO_MODE_INPUT);
+  initPins(PIN_PORT_A, EEPROM_WE_PIN | EEPROM_OE_PIN | EEPROM_CE_PIN | EEPROM_CE_UPPER_PIN, GPIO_MODE_INPUT);
+  setDataBusInput();
+}
+
+void EEPROMProgrammer::claimBus()
+{
+  // Need to set WE high early to avoid accidental writes, and both CE lines
+  // so the chips never drive the bus together when the pins become outputs
   setPinHigh(controlPort, EEPROM_WE_PIN); // WE inactive (high)
+  setPinHigh(controlPort, EEPROM_CE_PIN);
+  setPinHigh(controlPort, EEPROM_CE_UPPER_PIN);
 
   configureGPIO();
 
@@ -38,31 +189,24 @@ void EEPROMProgrammer::begin()
   setPinHigh(controlPort, EEPROM_WE_PIN);
   setPinHigh(controlPort, EEPROM_OE_PIN); // OE inactive (high)
   setPinHigh(controlPort, EEPROM_CE_PIN); // CE inactive (high)
-
-  // Blink LED to indicate initialization
-  blinkLED(3);
+  setPinHigh(controlPort, EEPROM_CE_UPPER_PIN);
 }
 
 void EEPROMProgrammer::configureGPIO()
 {
   GPIO_InitTypeDef GPIO_InitStruct = {0};
 
-  // Configure address pins A0-A9 (PA0-PA4, PA8-PA12) as outputs
-  GPIO_InitStruct.Pin = ADDRESS_PIN_A0 | ADDRESS_PIN_A1 | ADDRESS_PIN_A2 |
-                        ADDRESS_PIN_A3 | ADDRESS_PIN_A4 | ADDRESS_PIN_A5 |
-                        ADDRESS_PIN_A6 | ADDRESS_PIN_A7 | ADDRESS_PIN_A8 | ADDRESS_PIN_A9;
+  // Configure address pins A0-A14 as outputs
+  initPins(PIN_PORT_A, addressMask<PIN_PORT_A>, GPIO_MODE_OUTPUT_PP);
+  initPins(PIN_PORT_B, addressMask<PIN_PORT_B>, GPIO_MODE_OUTPUT_PP);
+  initPins(PIN_PORT_C, addressMask<PIN_PORT_C>, GPIO_MODE_OUTPUT_PP);
+
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
-  HAL_GPIO_Init(addressPortA, &GPIO_InitStruct);
 
-  // Configure address pins A10-A14 as outputs
-  GPIO_InitStruct.Pin = ADDRESS_PIN_A10 | ADDRESS_PIN_A11 | ADDRESS_PIN_A12 |
-                        ADDRESS_PIN_A13 | ADDRESS_PIN_A14;
-  HAL_GPIO_Init(addressPortB, &GPIO_InitStruct);
-
-  // Configure control pins (PA5-PA7) as outputs
-  GPIO_InitStruct.Pin = EEPROM_WE_PIN | EEPROM_OE_PIN | EEPROM_CE_PIN;
+  // Configure control pins (PA5-PA7, PA15) as outputs
+  GPIO_InitStruct.Pin = EEPROM_WE_PIN | EEPROM_OE_PIN | EEPROM_CE_PIN | EEPROM_CE_UPPER_PIN;
   HAL_GPIO_Init(controlPort, &GPIO_InitStruct);
 
   // Configure LED pin (PC13) as output
@@ -71,326 +215,277 @@ void EEPROMProgrammer::configureGPIO()
   HAL_GPIO_Init(ledPort, &GPIO_InitStruct);
 
   // Configure data pins as inputs initially
+  busDirection = BUS_UNKNOWN;
   setDataBusInput();
 }
 
 void EEPROMProgrammer::setDataBusInput()
 {
-  GPIO_InitTypeDef GPIO_InitStruct = {0};
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
-  GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
-
-  // Configure data pins D0-D1, D3-D7 on GPIOB as inputs
-  GPIO_InitStruct.Pin = DATA_PIN_D0 | DATA_PIN_D1 | DATA_PIN_D3 |
-                        DATA_PIN_D4 | DATA_PIN_D5 | DATA_PIN_D6 | DATA_PIN_D7;
-  HAL_GPIO_Init(dataPort, &GPIO_InitStruct);
+  if (busDirection == BUS_INPUT)
+  {
+    return;
+  }
 
-  // Configure data pin D2 on GPIOC as input
-  GPIO_InitStruct.Pin = DATA_PIN_D2;
-  HAL_GPIO_Init(dataPortC, &GPIO_InitStruct);
+  uint32_t start = DelayUtil::cycles();
+  setDataPortMode<PIN_PORT_A, CR_INPUT_FLOATING>();
+  setDataPortMode<PIN_PORT_B, CR_INPUT_FLOATING>();
+  setDataPortMode<PIN_PORT_C, CR_INPUT_FLOATING>();
+  busDirection = BUS_INPUT;
+  instrumentation.addPhase(Instrumentation::PHASE_BUS_TURNAROUND, DelayUtil::cycles() - start);
 }
 
 void EEPROMProgrammer::setDataBusOutput()
 {
-  GPIO_InitTypeDef GPIO_InitStruct = {0};
-  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-  GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  if (busDirection == BUS_OUTPUT)
+  {
+    return;
+  }
 
-  // Configure data pins D0-D1, D3-D7 on GPIOB as outputs
-  GPIO_InitStruct.Pin = DATA_PIN_D0 | DATA_PIN_D1 | DATA_PIN_D3 |
-                        DATA_PIN_D4 | DATA_PIN_D5 | DATA_PIN_D6 | DATA_PIN_D7;
-  HAL_GPIO_Init(dataPort, &GPIO_InitStruct);
+  // Never drive the bus while the chip's outputs may be enabled
+  uint32_t start = DelayUtil::cycles();
+  setPinHigh(controlPort, EEPROM_OE_PIN);
 
-  // Configure data pin D2 on GPIOC as output
-  GPIO_InitStruct.Pin = DATA_PIN_D2;
-  HAL_GPIO_Init(dataPortC, &GPIO_InitStruct);
+  setDataPortMode<PIN_PORT_A, CR_OUTPUT_PUSH_PULL>();
+  setDataPortMode<PIN_PORT_B, CR_OUTPUT_PUSH_PULL>();
+  setDataPortMode<PIN_PORT_C, CR_OUTPUT_PUSH_PULL>();
+  busDirection = BUS_OUTPUT;
+  instrumentation.addPhase(Instrumentation::PHASE_BUS_TURNAROUND, DelayUtil::cycles() - start);
 }
 
 void EEPROMProgrammer::setAddress(uint16_t address)
 {
-  // Set all 15 address pins (A0-A14) using direct register access for speed
-
-  // A0-A4 (PA0-PA4)
-  if (address & 0x0001)
-    setPinHigh(addressPortA, ADDRESS_PIN_A0);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A0);
-
-  if (address & 0x0002)
-    setPinHigh(addressPortA, ADDRESS_PIN_A1);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A1);
-
-  if (address & 0x0004)
-    setPinHigh(addressPortA, ADDRESS_PIN_A2);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A2);
-
-  if (address & 0x0008)
-    setPinHigh(addressPortA, ADDRESS_PIN_A3);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A3);
-
-  if (address & 0x0010)
-    setPinHigh(addressPortA, ADDRESS_PIN_A4);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A4);
-
-  // A5-A9 (PA8-PA12)
-  if (address & 0x0020)
-    setPinHigh(addressPortA, ADDRESS_PIN_A5);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A5);
-
-  if (address & 0x0040)
-    setPinHigh(addressPortA, ADDRESS_PIN_A6);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A6);
-
-  if (address & 0x0080)
-    setPinHigh(addressPortA, ADDRESS_PIN_A7);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A7);
-
-  if (address & 0x0100)
-    setPinHigh(addressPortA, ADDRESS_PIN_A8);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A8);
-
-  if (address & 0x0200)
-    setPinHigh(addressPortA, ADDRESS_PIN_A9);
-  else
-    setPinLow(addressPortA, ADDRESS_PIN_A9);
-
-  // A10-A14 (PB2-PB6)
-  if (address & 0x0400)
-    setPinHigh(addressPortB, ADDRESS_PIN_A10);
-  else
-    setPinLow(addressPortB, ADDRESS_PIN_A10);
-
-  if (address & 0x0800)
-    setPinHigh(addressPortB, ADDRESS_PIN_A11);
-  else
-    setPinLow(addressPortB, ADDRESS_PIN_A11);
-
-  if (address & 0x1000)
-    setPinHigh(addressPortB, ADDRESS_PIN_A12);
-  else
-    setPinLow(addressPortB, ADDRESS_PIN_A12);
-
-  if (address & 0x2000)
-    setPinHigh(addressPortB, ADDRESS_PIN_A13);
-  else
-    setPinLow(addressPortB, ADDRESS_PIN_A13);
-
-  if (address & 0x4000)
-    setPinHigh(addressPortB, ADDRESS_PIN_A14);
-  else
-    setPinLow(addressPortB, ADDRESS_PIN_A14);
+  // One BSRR store per port sets and clears all of its address pins at once
+  scatterAddress<PIN_PORT_A>(address);
+  scatterAddress<PIN_PORT_B>(address);
+  scatterAddress<PIN_PORT_C>(address);
 }
 
 uint8_t EEPROMProgrammer::readData()
 {
-  uint8_t data = 0;
-
-  // Read each data pin and construct the byte
-  if (readPin(dataPort, DATA_PIN_D0))
-    data |= 0x01;
-  if (readPin(dataPort, DATA_PIN_D1))
-    data |= 0x02;
-  if (readPin(dataPortC, DATA_PIN_D2))
-    data |= 0x04;
-  if (readPin(dataPort, DATA_PIN_D3))
-    data |= 0x08;
-  if (readPin(dataPort, DATA_PIN_D4))
-    data |= 0x10;
-  if (readPin(dataPort, DATA_PIN_D5))
-    data |= 0x20;
-  if (readPin(dataPort, DATA_PIN_D6))
-    data |= 0x40;
-  if (readPin(dataPort, DATA_PIN_D7))
-    data |= 0x80;
-
-  return data;
+  // One IDR load per port, remapped to data bits through the gather tables
+  return gatherData<PIN_PORT_A>() | gatherData<PIN_PORT_B>() | gatherData<PIN_PORT_C>();
 }
 
 void EEPROMProgrammer::writeData(uint8_t data)
 {
-  // Write each bit to the corresponding data pin
-  if (data & 0x01)
-    setPinHigh(dataPort, DATA_PIN_D0);
-  else
-    setPinLow(dataPort, DATA_PIN_D0);
-
-  if (data & 0x02)
-    setPinHigh(dataPort, DATA_PIN_D1);
-  else
-    setPinLow(dataPort, DATA_PIN_D1);
-
-  if (data & 0x04)
-    setPinHigh(dataPortC, DATA_PIN_D2);
-  else
-    setPinLow(dataPortC, DATA_PIN_D2);
-
-  if (data & 0x08)
-    setPinHigh(dataPort, DATA_PIN_D3);
-  else
-    setPinLow(dataPort, DATA_PIN_D3);
-
-  if (data & 0x10)
-    setPinHigh(dataPort, DATA_PIN_D4);
-  else
-    setPinLow(dataPort, DATA_PIN_D4);
-
-  if (data & 0x20)
-    setPinHigh(dataPort, DATA_PIN_D5);
-  else
-    setPinLow(dataPort, DATA_PIN_D5);
-
-  if (data & 0x40)
-    setPinHigh(dataPort, DATA_PIN_D6);
-  else
-    setPinLow(dataPort, DATA_PIN_D6);
-
-  if (data & 0x80)
-    setPinHigh(dataPort, DATA_PIN_D7);
-  else
-    setPinLow(dataPort, DATA_PIN_D7);
+  // One BSRR store per port
+  scatterData<PIN_PORT_A>(data);
+  scatterData<PIN_PORT_B>(data);
+  scatterData<PIN_PORT_C>(data);
 }
 
-bool EEPROMProgrammer::waitForWriteComplete(uint8_t expectedData)
+bool EEPROMProgrammer::waitForWriteComplete(uint8_t expectedData, CompletionMethod method, uint32_t timeoutUs)
 {
-  setDataBusInput();
-  setPinLow(controlPort, EEPROM_OE_PIN);
+  // The address of the byte just written must still be on the bus
+  uint32_t start = DelayUtil::cycles();
+  uint32_t timeout = DelayUtil::microsecondsToCycles(timeoutUs > 0 ? timeoutUs : timingProfile.writeTimeoutMicros);
 
-  DelayUtil::delayMicroseconds(10);
+  setDataBusInput();
 
-  // Poll the data bus for write completion
-  // During write, reading the same address should return the complement of written data
-  // When write is complete, it returns the actual written data
-  uint8_t currentData;
-  int stableCount = 0;
-  const int requiredStableReads = 3;
+  bool success = false;
+  bool settling = false; // The status bit reported the end of the cycle
+  uint8_t previous = readStatus();
 
-  for (int i = 0; i < 100; i++) // Timeout after ~100ms
+  while (DelayUtil::cycles() - start < timeout)
   {
-    currentData = readData();
+    uint8_t current = readStatus();
 
-    if (currentData == expectedData)
+    if (settling)
     {
-      stableCount++;
-      if (stableCount >= requiredStableReads)
+      // The other I/O lines may settle a little after the status bit, so
+      // read until the whole byte matches; only the timeout fails
+      if (current == expectedData)
       {
-        setPinHigh(controlPort, EEPROM_OE_PIN);
-        return true;
+        success = true;
+        break;
       }
+      continue;
+    }
+
+    bool busy;
+    if (method == COMPLETION_DATA_POLLING)
+    {
+      // I/O7 is the complement of the written bit until the cycle ends
+      busy = ((current ^ expectedData) & 0x80) != 0;
     }
     else
     {
-      stableCount = 0; // Reset counter if data doesn't match expected
+      // I/O6 toggles on consecutive reads until the cycle ends
+      busy = ((current ^ previous) & 0x40) != 0;
+      previous = current;
     }
-
-    DelayUtil::delayMicroseconds(10);
+    settling = !busy;
   }
 
+  uint32_t elapsed = DelayUtil::cycles() - start;
+  lastWriteCycleMicros = DelayUtil::cyclesToMicroseconds(elapsed);
+  instrumentation.addPhase(Instrumentation::PHASE_COMPLETION_POLL, elapsed);
+  instrumentation.recordWriteCycle(lastWriteCycleMicros, !success);
+
+  return success;
+}
+
+uint32_t EEPROMProgrammer::getLastWriteCycleMicros() const
+{
+  return lastWriteCycleMicros;
+}
+
+uint8_t EEPROMProgrammer::readStatus()
+{
+  // Each status read needs its own OE pulse for the toggle bit to advance
+  setPinLow(controlPort, EEPROM_OE_PIN);
+  if (timingProfile.outputEnableCycles > 0)
+  {
+    DelayUtil::delayCycles(timingProfile.outputEnableCycles);
+  }
+  uint8_t data = readData();
   setPinHigh(controlPort, EEPROM_OE_PIN);
-  return false;
+
+  return data;
 }
 
 void EEPROMProgrammer::disableSoftwareDataProtection()
 {
+  setDataBusOutput();
+  setPinHigh(controlPort, EEPROM_OE_PIN);
   setPinHigh(controlPort, EEPROM_WE_PIN);
-  setPinLow(controlPort, EEPROM_CE_PIN);
+  setPinLow(controlPort, chipEnablePin);
 
-  setAddress(0x5555);
-  writeData(0xAA);
+  loadCommand(SDP_DISABLE_1);
+  loadCommand(SDP_DISABLE_2);
+}
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
+bool EEPROMProgrammer::eraseChip()
+{
+  setDataBusOutput();
+  setPinHigh(controlPort, EEPROM_OE_PIN);
   setPinHigh(controlPort, EEPROM_WE_PIN);
+  setPinLow(controlPort, chipEnablePin);
 
-  setAddress(0x2AAA);
-  writeData(0x55);
+  loadCommand(SDP_DISABLE_1);
+  loadCommand(SDP_CHIP_ERASE);
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
-  setPinHigh(controlPort, EEPROM_WE_PIN);
+  // DATA# would compare I/O7 with the command byte, so watch the toggle bit;
+  // the final read at 0x5555 must then return an erased byte
+  bool success = waitForWriteComplete(0xFF, COMPLETION_TOGGLE_BIT, CHIP_ERASE_TIMEOUT_US);
 
-  setAddress(0x5555);
-  writeData(0x80);
+  setPinHigh(controlPort, chipEnablePin);
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
-  setPinHigh(controlPort, EEPROM_WE_PIN);
+  if (!success)
+  {
+    blinkLED(1);
+  }
 
-  setAddress(0x5555);
-  writeData(0xAA);
+  return success;
+}
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
-  setPinHigh(controlPort, EEPROM_WE_PIN);
+bool EEPROMProgrammer::isBlank(uint16_t startAddress, uint16_t length, uint16_t *firstUsed)
+{
+  bool blank = true;
 
-  setAddress(0x2AAA);
-  writeData(0x55);
+  beginRead();
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (readAddress(startAddress + i, i == 0) != 0xFF)
+    {
+      blank = false;
+      if (firstUsed != nullptr)
+      {
+        *firstUsed = startAddress + i;
+      }
+      break;
+    }
+  }
+  endRead();
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
-  setPinHigh(controlPort, EEPROM_WE_PIN);
+  return blank;
+}
+
+void EEPROMProgrammer::loadCommand(uint8_t command)
+{
+  // Unlock prefix, then the command byte, all within tBLC
+  loadByte(SDP_ADDRESS_1, SDP_UNLOCK_1);
+  loadByte(SDP_ADDRESS_2, SDP_UNLOCK_2);
+  loadByte(SDP_ADDRESS_1, command);
+}
 
-  setAddress(0x5555);
-  writeData(0x20);
+void EEPROMProgrammer::loadByte(uint16_t address, uint8_t data)
+{
+  // Latch one byte into the chip with a WE pulse; CE must already be low
+  uint32_t start = DelayUtil::cycles();
+  setAddress(address);
+  writeData(data);
+  DelayUtil::delayNanoseconds(T_AS_NS);
+  uint32_t pulse = DelayUtil::cycles();
 
+  // tWP also covers tAH and tDS, both of which are shorter
   setPinLow(controlPort, EEPROM_WE_PIN);
+  DelayUtil::delayNanoseconds(T_WP_NS);
   setPinHigh(controlPort, EEPROM_WE_PIN);
+
+  instrumentation.addPhase(Instrumentation::PHASE_ADDRESS_SETUP, pulse - start);
+  instrumentation.addPhase(Instrumentation::PHASE_WRITE_PULSE, DelayUtil::cycles() - pulse);
 }
 
 uint8_t EEPROMProgrammer::readByte(uint16_t address, bool shouldDelay)
 {
-  setPinLow(controlPort, EEPROM_CE_PIN);
-  setPinLow(controlPort, EEPROM_OE_PIN);
+  beginRead();
+  uint8_t data = readAddress(address, shouldDelay);
+  endRead();
+
+  return data;
+}
+
+void EEPROMProgrammer::beginRead()
+{
+  setDataBusInput();
   setPinHigh(controlPort, EEPROM_WE_PIN);
+  setPinLow(controlPort, chipEnablePin);
+  setPinLow(controlPort, EEPROM_OE_PIN);
+}
 
+uint8_t EEPROMProgrammer::readAddress(uint16_t address, bool shouldDelay)
+{
   setAddress(address);
-  setDataBusInput();
-  if (shouldDelay)
-  {
-    DelayUtil::delayMicroseconds(1000);
-  }
-  else
+  uint32_t wait = shouldDelay ? timingProfile.firstReadCycles : timingProfile.accessCycles;
+  if (wait > 0)
   {
-    DelayUtil::delayMicroseconds(1);
+    DelayUtil::delayCycles(wait);
   }
-  uint8_t data = readData();
 
-  setPinHigh(controlPort, EEPROM_OE_PIN);
-  setPinHigh(controlPort, EEPROM_CE_PIN);
+  return readData();
+}
 
-  return data;
+void EEPROMProgrammer::endRead()
+{
+  setPinHigh(controlPort, EEPROM_OE_PIN);
+  setPinHigh(controlPort, chipEnablePin);
 }
 
-bool EEPROMProgrammer::writeByte(uint16_t address, uint8_t data, bool shouldDelay)
+bool EEPROMProgrammer::writeByte(uint16_t address, uint8_t data, bool shouldDelay, CompletionMethod method)
 {
   setDataBusOutput();
-  setPinLow(controlPort, EEPROM_CE_PIN);
+  setPinLow(controlPort, chipEnablePin);
   setPinHigh(controlPort, EEPROM_OE_PIN);
 
   // disableSoftwareDataProtection();
 
-  setAddress(address);
-  writeData(data);
-
   if (shouldDelay)
   {
-    DelayUtil::delayMicroseconds(2000);
+    setAddress(address);
+    writeData(data);
+    DelayUtil::delayCycles(timingProfile.firstWriteCycles);
+    setPinLow(controlPort, EEPROM_WE_PIN);
+    DelayUtil::delayNanoseconds(T_WP_NS);
+    setPinHigh(controlPort, EEPROM_WE_PIN);
   }
   else
   {
-    DelayUtil::delayMicroseconds(10);
+    loadByte(address, data);
   }
 
-  setPinLow(controlPort, EEPROM_WE_PIN);
-  DelayUtil::delayMicroseconds(1);
-  setPinHigh(controlPort, EEPROM_WE_PIN);
-
   // Wait for write completion
-  bool success = waitForWriteComplete(data);
+  bool success = waitForWriteComplete(data, method);
 
   if (!success)
   {
@@ -400,109 +495,1048 @@ bool EEPROMProgrammer::writeByte(uint16_t address, uint8_t data, bool shouldDela
   return success;
 }
 
-bool EEPROMProgrammer::writeDataBlock(uint16_t startAddress, const uint8_t *data, uint16_t length)
+bool EEPROMProgrammer::writePage(uint16_t address, const uint8_t *data, uint16_t length, bool sdpProtected,
+                                 bool shouldDelay, CompletionMethod method)
 {
-  for (uint16_t i = 0; i < length; i++)
+  if (length == 0)
   {
-    if (!writeByte(startAddress + i, data[i], i == 0))
-    {
-      return false;
-    }
+    return true;
+  }
+
+  // A6-A14 are latched by the first byte, so the whole write must stay in that page
+  if ((address & PAGE_MASK) + length > PAGE_SIZE)
+  {
+    return false;
   }
 
-  return verifyData(startAddress, data, length);
+  return programPage(address, data, nullptr, length, sdpProtected, shouldDelay, method);
 }
 
-bool EEPROMProgrammer::verifyData(uint16_t startAddress, const uint8_t *data, uint16_t length)
+bool EEPROMProgrammer::updatePage(uint16_t address, const uint8_t *data, uint16_t length, uint16_t *changed,
+                                  bool sdpProtected, bool shouldDelay, CompletionMethod method)
 {
-  for (uint16_t i = 0; i < length; i++)
+  *changed = 0;
+  if (length == 0)
   {
-    uint8_t readData = readByte(startAddress + i, i == 0);
-    uint8_t expectedData = data[i];
-    if (readData != expectedData)
-    {
-      return false;
-    }
+    return true;
   }
 
-  return true;
-}
+  if ((address & PAGE_MASK) + length > PAGE_SIZE)
+  {
+    return false;
+  }
 
-uint16_t *EEPROMProgrammer::findMismatchedIndices(uint16_t startAddress, const uint8_t *data, uint16_t length)
-{
-  // First pass: count mismatches to allocate the right size array
-  uint16_t mismatchCount = 0;
+  uint8_t current[PAGE_SIZE];
+  beginRead();
   for (uint16_t i = 0; i < length; i++)
   {
-    uint8_t readData = readByte(startAddress + i, i == 0);
-    uint8_t expectedData = data[i];
-    if (readData != expectedData)
+    current[i] = readAddress(address + i, shouldDelay && i == 0);
+    if (current[i] != data[i])
     {
-      mismatchCount++;
+      (*changed)++;
     }
   }
+  endRead();
 
-  // If no mismatches, return nullptr
-  if (mismatchCount == 0)
+  if (*changed == 0)
   {
-    return nullptr;
+    return true;
   }
 
-  // Allocate array for mismatched indices
-  uint16_t *mismatchedIndices = new uint16_t[mismatchCount];
+  return programPage(address, data, current, length, sdpProtected, false, method);
+}
 
-  // Second pass: collect the mismatched indices
-  uint16_t index = 0;
-  for (uint16_t i = 0; i < length; i++)
+void EEPROMProgrammer::addMismatch(VerifyResult *result, uint16_t address)
+{
+  if (result->rangeCount > 0)
   {
-    uint8_t readData = readByte(startAddress + i, i == 0);
-    uint8_t expectedData = data[i];
-    if (readData != expectedData)
+    MismatchRange &last = result->ranges[result->rangeCount - 1];
+    if (last.start + last.length == address)
     {
-      mismatchedIndices[index] = i; // Store the relative index (0-based)
-      index++;
+      last.length++;
+      return;
     }
   }
 
-  return mismatchedIndices;
+  if (result->rangeCount < MAX_MISMATCH_RANGES)
+  {
+    result->ranges[result->rangeCount].start = address;
+    result->ranges[result->rangeCount].length = 1;
+    result->rangeCount++;
+  }
+  else
+  {
+    result->truncated = true;
+  }
 }
 
-uint8_t *EEPROMProgrammer::dumpMemory(uint16_t startAddress, uint16_t length)
+bool EEPROMProgrammer::programPage(uint16_t address, const uint8_t *data, const uint8_t *current, uint16_t length,
+                                   bool sdpProtected, bool shouldDelay, CompletionMethod method)
 {
-  // Allocate memory for the data array
-  uint8_t *dataArray = new uint8_t[length];
+  setDataBusOutput();
+  setPinHigh(controlPort, EEPROM_OE_PIN);
+  setPinHigh(controlPort, EEPROM_WE_PIN);
+  setPinLow(controlPort, chipEnablePin);
 
-  // Read data from EEPROM into the array
-  for (uint16_t i = 0; i < length; i++)
+  if (shouldDelay)
   {
-    dataArray[i] = readByte(startAddress + i);
+    DelayUtil::delayCycles(timingProfile.firstWriteCycles);
+  }
 
-    // Small delay between reads
-    volatile uint32_t delay_count;
-    for (delay_count = 0; delay_count < 100; delay_count++)
-    {
-    }
+  uint16_t last = loadPage(address, data, current, length, sdpProtected);
+  bool success = completePage(address, data, length, last, sdpProtected, method);
+
+  setPinHigh(controlPort, chipEnablePin);
+
+  if (!success)
+  {
+    blinkLED(1);
   }
 
-  return dataArray;
+  return success;
 }
 
-void EEPROMProgrammer::blinkLED(int times)
+uint16_t EEPROMProgrammer::loadPage(uint16_t address, const uint8_t *data, const uint8_t *current, uint16_t length,
+                                    bool sdpProtected)
 {
-  for (int i = 0; i < times; i++)
+  if (sdpProtected)
   {
-    setPinLow(ledPort, STATUS_LED_PIN); // LED ON (active low)
+    loadCommand(SDP_PROTECTED_WRITE);
+  }
 
-    volatile uint32_t delay_count;
-    for (delay_count = 0; delay_count < 100000; delay_count++)
+  // Each byte has to follow the previous one within tBLC (150us), otherwise the
+  // chip closes the page and starts programming early. Bytes that are not
+  // loaded keep their contents, so with current data only the changes go in.
+  uint16_t last = 0;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (current == nullptr || current[i] != data[i])
     {
+      loadByte(address + i, data[i]);
+      last = i;
     }
+  }
 
-    setPinHigh(ledPort, STATUS_LED_PIN); // LED OFF
+  return last;
+}
 
-    for (delay_count = 0; delay_count < 100000; delay_count++)
-    {
-    }
+bool EEPROMProgrammer::completePage(uint16_t address, const uint8_t *data, uint16_t length, uint16_t last,
+                                    bool sdpProtected, CompletionMethod method)
+{
+  // One poll of the last loaded byte covers the whole page. Its address is
+  // normally still on the bus, but in dual mode the other chip's loads have
+  // replaced it.
+  setAddress(address + last);
+  bool success = waitForWriteComplete(data[last], method);
+
+  for (uint8_t retry = 0; retry < PAGE_WRITE_RETRIES && !success; retry++)
+  {
+    // The failed cycle may have left any of the bytes half-programmed
+    instrumentation.recordRetry();
+    setDataBusOutput();
+    last = loadPage(address, data, nullptr, length, sdpProtected);
+    success = waitForWriteComplete(data[last], method);
+  }
+
+  return success;
+}
+
+void EEPROMProgrammer::selectChip(Chip chip)
+{
+  // Release the previous chip; it may still finish a write cycle on its own
+  setPinHigh(controlPort, chipEnablePin);
+  selectedChip = chip;
+  chipEnablePin = chip == CHIP_UPPER ? EEPROM_CE_UPPER_PIN : EEPROM_CE_PIN;
+}
+
+EEPROMProgrammer::Chip EEPROMProgrammer::getSelectedChip() const
+{
+  return selectedChip;
+}
+
+bool EEPROMProgrammer::writeImagePair(uint16_t startAddress, ImageSource &lower, ImageSource &upper, uint16_t length,
+                                      bool sdpProtected, CompletionMethod method)
+{
+  ImageSource *sources[2] = {&lower, &upper};
+  Chip previousChip = selectedChip;
+
+  for (int chip = CHIP_LOWER; chip <= CHIP_UPPER; chip++)
+  {
+    selectChip((Chip)chip);
+    if (!invalidateManifest(sdpProtected))
+    {
+      selectChip(previousChip);
+      return false;
+    }
+  }
+
+  // The page each chip is programming, kept for its poll and a reload
+  uint8_t pages[2][PAGE_SIZE];
+  uint16_t pageAddress[2] = {0, 0};
+  uint16_t pageLength[2] = {0, 0};
+  uint16_t pageLast[2] = {0, 0};
+  uint8_t next[PAGE_SIZE];
+  bool success = true;
+
+  lower.rewind();
+  upper.rewind();
+
+  setDataBusOutput();
+  setPinHigh(controlPort, EEPROM_WE_PIN);
+  DelayUtil::delayCycles(timingProfile.firstWriteCycles);
+
+  // Chip A's write cycle runs while chip B is loaded, and the other way round:
+  // poll a chip for its previous page only just before loading its next one
+  uint16_t offset = 0;
+  while (offset < length && success)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    for (int chip = CHIP_LOWER; chip <= CHIP_UPPER && success; chip++)
+    {
+      // Fetch before touching the bus, as in writeImage
+      success = sources[chip]->read(next, chunk) == chunk;
+
+      selectChip((Chip)chip);
+      setPinLow(controlPort, chipEnablePin);
+      if (success && pageLength[chip] > 0)
+      {
+        success = completePage(pageAddress[chip], pages[chip], pageLength[chip], pageLast[chip], sdpProtected,
+                               method);
+        setDataBusOutput();
+      }
+
+      if (success)
+      {
+        memcpy(pages[chip], next, chunk);
+        pageAddress[chip] = address;
+        pageLength[chip] = chunk;
+        pageLast[chip] = loadPage(address, pages[chip], nullptr, chunk, sdpProtected);
+      }
+      setPinHigh(controlPort, chipEnablePin);
+    }
+
+    offset += chunk;
+  }
+
+  // Wait for the last page of each chip
+  for (int chip = CHIP_LOWER; chip <= CHIP_UPPER && success; chip++)
+  {
+    if (pageLength[chip] > 0)
+    {
+      selectChip((Chip)chip);
+      setPinLow(controlPort, chipEnablePin);
+      success = completePage(pageAddress[chip], pages[chip], pageLength[chip], pageLast[chip], sdpProtected, method);
+      setPinHigh(controlPort, chipEnablePin);
+    }
+  }
+
+  if (success)
+  {
+    selectChip(CHIP_LOWER);
+    success = verifyImage(startAddress, lower, length);
+  }
+  if (success)
+  {
+    selectChip(CHIP_UPPER);
+    success = verifyImage(startAddress, upper, length);
+  }
+
+  selectChip(previousChip);
+
+  if (!success)
+  {
+    blinkLED(1);
+  }
+
+  return success;
+}
+
+bool EEPROMProgrammer::writeDataBlock(uint16_t startAddress, const uint8_t *data, uint16_t length, WriteMode mode,
+                                      CompletionMethod method, ProgressJournal *journal)
+{
+  ArrayImage image(data, length);
+  return writeImage(startAddress, image, length, mode, method, journal);
+}
+
+bool EEPROMProgrammer::writeImage(uint16_t startAddress, ImageSource &source, uint16_t length, WriteMode mode,
+                                  CompletionMethod method, ProgressJournal *journal)
+{
+  uint8_t page[PAGE_SIZE];
+  uint32_t sourceCycles = 0;
+  uint16_t pages = 0;
+  bool firstWrite = true;
+  bool success = invalidateManifest(mode == WRITE_MODE_PAGE_PROTECTED);
+
+  // The journal is keyed by the image's CRC, so an interrupted session is
+  // only continued with exactly the same data
+  lastResumedPages = 0;
+  if (journal != nullptr)
+  {
+    journal->open(ProgressJournal::hashImage(source, length), startAddress, length, selectedChip);
+  }
+
+  source.rewind();
+
+  uint16_t offset = 0;
+  while (offset < length && success)
+  {
+    // Split on 64-byte page boundaries; only the first and last chunk can be partial
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    // Fetch the page before touching the bus, so decompression never
+    // stretches the gap between byte loads past tBLC
+    uint32_t start = DelayUtil::cycles();
+    success = source.read(page, chunk) == chunk;
+    sourceCycles += DelayUtil::cycles() - start;
+    uint16_t index = pages++;
+
+    if (success && isCommitted(journal, index, address, page, chunk))
+    {
+      lastResumedPages++;
+    }
+    else if (success)
+    {
+      if (mode == WRITE_MODE_BYTE)
+      {
+        for (uint16_t i = 0; i < chunk && success; i++)
+        {
+          success = writeByte(address + i, page[i], firstWrite && i == 0, method);
+        }
+      }
+      else
+      {
+        success = writePage(address, page, chunk, mode == WRITE_MODE_PAGE_PROTECTED, firstWrite, method);
+      }
+      firstWrite = false;
+
+      // Only confirmed pages are recorded. A failed mark costs one page
+      // write after the next reset, so it does not fail the run.
+      if (success && journal != nullptr)
+      {
+        journal->markDone(index);
+      }
+    }
+
+    offset += chunk;
+  }
+
+  lastSourceCyclesPerPage = pages > 0 ? sourceCycles / pages : 0;
+
+  bool written = success;
+  success = success && verifyImage(startAddress, source, length);
+
+  // Done, or the chip does not hold what the journal claims (swapped during
+  // the interruption); either way the next run starts from the beginning.
+  // A failed write keeps the journal, so a retry continues from it.
+  if (journal != nullptr && written)
+  {
+    journal->close();
+  }
+
+  return success;
+}
+
+bool EEPROMProgrammer::isCommitted(ProgressJournal *journal, uint16_t index, uint16_t address, const uint8_t *data,
+                                   uint16_t length)
+{
+  if (journal == nullptr || !journal->isResumed() || !journal->isDone(index))
+  {
+    return false;
+  }
+
+  // The page confirmed last before the interruption gets a quick check; the
+  // final verify covers the others
+  return index != journal->getLastCommitted() || verifyData(address, data, length);
+}
+
+bool EEPROMProgrammer::verifyImage(uint16_t startAddress, ImageSource &source, uint16_t length)
+{
+  return verify(startAddress, source, length);
+}
+
+uint32_t EEPROMProgrammer::getLastSourceCyclesPerPage() const
+{
+  return lastSourceCyclesPerPage;
+}
+
+uint16_t EEPROMProgrammer::getLastResumedPages() const
+{
+  return lastResumedPages;
+}
+
+bool EEPROMProgrammer::writeImageDifferential(uint16_t startAddress, ImageSource &source, uint16_t length,
+                                              WriteMode mode, CompletionMethod method)
+{
+  uint8_t page[PAGE_SIZE];
+  bool success = invalidateManifest(mode == WRITE_MODE_PAGE_PROTECTED);
+
+  lastDiffStats = DiffStats();
+  source.rewind();
+
+  uint16_t offset = 0;
+  while (offset < length && success)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    success = source.read(page, chunk) == chunk;
+
+    uint16_t changed = 0;
+    if (success && mode == WRITE_MODE_BYTE)
+    {
+      beginRead();
+      for (uint16_t i = 0; i < chunk && success; i++)
+      {
+        if (readAddress(address + i, offset == 0 && i == 0) != page[i])
+        {
+          endRead();
+          success = writeByte(address + i, page[i], false, method);
+          changed++;
+          beginRead();
+        }
+      }
+      endRead();
+    }
+    else if (success)
+    {
+      success = updatePage(address, page, chunk, &changed, mode == WRITE_MODE_PAGE_PROTECTED, offset == 0, method);
+    }
+
+    if (changed > 0)
+    {
+      lastDiffStats.pagesWritten++;
+    }
+    else
+    {
+      lastDiffStats.pagesSkipped++;
+    }
+    lastDiffStats.bytesWritten += changed;
+    lastDiffStats.bytesSkipped += chunk - changed;
+    lastDiffStats.pagesRead++;
+
+    offset += chunk;
+  }
+
+  return success && verifyImage(startAddress, source, length);
+}
+
+const EEPROMProgrammer::DiffStats &EEPROMProgrammer::getLastDiffStats() const
+{
+  return lastDiffStats;
+}
+
+bool EEPROMProgrammer::writeImageManifest(uint16_t startAddress, ImageSource &source, uint16_t length,
+                                          const uint32_t *pageCrcs, uint32_t imageId, WriteMode mode,
+                                          CompletionMethod method)
+{
+  if (!ImageManifest::fits(startAddress, length) || mode == WRITE_MODE_BYTE)
+  {
+    return writeImageDifferential(startAddress, source, length, mode, method);
+  }
+
+  bool sdpProtected = mode == WRITE_MODE_PAGE_PROTECTED;
+  uint16_t pages = ImageManifest::pageCount(startAddress, length);
+  uint8_t buffer[PAGE_SIZE];
+
+  lastDiffStats = DiffStats();
+
+  ImageManifest::Header stored;
+  readRange(ImageManifest::HEADER_ADDRESS, buffer, ImageManifest::HEADER_SIZE, true);
+  bool known = ImageManifest::decodeHeader(buffer, stored) && stored.start == startAddress;
+  if (known && stored.imageId == imageId && stored.length == length)
+  {
+    lastDiffStats.pagesSkipped = pages;
+    lastDiffStats.bytesSkipped = length;
+    return true;
+  }
+  bool hadManifest = known;
+
+  // One bit per page whose stored hash matches; the stored table is only
+  // trusted if its CRC does
+  uint8_t samePages[(ImageManifest::IMAGE_LIMIT / PAGE_SIZE + 7) / 8] = {0};
+  if (known)
+  {
+    uint16_t storedPages = ImageManifest::pageCount(stored.start, stored.length);
+    uint16_t tableAddress = ImageManifest::entryAddress(stored.start);
+    uint32_t tableCrc = 0xFFFFFFFF;
+    for (uint16_t page = 0; page < storedPages;)
+    {
+      uint16_t address = tableAddress + page * ImageManifest::ENTRY_SIZE;
+      uint16_t entries = (PAGE_SIZE - (address & PAGE_MASK)) / ImageManifest::ENTRY_SIZE;
+      if (entries > storedPages - page)
+      {
+        entries = storedPages - page;
+      }
+
+      readRange(address, buffer, entries * ImageManifest::ENTRY_SIZE, false);
+      tableCrc = ImageManifest::crc32Update(tableCrc, buffer, entries * ImageManifest::ENTRY_SIZE);
+      for (uint16_t i = 0; i < entries && page + i < pages; i++)
+      {
+        if (ProgrammingProtocol::readLE32(buffer + i * ImageManifest::ENTRY_SIZE) == pageCrcs[page + i])
+        {
+          samePages[(page + i) / 8] |= 1 << ((page + i) % 8);
+        }
+      }
+      page += entries;
+    }
+
+    if (tableCrc != stored.tableCrc)
+    {
+      known = false;
+      memset(samePages, 0, sizeof(samePages));
+    }
+  }
+
+  // From here on the chip no longer matches the manifest
+  bool success = !hadManifest || writePage(ImageManifest::HEADER_ADDRESS, &ImageManifest::INVALID_MAGIC, 1,
+                                           sdpProtected, true, method);
+  bool firstWrite = !hadManifest;
+
+  // Unmatched pages are read and written differentially, then read back
+  source.rewind();
+  uint16_t page = 0;
+  for (uint16_t offset = 0; offset < length && success; page++)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    success = source.read(buffer, chunk) == chunk;
+
+    uint16_t changed = 0;
+    if (success && !(samePages[page / 8] & (1 << (page % 8))))
+    {
+      success = writeVerified(address, buffer, chunk, &changed, sdpProtected, firstWrite, method);
+      firstWrite = false;
+      lastDiffStats.pagesRead++;
+    }
+
+    if (changed > 0)
+    {
+      lastDiffStats.pagesWritten++;
+    }
+    else
+    {
+      lastDiffStats.pagesSkipped++;
+    }
+    lastDiffStats.bytesWritten += changed;
+    lastDiffStats.bytesSkipped += chunk - changed;
+
+    offset += chunk;
+  }
+
+  // The table, differentially, so only entries that changed cost a write
+  ImageManifest::Header manifest;
+  manifest.imageId = imageId;
+  manifest.start = startAddress;
+  manifest.length = length;
+  manifest.tableCrc = 0xFFFFFFFF;
+  uint16_t tableAddress = ImageManifest::entryAddress(startAddress);
+  for (page = 0; page < pages && success;)
+  {
+    uint16_t address = tableAddress + page * ImageManifest::ENTRY_SIZE;
+    uint16_t entries = (PAGE_SIZE - (address & PAGE_MASK)) / ImageManifest::ENTRY_SIZE;
+    if (entries > pages - page)
+    {
+      entries = pages - page;
+    }
+
+    for (uint16_t i = 0; i < entries; i++)
+    {
+      ProgrammingProtocol::writeLE32(buffer + i * ImageManifest::ENTRY_SIZE, pageCrcs[page + i]);
+    }
+    manifest.tableCrc = ImageManifest::crc32Update(manifest.tableCrc, buffer, entries * ImageManifest::ENTRY_SIZE);
+    success = writeVerified(address, buffer, entries * ImageManifest::ENTRY_SIZE, nullptr, sdpProtected, firstWrite,
+                            method);
+    firstWrite = false;
+    page += entries;
+  }
+
+  // The header goes last: it is what makes the manifest valid
+  if (success)
+  {
+    ImageManifest::encodeHeader(manifest, buffer);
+    success = writeVerified(ImageManifest::HEADER_ADDRESS, buffer, ImageManifest::HEADER_SIZE, nullptr, sdpProtected,
+                            false, method);
+  }
+
+  return success;
+}
+
+bool EEPROMProgrammer::invalidateManifest(bool sdpProtected)
+{
+  uint8_t magic[4];
+  readRange(ImageManifest::HEADER_ADDRESS, magic, sizeof(magic), true);
+  if (ProgrammingProtocol::readLE32(magic) != ImageManifest::MAGIC)
+  {
+    return true;
+  }
+
+  return writePage(ImageManifest::HEADER_ADDRESS, &ImageManifest::INVALID_MAGIC, 1, sdpProtected, true);
+}
+
+void EEPROMProgrammer::readRange(uint16_t address, uint8_t *data, uint16_t length, bool shouldDelay)
+{
+  beginRead();
+  for (uint16_t i = 0; i < length; i++)
+  {
+    data[i] = readAddress(address + i, shouldDelay && i == 0);
+  }
+  endRead();
+}
+
+bool EEPROMProgrammer::writeVerified(uint16_t address, const uint8_t *data, uint16_t length, uint16_t *changed,
+                                     bool sdpProtected, bool shouldDelay, CompletionMethod method)
+{
+  uint16_t count;
+  if (changed == nullptr)
+  {
+    changed = &count;
+  }
+
+  // updatePage only confirms the last byte it loaded
+  return updatePage(address, data, length, changed, sdpProtected, shouldDelay, method) &&
+         (*changed == 0 || verifyData(address, data, length));
+}
+
+bool EEPROMProgrammer::verifyPageCrcs(uint16_t startAddress, uint16_t length, const uint32_t *pageCrcs,
+                                      ImageSource &source, VerifyResult *result)
+{
+  // One bit per page; an unaligned range can touch one extra page
+  uint8_t failedPages[(EEPROM_SIZE / PAGE_SIZE + 1 + 7) / 8] = {0};
+
+  result->pagesChecked = 0;
+  result->pagesFailed = 0;
+  result->rangeCount = 0;
+  result->truncated = false;
+
+  // Pass 1: stream every page through the CRC unit
+  beginRead();
+  uint16_t page = 0;
+  for (uint16_t offset = 0; offset < length; page++)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    HardwareCRC::reset();
+    uint32_t word = 0xFFFFFFFF;
+    for (uint16_t i = 0; i < chunk; i++)
+    {
+      uint32_t shift = (i & 3) * 8;
+      uint8_t data = readAddress(address + i, offset == 0 && i == 0);
+      word = (word & ~(0xFFu << shift)) | ((uint32_t)data << shift);
+      if ((i & 3) == 3)
+      {
+        HardwareCRC::feed(word);
+        word = 0xFFFFFFFF;
+      }
+    }
+    if (chunk & 3)
+    {
+      HardwareCRC::feed(word);
+    }
+
+    if (HardwareCRC::value() != pageCrcs[page])
+    {
+      failedPages[page / 8] |= 1 << (page % 8);
+      result->pagesFailed++;
+    }
+
+    offset += chunk;
+  }
+  endRead();
+  result->pagesChecked = page;
+
+  if (result->pagesFailed == 0)
+  {
+    return true;
+  }
+
+  // Pass 2: only failing pages are read again, against the image
+  uint8_t expected[PAGE_SIZE];
+  source.rewind();
+  page = 0;
+  for (uint16_t offset = 0; offset < length; page++)
+  {
+    uint16_t address = startAddress + offset;
+    uint16_t chunk = PAGE_SIZE - (address & PAGE_MASK);
+    if (chunk > length - offset)
+    {
+      chunk = length - offset;
+    }
+
+    if (source.read(expected, chunk) != chunk)
+    {
+      break;
+    }
+
+    if (failedPages[page / 8] & (1 << (page % 8)))
+    {
+      beginRead();
+      for (uint16_t i = 0; i < chunk; i++)
+      {
+        if (readAddress(address + i) != expected[i])
+        {
+          addMismatch(result, address + i);
+        }
+      }
+      endRead();
+    }
+
+    offset += chunk;
+  }
+
+  return false;
+}
+
+bool EEPROMProgrammer::verifyData(uint16_t startAddress, const uint8_t *data, uint16_t length)
+{
+  bool match = true;
+
+  beginRead();
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (readAddress(startAddress + i, i == 0) != data[i])
+    {
+      match = false;
+      break;
+    }
+  }
+  endRead();
+
+  return match;
+}
+
+void EEPROMProgrammer::dump(uint16_t startAddress, uint16_t length, DataSink &sink)
+{
+  uint8_t chunk[STREAM_CHUNK_SIZE];
+
+  for (uint16_t offset = 0; offset < length; offset += STREAM_CHUNK_SIZE)
+  {
+    uint16_t count = length - offset < STREAM_CHUNK_SIZE ? length - offset : STREAM_CHUNK_SIZE;
+
+    beginRead();
+    for (uint16_t i = 0; i < count; i++)
+    {
+      chunk[i] = readAddress(startAddress + offset + i);
+    }
+    endRead();
+
+    // The bus is released while the sink works (it may block on the USART)
+    sink.write(startAddress + offset, chunk, count);
+  }
+}
+
+bool EEPROMProgrammer::verify(uint16_t startAddress, ImageSource &source, uint16_t length, MismatchSink *mismatches)
+{
+  uint8_t chunk[STREAM_CHUNK_SIZE];
+  bool match = true;
+
+  source.rewind();
+
+  beginRead();
+  for (uint16_t offset = 0; offset < length; offset += STREAM_CHUNK_SIZE)
+  {
+    uint16_t count = length - offset < STREAM_CHUNK_SIZE ? length - offset : STREAM_CHUNK_SIZE;
+    if (source.read(chunk, count) != count)
+    {
+      match = false;
+      break;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+      uint16_t address = startAddress + offset + i;
+      uint8_t actual = readAddress(address, offset == 0 && i == 0);
+      if (actual != chunk[i])
+      {
+        match = false;
+        if (mismatches == nullptr)
+        {
+          break;
+        }
+        mismatches->mismatch(address, chunk[i], actual);
+      }
+    }
+
+    if (!match && mismatches == nullptr)
+    {
+      break;
+    }
+  }
+  endRead();
+
+  return match;
+}
+
+bool EEPROMProgrammer::characterizeTiming(uint16_t scratchAddress)
+{
+  uint16_t address = scratchAddress & ~PAGE_MASK;
+  uint8_t saved[PAGE_SIZE];
+  uint8_t pattern[PAGE_SIZE];
+
+  // Start from the datasheet values, so saving and restoring the page is safe
+  TimingProfile previous = timingProfile;
+  resetTimingProfile();
+
+  beginRead();
+  for (uint16_t i = 0; i < PAGE_SIZE; i++)
+  {
+    saved[i] = readAddress(address + i, i == 0);
+  }
+  endRead();
+
+  // Neighbouring bytes differ in every bit, so a read that comes too early
+  // and still sees the previous byte always fails the comparison. The first
+  // write probe stores the complement of this.
+  for (uint16_t i = 0; i < PAGE_SIZE; i++)
+  {
+    uint8_t value = (uint8_t)((i >> 1) * 0x25 + 0x5A);
+    pattern[i] = (i & 1) ? (uint8_t)~value : value;
+  }
+
+  // The write probes run first, while reads still use the datasheet values
+  TimingProfile measured = timingProfile;
+  measured.writeCycleMicros = 0;
+  bool success = findMinimumDelay(PROBE_FIRST_WRITE, timingProfile.firstWriteCycles, address, pattern,
+                                  &measured.firstWriteCycles);
+  // The last probe of the search may have been a failing one, so write the
+  // pattern once more with the full settle before the read sweeps use it
+  success = success && probeTiming(PROBE_FIRST_WRITE, timingProfile.firstWriteCycles, address, pattern);
+  success = success && findMinimumDelay(PROBE_ACCESS, timingProfile.accessCycles, address, pattern,
+                                        &measured.accessCycles);
+  success = success && findMinimumDelay(PROBE_OUTPUT_ENABLE, timingProfile.outputEnableCycles, address, pattern,
+                                        &measured.outputEnableCycles);
+  success = success && findMinimumDelay(PROBE_FIRST_READ, timingProfile.firstReadCycles, address, pattern,
+                                        &measured.firstReadCycles);
+  uint32_t writeCycleMicros = timingProfile.writeCycleMicros;
+
+  // Put the page back with the datasheet timings
+  success = programPage(address, saved, nullptr, PAGE_SIZE, false, true, COMPLETION_DATA_POLLING) && success;
+  ArrayImage savedImage(saved, PAGE_SIZE);
+  success = verify(address, savedImage, PAGE_SIZE) && success;
+
+  if (!success)
+  {
+    timingProfile = previous;
+    return false;
+  }
+
+  // Add the margin, but never wait longer than the datasheet asks for
+  uint32_t *delays[] = {&measured.accessCycles, &measured.outputEnableCycles, &measured.firstReadCycles,
+                        &measured.firstWriteCycles};
+  uint32_t limits[] = {timingProfile.accessCycles, timingProfile.outputEnableCycles, timingProfile.firstReadCycles,
+                       timingProfile.firstWriteCycles};
+  for (int i = 0; i < 4; i++)
+  {
+    uint32_t delay = *delays[i];
+    if (delay > 0)
+    {
+      delay += (delay * TIMING_MARGIN_PERCENT + 99) / 100;
+    }
+    *delays[i] = delay < limits[i] ? delay : limits[i];
+  }
+
+  // tWC grows with temperature and wear, so one fast cycle says nothing about
+  // the next; polling ends as soon as the chip is done anyway
+  measured.writeCycleMicros = writeCycleMicros;
+  measured.writeTimeoutMicros = WRITE_CYCLE_TIMEOUT_US;
+  measured.characterized = true;
+  timingProfile = measured;
+
+  return true;
+}
+
+bool EEPROMProgrammer::findMinimumDelay(TimingProbe probe, uint32_t maxCycles, uint16_t address, uint8_t *pattern,
+                                        uint32_t *found)
+{
+  // Double the delay until the chip keeps up, then bisect the last step.
+  // The settle times span microseconds, so a linear sweep would take long.
+  uint32_t failing = 0;
+  uint32_t passing = 0;
+  bool passed = false;
+  for (uint32_t delay = 0; !passed; delay = delay == 0 ? 1 : delay * 2)
+  {
+    if (delay > maxCycles)
+    {
+      delay = maxCycles;
+    }
+    if (probeTiming(probe, delay, address, pattern))
+    {
+      passing = delay;
+      passed = true;
+    }
+    else if (delay == maxCycles)
+    {
+      return false;
+    }
+    else
+    {
+      failing = delay;
+    }
+  }
+
+  while (passing > 0 && passing - failing > 1)
+  {
+    uint32_t middle = failing + (passing - failing) / 2;
+    if (probeTiming(probe, middle, address, pattern))
+    {
+      passing = middle;
+    }
+    else
+    {
+      failing = middle;
+    }
+  }
+
+  *found = passing;
+  return true;
+}
+
+bool EEPROMProgrammer::probeTiming(TimingProbe probe, uint32_t delayCycles, uint16_t address, uint8_t *pattern)
+{
+  bool match = true;
+
+  if (probe == PROBE_FIRST_WRITE)
+  {
+    // Complement the page so the write has to change every bit
+    for (uint16_t i = 0; i < PAGE_SIZE; i++)
+    {
+      pattern[i] = (uint8_t)~pattern[i];
+    }
+
+    uint32_t settle = timingProfile.firstWriteCycles;
+    timingProfile.firstWriteCycles = delayCycles;
+    match = programPage(address, pattern, nullptr, PAGE_SIZE, false, true, COMPLETION_DATA_POLLING);
+    timingProfile.firstWriteCycles = settle;
+    if (lastWriteCycleMicros > timingProfile.writeCycleMicros)
+    {
+      timingProfile.writeCycleMicros = lastWriteCycleMicros;
+    }
+
+    ArrayImage written(pattern, PAGE_SIZE);
+    return verify(address, written, PAGE_SIZE) && match;
+  }
+
+  // The read probes go through the same functions as the bulk paths, since
+  // at high core clocks the register accesses alone are part of the timing
+  TimingProfile datasheet = timingProfile;
+  if (probe == PROBE_ACCESS)
+  {
+    timingProfile.accessCycles = delayCycles;
+  }
+  else if (probe == PROBE_OUTPUT_ENABLE)
+  {
+    timingProfile.outputEnableCycles = delayCycles;
+  }
+  else
+  {
+    timingProfile.firstReadCycles = delayCycles;
+  }
+
+  for (uint8_t pass = 0; pass < CHARACTERIZE_PASSES && match; pass++)
+  {
+    beginRead();
+    for (uint16_t i = 0; i < PAGE_SIZE && match; i++)
+    {
+      // Park on the complement address first, so every address line changes
+      // on the timed read, as it does crossing 0x3FFF to 0x4000
+      uint16_t target = address + i;
+      uint16_t complement = target ^ (EEPROM_SIZE - 1);
+
+      uint8_t data;
+      if (probe == PROBE_ACCESS)
+      {
+        setAddress(complement);
+        data = readAddress(target, i == 0);
+      }
+      else if (probe == PROBE_OUTPUT_ENABLE)
+      {
+        // Address settled first, so only OE is timed
+        setPinHigh(controlPort, EEPROM_OE_PIN);
+        setAddress(target);
+        DelayUtil::delayCycles(datasheet.accessCycles);
+        data = readStatus();
+      }
+      else
+      {
+        // Every byte is the first read of its own session
+        setAddress(complement);
+        data = readAddress(target, true);
+        endRead();
+        beginRead();
+      }
+      match = data == pattern[i];
+    }
+    endRead();
+  }
+
+  timingProfile = datasheet;
+  return match;
+}
+
+const EEPROMProgrammer::TimingProfile &EEPROMProgrammer::getTimingProfile() const
+{
+  return timingProfile;
+}
+
+void EEPROMProgrammer::setTimingProfile(const TimingProfile &profile)
+{
+  timingProfile = profile;
+}
+
+void EEPROMProgrammer::resetTimingProfile()
+{
+  timingProfile.accessCycles = DelayUtil::nanosecondsToCycles(T_ACC_NS);
+  timingProfile.outputEnableCycles = DelayUtil::nanosecondsToCycles(T_OE_NS);
+  timingProfile.firstReadCycles = DelayUtil::microsecondsToCycles(FIRST_READ_SETTLE_US);
+  timingProfile.firstWriteCycles = DelayUtil::microsecondsToCycles(FIRST_WRITE_SETTLE_US);
+  timingProfile.writeCycleMicros = 0;
+  timingProfile.writeTimeoutMicros = WRITE_CYCLE_TIMEOUT_US;
+  timingProfile.characterized = false;
+}
+
+const Instrumentation &EEPROMProgrammer::getInstrumentation() const
+{
+  return instrumentation;
+}
+
+void EEPROMProgrammer::resetInstrumentation()
+{
+  instrumentation.reset();
+}
+
+void EEPROMProgrammer::blinkLED(int times)
+{
+  for (int i = 0; i < times; i++)
+  {
+    setPinLow(ledPort, STATUS_LED_PIN); // LED ON (active low)
+    DelayUtil::delayMilliseconds(BLINK_MS);
+
+    setPinHigh(ledPort, STATUS_LED_PIN); // LED OFF
+    DelayUtil::delayMilliseconds(BLINK_MS);
   }
 }
 
@@ -0,0 +1,49 @@
+#include "HardwareCRC.h"
+
+void HardwareCRC::begin()
+{
+  __HAL_RCC_CRC_CLK_ENABLE();
+  reset();
+}
+
+void HardwareCRC::reset()
+{
+  CRC->CR = CRC_CR_RESET;
+}
+
+void HardwareCRC::feed(uint32_t word)
+{
+  CRC->DR = word;
+}
+
+uint32_t HardwareCRC::value()
+{
+  return CRC->DR;
+}
+
+uint32_t HardwareCRC::compute(const uint8_t *data, uint16_t length)
+{
+  reset();
+  return update(data, length);
+}
+
+uint32_t HardwareCRC::update(const uint8_t *data, uint16_t length)
+{
+  uint32_t word = 0xFFFFFFFF;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    uint32_t shift = (i & 3) * 8;
+    word = (word & ~(0xFFu << shift)) | ((uint32_t)data[i] << shift);
+    if ((i & 3) == 3)
+    {
+      feed(word);
+      word = 0xFFFFFFFF;
+    }
+  }
+  if (length & 3)
+  {
+    feed(word);
+  }
+
+  return value();
+}
@@ -0,0 +1,71 @@
+#include "ImageManifest.h"
+#include "ProgrammingProtocol.h"
+
+using ProgrammingProtocol::readLE16;
+using ProgrammingProtocol::readLE32;
+using ProgrammingProtocol::writeLE16;
+using ProgrammingProtocol::writeLE32;
+
+bool ImageManifest::fits(uint16_t start, uint16_t length)
+{
+  return length > 0 && start % PAGE_SIZE == 0 && (uint32_t)start + length <= IMAGE_LIMIT;
+}
+
+uint16_t ImageManifest::pageCount(uint16_t start, uint16_t length)
+{
+  return (uint16_t)((start % PAGE_SIZE + length + PAGE_SIZE - 1) / PAGE_SIZE);
+}
+
+uint16_t ImageManifest::entryAddress(uint16_t pageAddress)
+{
+  return TABLE_ADDRESS + pageAddress / PAGE_SIZE * ENTRY_SIZE;
+}
+
+void ImageManifest::encodeHeader(const Header &header, uint8_t *out)
+{
+  writeLE32(out, MAGIC);
+  writeLE32(out + 4, header.imageId);
+  writeLE16(out + 8, header.start);
+  writeLE16(out + 10, header.length);
+  writeLE32(out + 12, header.tableCrc);
+  writeLE32(out + 16, 0xFFFFFFFF); // Reserved
+  writeLE32(out + 20, crc32(out, 20));
+}
+
+bool ImageManifest::decodeHeader(const uint8_t *in, Header &header)
+{
+  if (readLE32(in) != MAGIC || readLE32(in + 20) != crc32(in, 20))
+  {
+    return false;
+  }
+
+  header.imageId = readLE32(in + 4);
+  header.start = readLE16(in + 8);
+  header.length = readLE16(in + 10);
+  header.tableCrc = readLE32(in + 12);
+  return fits(header.start, header.length);
+}
+
+uint32_t ImageManifest::crc32(const uint8_t *data, size_t length)
+{
+  return crc32Update(0xFFFFFFFF, data, length);
+}
+
+uint32_t ImageManifest::crc32Update(uint32_t crc, const uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i += 4)
+  {
+    uint32_t word = 0;
+    for (int j = 3; j >= 0; j--)
+    {
+      word = (word << 8) | (i + j < length ? data[i + j] : 0xFF);
+    }
+
+    crc ^= word;
+    for (int bit = 0; bit < 32; bit++)
+    {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+  }
+  return crc;
+}
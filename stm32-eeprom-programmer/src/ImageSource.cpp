@@ -0,0 +1,50 @@
+#include "ImageSource.h"
+
+ArrayImage::ArrayImage(const uint8_t *data, uint16_t size)
+    : data(data), size(size), position(0)
+{
+}
+
+void ArrayImage::rewind()
+{
+  position = 0;
+}
+
+uint16_t ArrayImage::read(uint8_t *out, uint16_t length)
+{
+  uint16_t count = 0;
+  while (count < length && position < size)
+  {
+    out[count++] = data[position++];
+  }
+  return count;
+}
+
+LaneImage::LaneImage(ImageSource &words, Lane lane) : words(words), lane(lane)
+{
+}
+
+void LaneImage::rewind()
+{
+  words.rewind();
+}
+
+uint16_t LaneImage::read(uint8_t *out, uint16_t length)
+{
+  uint8_t chunk[CHUNK_WORDS * 2];
+  uint16_t count = 0;
+  while (count < length)
+  {
+    uint16_t wanted = length - count < CHUNK_WORDS ? length - count : CHUNK_WORDS;
+    uint16_t got = words.read(chunk, wanted * 2) / 2;
+    for (uint16_t i = 0; i < got; i++)
+    {
+      out[count++] = chunk[i * 2 + lane];
+    }
+    if (got < wanted)
+    {
+      break;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,101 @@
+#include "Instrumentation.h"
+
+Instrumentation::Instrumentation()
+{
+  reset();
+}
+
+void Instrumentation::reset()
+{
+  for (int phase = 0; phase < PHASE_COUNT; phase++)
+  {
+    phaseCycles[phase] = 0;
+    phaseCount[phase] = 0;
+  }
+  for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+  {
+    histogram[bucket] = 0;
+  }
+  writeCycles = 0;
+  retries = 0;
+  timeouts = 0;
+}
+
+void Instrumentation::addPhase(Phase phase, uint32_t cycles)
+{
+  phaseCycles[phase] += cycles;
+  phaseCount[phase]++;
+}
+
+void Instrumentation::recordWriteCycle(uint32_t microseconds, bool timedOut)
+{
+  uint8_t bucket = 0;
+  while (bucket < HISTOGRAM_BUCKETS - 1 && microseconds >= bucketLimitMicros(bucket))
+  {
+    bucket++;
+  }
+
+  histogram[bucket]++;
+  writeCycles++;
+  if (timedOut)
+  {
+    timeouts++;
+  }
+}
+
+void Instrumentation::recordRetry()
+{
+  retries++;
+}
+
+uint64_t Instrumentation::getPhaseCycles(Phase phase) const
+{
+  return phaseCycles[phase];
+}
+
+uint32_t Instrumentation::getPhaseCount(Phase phase) const
+{
+  return phaseCount[phase];
+}
+
+uint32_t Instrumentation::getHistogram(uint8_t bucket) const
+{
+  return bucket < HISTOGRAM_BUCKETS ? histogram[bucket] : 0;
+}
+
+uint32_t Instrumentation::getWriteCycles() const
+{
+  return writeCycles;
+}
+
+uint32_t Instrumentation::getRetries() const
+{
+  return retries;
+}
+
+uint32_t Instrumentation::getTimeouts() const
+{
+  return timeouts;
+}
+
+const char *Instrumentation::phaseName(Phase phase)
+{
+  switch (phase)
+  {
+  case PHASE_ADDRESS_SETUP:
+    return "address setup";
+  case PHASE_BUS_TURNAROUND:
+    return "bus turnaround";
+  case PHASE_WRITE_PULSE:
+    return "WE pulse";
+  case PHASE_COMPLETION_POLL:
+    return "completion polling";
+  default:
+    return "?";
+  }
+}
+
+uint32_t Instrumentation::bucketLimitMicros(uint8_t bucket)
+{
+  return bucket < HISTOGRAM_BUCKETS - 1 ? HISTOGRAM_BASE_US << bucket : 0;
+}
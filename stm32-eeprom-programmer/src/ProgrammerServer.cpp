@@ -0,0 +1,413 @@
+#include "ProgrammerServer.h"
+
+using namespace ProgrammingProtocol;
+
+ProgrammerServer::ProgrammerServer(ByteStream &stream, PageStore &store, Diagnostics *diagnostics,
+                                   Emulator *emulator)
+    : stream(stream), store(store), diagnostics(diagnostics), emulator(emulator), slotHead(0), slotCount(0),
+      sdpProtected(false), status(STATUS_OK), failedAddress(0), pagesWritten(0), pagesFailed(0),
+      pagesUnchanged(0), busOwner(BUS_CHIP)
+{
+}
+
+void ProgrammerServer::poll()
+{
+  // Only take bytes off the transport while a slot is free; anything else
+  // waits in the receive buffer until the next write cycle is done
+  while (slotCount < SLOT_COUNT)
+  {
+    int byte = stream.read();
+    if (byte < 0)
+    {
+      break;
+    }
+
+    FrameParser::Result result = parser.push((uint8_t)byte);
+    if (result == FrameParser::PARSE_FRAME)
+    {
+      handleFrame(parser.frame());
+    }
+    else if (result == FrameParser::PARSE_BAD_CRC)
+    {
+      sendAck(parser.frame().seq, STATUS_BAD_CRC);
+    }
+  }
+
+  if (slotCount > 0)
+  {
+    writeNextSlot();
+  }
+}
+
+void ProgrammerServer::flush()
+{
+  while (slotCount > 0)
+  {
+    writeNextSlot();
+  }
+}
+
+void ProgrammerServer::handleFrame(const Frame &frame)
+{
+  claimBus(frame.type);
+
+  switch (frame.type)
+  {
+  case FRAME_HELLO:
+  {
+    flush();
+    if (frame.length < 2 || frame.payload[1] != VERSION)
+    {
+      // Its frames would be parsed with another layout, so start no session
+      uint8_t payload[4] = {VERSION, (uint8_t)PAGE_SIZE, WINDOW, STATUS_BAD_VERSION};
+      send(FRAME_HELLO, frame.seq, payload, sizeof(payload));
+      break;
+    }
+
+    sdpProtected = frame.length > 0 && (frame.payload[0] & FLAG_SDP_PROTECTED);
+    status = STATUS_OK;
+    failedAddress = 0;
+    pagesWritten = 0;
+    pagesFailed = 0;
+    pagesUnchanged = 0;
+    store.beginSession();
+
+    uint8_t payload[4] = {VERSION, (uint8_t)PAGE_SIZE, WINDOW, STATUS_OK};
+    send(FRAME_HELLO, frame.seq, payload, sizeof(payload));
+    break;
+  }
+
+  case FRAME_WRITE:
+    handleWrite(frame);
+    break;
+
+  case FRAME_READ:
+    flush();
+    handleRead(frame);
+    break;
+
+  case FRAME_STATS:
+    flush();
+    handleStats(frame);
+    break;
+
+  case FRAME_BENCHMARK:
+    flush();
+    handleBenchmark(frame);
+    break;
+
+  case FRAME_ERASE:
+    flush();
+    sendAck(frame.seq, store.erase() ? STATUS_OK : STATUS_WRITE_FAILED);
+    break;
+
+  case FRAME_BLANK_CHECK:
+    flush();
+    handleBlankCheck(frame);
+    break;
+
+  case FRAME_CHARACTERIZE:
+    flush();
+    handleCharacterize(frame);
+    break;
+
+  case FRAME_CAPTURE:
+    flush();
+    handleCapture(frame);
+    break;
+
+  case FRAME_CAPTURE_READ:
+    handleCaptureRead(frame);
+    break;
+
+  case FRAME_EMULATE:
+    flush();
+    handleEmulate(frame);
+    break;
+
+  case FRAME_EMULATE_LOAD:
+    handleEmulateLoad(frame);
+    break;
+
+  case FRAME_FINISH:
+  {
+    flush();
+
+    uint8_t payload[7];
+    payload[0] = status;
+    writeLE16(payload + 1, pagesWritten);
+    writeLE16(payload + 3, pagesFailed);
+    writeLE16(payload + 5, pagesUnchanged);
+    send(FRAME_RESULT, frame.seq, payload, sizeof(payload));
+    break;
+  }
+
+  default:
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    break;
+  }
+}
+
+void ProgrammerServer::handleWrite(const Frame &frame)
+{
+  if (frame.length < 3 || frame.length > 2 + PAGE_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t address = readLE16(frame.payload);
+  uint8_t length = frame.length - 2;
+  if ((address & (PAGE_SIZE - 1)) + length > PAGE_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  PageSlot &slot = slots[(slotHead + slotCount) % SLOT_COUNT];
+  slot.address = address;
+  slot.length = length;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    slot.data[i] = frame.payload[2 + i];
+  }
+  slotCount++;
+
+  // Acknowledge before writing so the host can start sending the next page
+  sendAck(frame.seq, status);
+}
+
+void ProgrammerServer::handleRead(const Frame &frame)
+{
+  if (frame.length != 3 || frame.payload[2] == 0 || frame.payload[2] > PAGE_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t address = readLE16(frame.payload);
+  uint8_t length = frame.payload[2];
+
+  uint8_t payload[2 + PAGE_SIZE];
+  writeLE16(payload, address);
+  store.readBlock(address, payload + 2, length);
+  send(FRAME_DATA, frame.seq, payload, 2 + length);
+}
+
+void ProgrammerServer::handleStats(const Frame &frame)
+{
+  if (diagnostics == nullptr)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  DeviceStats stats;
+  diagnostics->readStats(stats, frame.length > 0 && (frame.payload[0] & FLAG_RESET_STATS));
+
+  uint8_t payload[STATS_PAYLOAD_SIZE];
+  send(FRAME_STATS_DATA, frame.seq, payload, encodeStats(stats, payload));
+}
+
+void ProgrammerServer::handleBenchmark(const Frame &frame)
+{
+  if (diagnostics == nullptr || frame.length != 4)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t address = readLE16(frame.payload);
+  uint16_t length = readLE16(frame.payload + 2);
+  if (length == 0 || (uint32_t)address + length > CHIP_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  BenchmarkResult result;
+  diagnostics->runBenchmark(address, length, result);
+
+  uint8_t payload[BENCHMARK_PAYLOAD_SIZE];
+  send(FRAME_BENCHMARK_RESULT, frame.seq, payload, encodeBenchmark(result, payload));
+}
+
+void ProgrammerServer::handleBlankCheck(const Frame &frame)
+{
+  if (frame.length != 4)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t address = readLE16(frame.payload);
+  uint16_t length = readLE16(frame.payload + 2);
+  if (length == 0 || (uint32_t)address + length > CHIP_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t firstUsed = 0;
+  uint8_t payload[3];
+  payload[0] = store.isBlank(address, length, firstUsed) ? 1 : 0;
+  writeLE16(payload + 1, firstUsed);
+  send(FRAME_BLANK_RESULT, frame.seq, payload, sizeof(payload));
+}
+
+void ProgrammerServer::handleCharacterize(const Frame &frame)
+{
+  if (diagnostics == nullptr || frame.length != 2 || readLE16(frame.payload) >= CHIP_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  TimingReport report;
+  diagnostics->characterize(readLE16(frame.payload), report);
+
+  uint8_t payload[TIMING_PAYLOAD_SIZE];
+  send(FRAME_TIMING, frame.seq, payload, encodeTiming(report, payload));
+}
+
+void ProgrammerServer::handleCapture(const Frame &frame)
+{
+  CaptureRequest request;
+  if (diagnostics == nullptr || !decodeCaptureRequest(frame.payload, frame.length, request) ||
+      request.sampleRateHz == 0)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  CaptureInfo info;
+  if (!diagnostics->capture(request, info))
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+  busOwner = BUS_CAPTURE;
+
+  uint8_t payload[CAPTURE_INFO_SIZE];
+  send(FRAME_CAPTURE_INFO, frame.seq, payload, encodeCaptureInfo(info, payload));
+}
+
+void ProgrammerServer::handleCaptureRead(const Frame &frame)
+{
+  if (diagnostics == nullptr || frame.length != 3 || frame.payload[2] == 0 ||
+      frame.payload[2] > CAPTURE_SAMPLES_PER_FRAME)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  uint16_t index = readLE16(frame.payload);
+  CaptureSample samples[CAPTURE_SAMPLES_PER_FRAME];
+  uint8_t count = diagnostics->readCapture(index, samples, frame.payload[2]);
+
+  uint8_t payload[2 + CAPTURE_SAMPLES_PER_FRAME * CAPTURE_SAMPLE_SIZE];
+  writeLE16(payload, index);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    encodeCaptureSample(samples[i], payload + 2 + i * CAPTURE_SAMPLE_SIZE);
+  }
+  send(FRAME_CAPTURE_DATA, frame.seq, payload, (uint8_t)(2 + count * CAPTURE_SAMPLE_SIZE));
+}
+
+void ProgrammerServer::handleEmulate(const Frame &frame)
+{
+  if (emulator == nullptr || frame.length != 1)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  EmulationInfo info;
+  emulator->describe(info);
+
+  uint8_t payload[EMULATION_INFO_SIZE];
+  send(FRAME_EMULATION_INFO, frame.seq, payload, encodeEmulationInfo(info, payload));
+
+  // Returns when the host sends its next frame
+  if (frame.payload[0] & FLAG_EMULATE_RUN)
+  {
+    busOwner = BUS_EMULATION;
+    emulator->run();
+  }
+}
+
+void ProgrammerServer::handleEmulateLoad(const Frame &frame)
+{
+  if (emulator == nullptr || frame.length < 3 || frame.length > 2 + PAGE_SIZE)
+  {
+    sendAck(frame.seq, STATUS_BAD_FRAME);
+    return;
+  }
+
+  bool loaded = emulator->load(readLE16(frame.payload), frame.payload + 2, frame.length - 2);
+  sendAck(frame.seq, loaded ? STATUS_OK : STATUS_BAD_FRAME);
+}
+
+void ProgrammerServer::claimBus(uint8_t frameType)
+{
+  // Frames that leave the chip alone keep the pins released
+  bool needsChip = frameType != FRAME_HELLO && frameType != FRAME_STATS && frameType != FRAME_CAPTURE &&
+                   frameType != FRAME_CAPTURE_READ && frameType != FRAME_EMULATE &&
+                   frameType != FRAME_EMULATE_LOAD && frameType != FRAME_FINISH;
+  if (busOwner == BUS_CHIP || !needsChip)
+  {
+    return;
+  }
+
+  if (busOwner == BUS_CAPTURE)
+  {
+    diagnostics->endCapture();
+  }
+  else
+  {
+    emulator->endEmulation();
+  }
+  busOwner = BUS_CHIP;
+}
+
+void ProgrammerServer::writeNextSlot()
+{
+  PageSlot &slot = slots[slotHead];
+
+  PageStore::WriteResult result = store.writePage(slot.address, slot.data, slot.length, sdpProtected);
+  if (result == PageStore::PAGE_WRITTEN)
+  {
+    pagesWritten++;
+  }
+  else if (result == PageStore::PAGE_UNCHANGED)
+  {
+    pagesUnchanged++;
+  }
+  else
+  {
+    pagesFailed++;
+    if (status == STATUS_OK)
+    {
+      status = STATUS_WRITE_FAILED;
+      failedAddress = slot.address;
+    }
+  }
+
+  slotHead = (slotHead + 1) % SLOT_COUNT;
+  slotCount--;
+}
+
+void ProgrammerServer::sendAck(uint8_t seq, uint8_t ackStatus)
+{
+  uint8_t payload[3];
+  payload[0] = ackStatus;
+  writeLE16(payload + 1, failedAddress);
+  send(FRAME_ACK, seq, payload, sizeof(payload));
+}
+
+void ProgrammerServer::send(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length)
+{
+  uint8_t buffer[MAX_PAYLOAD + FRAME_OVERHEAD];
+  size_t size = encodeFrame(type, seq, payload, length, buffer);
+  stream.write(buffer, (uint16_t)size);
+}
@@ -0,0 +1,307 @@
+#include "ProgrammingProtocol.h"
+
+uint16_t ProgrammingProtocol::crc16(const uint8_t *data, size_t length, uint16_t crc)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t ProgrammingProtocol::encodeFrame(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length, uint8_t *out)
+{
+  out[0] = SYNC;
+  out[1] = type;
+  out[2] = seq;
+  out[3] = length;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    out[4 + i] = payload[i];
+  }
+
+  uint16_t crc = crc16(out + 1, 3 + length);
+  writeLE16(out + 4 + length, crc);
+
+  return length + FRAME_OVERHEAD;
+}
+
+uint8_t ProgrammingProtocol::encodeStats(const DeviceStats &stats, uint8_t *out)
+{
+  uint8_t *p = out;
+  for (uint8_t phase = 0; phase < STATS_PHASES; phase++)
+  {
+    writeLE32(p, stats.phaseMicros[phase]);
+    writeLE32(p + 4, stats.phaseCount[phase]);
+    p += 8;
+  }
+  writeLE32(p, stats.writeCycles);
+  writeLE16(p + 4, stats.retries);
+  writeLE16(p + 6, stats.timeouts);
+  p += 8;
+  for (uint8_t bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; bucket++)
+  {
+    writeLE16(p, stats.histogram[bucket]);
+    p += 2;
+  }
+  return (uint8_t)(p - out);
+}
+
+bool ProgrammingProtocol::decodeStats(const uint8_t *payload, uint8_t length, DeviceStats &stats)
+{
+  if (length != STATS_PAYLOAD_SIZE)
+  {
+    return false;
+  }
+
+  const uint8_t *p = payload;
+  for (uint8_t phase = 0; phase < STATS_PHASES; phase++)
+  {
+    stats.phaseMicros[phase] = readLE32(p);
+    stats.phaseCount[phase] = readLE32(p + 4);
+    p += 8;
+  }
+  stats.writeCycles = readLE32(p);
+  stats.retries = readLE16(p + 4);
+  stats.timeouts = readLE16(p + 6);
+  p += 8;
+  for (uint8_t bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; bucket++)
+  {
+    stats.histogram[bucket] = readLE16(p);
+    p += 2;
+  }
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeBenchmark(const BenchmarkResult &result, uint8_t *out)
+{
+  out[0] = result.status;
+  writeLE16(out + 1, result.length);
+  writeLE32(out + 3, result.writeMicros);
+  writeLE32(out + 7, result.verifyMicros);
+  writeLE32(out + 11, result.dumpMicros);
+  return BENCHMARK_PAYLOAD_SIZE;
+}
+
+bool ProgrammingProtocol::decodeBenchmark(const uint8_t *payload, uint8_t length, BenchmarkResult &result)
+{
+  if (length != BENCHMARK_PAYLOAD_SIZE)
+  {
+    return false;
+  }
+
+  result.status = payload[0];
+  result.length = readLE16(payload + 1);
+  result.writeMicros = readLE32(payload + 3);
+  result.verifyMicros = readLE32(payload + 7);
+  result.dumpMicros = readLE32(payload + 11);
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeTiming(const TimingReport &report, uint8_t *out)
+{
+  out[0] = report.status;
+  writeLE16(out + 1, report.accessNs);
+  writeLE16(out + 3, report.outputEnableNs);
+  writeLE32(out + 5, report.firstReadNs);
+  writeLE32(out + 9, report.firstWriteNs);
+  writeLE32(out + 13, report.writeCycleMicros);
+  writeLE32(out + 17, report.writeTimeoutMicros);
+  return TIMING_PAYLOAD_SIZE;
+}
+
+bool ProgrammingProtocol::decodeTiming(const uint8_t *payload, uint8_t length, TimingReport &report)
+{
+  if (length != TIMING_PAYLOAD_SIZE)
+  {
+    return false;
+  }
+
+  report.status = payload[0];
+  report.accessNs = readLE16(payload + 1);
+  report.outputEnableNs = readLE16(payload + 3);
+  report.firstReadNs = readLE32(payload + 5);
+  report.firstWriteNs = readLE32(payload + 9);
+  report.writeCycleMicros = readLE32(payload + 13);
+  report.writeTimeoutMicros = readLE32(payload + 17);
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeCaptureRequest(const CaptureRequest &request, uint8_t *out)
+{
+  out[0] = request.flags;
+  writeLE16(out + 1, request.triggerAddress);
+  writeLE16(out + 3, request.preTrigger);
+  writeLE32(out + 5, request.sampleRateHz);
+  writeLE16(out + 9, request.timeoutMs);
+  return CAPTURE_REQUEST_SIZE;
+}
+
+bool ProgrammingProtocol::decodeCaptureRequest(const uint8_t *payload, uint8_t length, CaptureRequest &request)
+{
+  if (length != CAPTURE_REQUEST_SIZE)
+  {
+    return false;
+  }
+
+  request.flags = payload[0];
+  request.triggerAddress = readLE16(payload + 1);
+  request.preTrigger = readLE16(payload + 3);
+  request.sampleRateHz = readLE32(payload + 5);
+  request.timeoutMs = readLE16(payload + 9);
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeCaptureInfo(const CaptureInfo &info, uint8_t *out)
+{
+  out[0] = info.status;
+  out[1] = info.triggered;
+  writeLE16(out + 2, info.sampleCount);
+  writeLE16(out + 4, info.triggerIndex);
+  writeLE32(out + 6, info.sampleRateHz);
+  writeLE16(out + 10, info.missedSamples);
+  return CAPTURE_INFO_SIZE;
+}
+
+bool ProgrammingProtocol::decodeCaptureInfo(const uint8_t *payload, uint8_t length, CaptureInfo &info)
+{
+  if (length != CAPTURE_INFO_SIZE)
+  {
+    return false;
+  }
+
+  info.status = payload[0];
+  info.triggered = payload[1];
+  info.sampleCount = readLE16(payload + 2);
+  info.triggerIndex = readLE16(payload + 4);
+  info.sampleRateHz = readLE32(payload + 6);
+  info.missedSamples = readLE16(payload + 10);
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeEmulationInfo(const EmulationInfo &info, uint8_t *out)
+{
+  out[0] = info.status;
+  writeLE16(out + 1, info.capacity);
+  writeLE16(out + 3, info.loopCycles);
+  writeLE32(out + 5, info.accessNs);
+  writeLE32(out + 9, info.maxClockHz);
+  out[13] = info.lanes;
+  return EMULATION_INFO_SIZE;
+}
+
+bool ProgrammingProtocol::decodeEmulationInfo(const uint8_t *payload, uint8_t length, EmulationInfo &info)
+{
+  if (length != EMULATION_INFO_SIZE)
+  {
+    return false;
+  }
+
+  info.status = payload[0];
+  info.capacity = readLE16(payload + 1);
+  info.loopCycles = readLE16(payload + 3);
+  info.accessNs = readLE32(payload + 5);
+  info.maxClockHz = readLE32(payload + 9);
+  info.lanes = payload[13];
+  return true;
+}
+
+uint8_t ProgrammingProtocol::encodeCaptureSample(const CaptureSample &sample, uint8_t *out)
+{
+  writeLE16(out, sample.address);
+  out[2] = sample.data;
+  out[3] = sample.control;
+  return CAPTURE_SAMPLE_SIZE;
+}
+
+ProgrammingProtocol::CaptureSample ProgrammingProtocol::decodeCaptureSample(const uint8_t *data)
+{
+  CaptureSample sample;
+  sample.address = readLE16(data);
+  sample.data = data[2];
+  sample.control = data[3];
+  return sample;
+}
+
+FrameParser::FrameParser()
+{
+  reset();
+}
+
+void FrameParser::reset()
+{
+  state = WAIT_SYNC;
+  received = 0;
+  crc = 0xFFFF;
+}
+
+const Frame &FrameParser::frame() const
+{
+  return current;
+}
+
+FrameParser::Result FrameParser::push(uint8_t byte)
+{
+  switch (state)
+  {
+  case WAIT_SYNC:
+    if (byte == ProgrammingProtocol::SYNC)
+    {
+      crc = 0xFFFF;
+      state = READ_TYPE;
+    }
+    break;
+
+  case READ_TYPE:
+    current.type = byte;
+    crc = ProgrammingProtocol::crc16(&byte, 1, crc);
+    state = READ_SEQ;
+    break;
+
+  case READ_SEQ:
+    current.seq = byte;
+    crc = ProgrammingProtocol::crc16(&byte, 1, crc);
+    state = READ_LENGTH;
+    break;
+
+  case READ_LENGTH:
+    if (byte > ProgrammingProtocol::MAX_PAYLOAD)
+    {
+      reset();
+      break;
+    }
+    current.length = byte;
+    crc = ProgrammingProtocol::crc16(&byte, 1, crc);
+    received = 0;
+    state = byte == 0 ? READ_CRC_LOW : READ_PAYLOAD;
+    break;
+
+  case READ_PAYLOAD:
+    current.payload[received++] = byte;
+    crc = ProgrammingProtocol::crc16(&byte, 1, crc);
+    if (received == current.length)
+    {
+      state = READ_CRC_LOW;
+    }
+    break;
+
+  case READ_CRC_LOW:
+    received = byte;
+    state = READ_CRC_HIGH;
+    break;
+
+  case READ_CRC_HIGH:
+  {
+    uint16_t expected = (uint16_t)(received | (byte << 8));
+    bool valid = expected == crc;
+    reset();
+    return valid ? PARSE_FRAME : PARSE_BAD_CRC;
+  }
+  }
+
+  return PARSE_INCOMPLETE;
+}
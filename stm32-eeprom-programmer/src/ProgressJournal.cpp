@@ -0,0 +1,160 @@
+#include "ProgressJournal.h"
+#include "EEPROMProgrammer.h"
+#include "HardwareCRC.h"
+
+static_assert(ProgressJournal::JOURNAL_FLASH_PAGES * FLASH_PAGE_SIZE >=
+                  (ProgressJournal::HEADER_HALFWORDS + ProgressJournal::MAX_PAGES) * 2,
+              "journal does not fit its flash pages");
+static_assert(ProgressJournal::MAX_PAGES * EEPROMProgrammer::PAGE_SIZE == EEPROMProgrammer::EEPROM_SIZE,
+              "journal does not cover the chip");
+
+ProgressJournal::ProgressJournal() : pageCount(0), lastCommitted(-1), resumed(false), active(false)
+{
+}
+
+uint32_t ProgressJournal::hashImage(ImageSource &source, uint16_t length)
+{
+  // Whole words in every chunk but the last, as HardwareCRC::update needs
+  uint8_t chunk[EEPROMProgrammer::PAGE_SIZE];
+
+  source.rewind();
+  HardwareCRC::reset();
+  uint32_t crc = HardwareCRC::value();
+  for (uint16_t offset = 0; offset < length;)
+  {
+    uint16_t count = length - offset < EEPROMProgrammer::PAGE_SIZE ? length - offset : EEPROMProgrammer::PAGE_SIZE;
+    count = source.read(chunk, count);
+    if (count == 0)
+    {
+      break;
+    }
+    crc = HardwareCRC::update(chunk, count);
+    offset += count;
+  }
+  source.rewind();
+
+  return crc;
+}
+
+uint16_t ProgressJournal::open(uint32_t imageHash, uint16_t startAddress, uint16_t length, uint8_t chip)
+{
+  uint16_t firstPage = startAddress / EEPROMProgrammer::PAGE_SIZE;
+  uint16_t lastPage = (uint16_t)((startAddress + length - 1) / EEPROMProgrammer::PAGE_SIZE);
+  pageCount = length > 0 ? lastPage - firstPage + 1 : 0;
+  lastCommitted = -1;
+  resumed = false;
+  active = false;
+
+  uint16_t versionChip = (uint16_t)(VERSION | (chip << 8));
+  bool same = readField(FIELD_MAGIC) == MAGIC && readField(FIELD_VERSION_CHIP) == versionChip &&
+              readField(FIELD_HASH_LOW) == (uint16_t)imageHash &&
+              readField(FIELD_HASH_HIGH) == (uint16_t)(imageHash >> 16) && readField(FIELD_START) == startAddress &&
+              readField(FIELD_LENGTH) == length && readField(FIELD_CLOSED) == SESSION_OPEN;
+
+  uint16_t done = 0;
+  if (same)
+  {
+    for (uint16_t page = 0; page < pageCount; page++)
+    {
+      if (isDone(page))
+      {
+        done++;
+        lastCommitted = page;
+      }
+    }
+    resumed = done > 0;
+    active = true;
+    return done;
+  }
+
+  if (pageCount > MAX_PAGES || !eraseJournal())
+  {
+    return 0;
+  }
+
+  active = program(FIELD_VERSION_CHIP, versionChip) && program(FIELD_HASH_LOW, (uint16_t)imageHash) &&
+           program(FIELD_HASH_HIGH, (uint16_t)(imageHash >> 16)) && program(FIELD_START, startAddress) &&
+           program(FIELD_LENGTH, length) && program(FIELD_MAGIC, MAGIC);
+  return 0;
+}
+
+bool ProgressJournal::isDone(uint16_t page) const
+{
+  return page < pageCount && readField(HEADER_HALFWORDS + page) == PAGE_DONE;
+}
+
+bool ProgressJournal::markDone(uint16_t page)
+{
+  if (!active || page >= pageCount)
+  {
+    return false;
+  }
+  if (isDone(page))
+  {
+    return true;
+  }
+
+  if (!program(HEADER_HALFWORDS + page, PAGE_DONE))
+  {
+    return false;
+  }
+  if ((int32_t)page > lastCommitted)
+  {
+    lastCommitted = page;
+  }
+  return true;
+}
+
+int32_t ProgressJournal::getLastCommitted() const
+{
+  return lastCommitted;
+}
+
+bool ProgressJournal::isResumed() const
+{
+  return resumed;
+}
+
+void ProgressJournal::close()
+{
+  if (active)
+  {
+    program(FIELD_CLOSED, SESSION_CLOSED);
+    active = false;
+  }
+}
+
+volatile const uint16_t *ProgressJournal::journal()
+{
+  return (volatile const uint16_t *)(FLASH_BASE + JOURNAL_OFFSET);
+}
+
+uint16_t ProgressJournal::readField(uint16_t index)
+{
+  return journal()[index];
+}
+
+bool ProgressJournal::program(uint16_t index, uint16_t value)
+{
+  HAL_FLASH_Unlock();
+  bool ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, FLASH_BASE + JOURNAL_OFFSET + index * 2, value) == HAL_OK;
+  HAL_FLASH_Lock();
+
+  return ok && readField(index) == value;
+}
+
+bool ProgressJournal::eraseJournal()
+{
+  FLASH_EraseInitTypeDef erase;
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.Banks = FLASH_BANK_1;
+  erase.PageAddress = FLASH_BASE + JOURNAL_OFFSET;
+  erase.NbPages = JOURNAL_FLASH_PAGES;
+  uint32_t pageError = 0;
+
+  HAL_FLASH_Unlock();
+  bool ok = HAL_FLASHEx_Erase(&erase, &pageError) == HAL_OK;
+  HAL_FLASH_Lock();
+
+  return ok;
+}
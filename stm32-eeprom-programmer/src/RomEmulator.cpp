@@ -0,0 +1,214 @@
+#include "RomEmulator.h"
+#include "DelayUtil.h"
+
+#include <string.h>
+
+namespace
+{
+  template <uint8_t port>
+  constexpr uint16_t dataMask = PinMap::portMask(EEPROMProgrammer::DATA_PINS, port);
+
+  // A0-A4 on PA0-4, A5-A9 on PA8-12 and A10-A14 on PB5-9, so three shifts
+  // rebuild the address from the two IDR words without a table
+  constexpr uint16_t addressOf(uint32_t a, uint32_t b)
+  {
+    return (uint16_t)((a & 0x001F) | ((a >> 3) & 0x03E0) | ((b << 5) & 0x7C00));
+  }
+
+  constexpr bool addressLayoutMatches()
+  {
+    for (int bit = 0; bit < 15; bit++)
+    {
+      const PinDef &pin = EEPROMProgrammer::ADDRESS_PINS[bit];
+      uint32_t idr = pin.pin;
+      uint16_t decoded = pin.port == PIN_PORT_A   ? addressOf(idr, 0)
+                         : pin.port == PIN_PORT_B ? addressOf(0, idr)
+                                                  : 0;
+      if (decoded != (1u << bit))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static_assert(addressLayoutMatches(), "addressOf does not match EEPROMProgrammer::ADDRESS_PINS");
+  static_assert(dataMask<PIN_PORT_A> == 0 && (dataMask<PIN_PORT_C> & 0x00FF) == 0,
+                "RomEmulator switches the data pins through GPIOB CRL/CRH and GPIOC CRH");
+  static_assert(((dataMask<PIN_PORT_B> | PinMap::portMask(EEPROMProgrammer::ADDRESS_PINS, PIN_PORT_B)) &
+                 RomEmulator::HOST_RX_PIN) == 0,
+                "The host RX pin must not be a bus line");
+  static_assert(3 * RomEmulator::SIZE > 0x7FFF, "windowOffset subtracts SIZE at most twice");
+
+  // Address modulo SIZE, without a divide
+  inline uint16_t windowOffset(uint16_t address)
+  {
+    return address >= 2 * RomEmulator::SIZE ? address - 2 * RomEmulator::SIZE
+           : address >= RomEmulator::SIZE   ? address - RomEmulator::SIZE
+                                            : address;
+  }
+
+  // BSRR word per data byte, for one port
+  struct DataTable
+  {
+    uint32_t words[256];
+  };
+
+  template <uint8_t port>
+  constexpr DataTable dataTable()
+  {
+    DataTable table = {};
+    PinMap::ScatterTable scatter = PinMap::scatter(EEPROMProgrammer::DATA_PINS, port, 0);
+    for (int value = 0; value < 256; value++)
+    {
+      table.words[value] = PinMap::bsrr(scatter.set[value], dataMask<port>);
+    }
+    return table;
+  }
+
+  constexpr DataTable DATA_B = dataTable<PIN_PORT_B>();
+  constexpr DataTable DATA_C = dataTable<PIN_PORT_C>();
+
+  // CRL/CRH configuration nibbles (MODE[1:0] | CNF[1:0] << 2)
+  const uint32_t CR_NIBBLE_MASK = 0xF;
+  const uint32_t CR_OUTPUT_PUSH_PULL = 0x3;
+
+  constexpr uint32_t configBits(uint16_t pins, bool high, uint32_t nibble)
+  {
+    uint32_t value = 0;
+    for (int pin = 0; pin < 8; pin++)
+    {
+      if (pins & (1u << (pin + (high ? 8 : 0))))
+      {
+        value |= nibble << (pin * 4);
+      }
+    }
+    return value;
+  }
+
+  inline uint32_t withMode(uint32_t cr, uint16_t pins, bool high, uint32_t nibble)
+  {
+    return (cr & ~configBits(pins, high, CR_NIBBLE_MASK)) | configBits(pins, high, nibble);
+  }
+
+  const uint32_t SELECT_PINS = EEPROMProgrammer::EEPROM_CE_PIN | EEPROMProgrammer::EEPROM_OE_PIN;
+}
+
+RomEmulator::RomEmulator(EEPROMProgrammer &programmer, SharedBuffer &buffer)
+    : programmer(programmer), buffer(buffer), loopCycles(0)
+{
+}
+
+bool RomEmulator::load(uint16_t address, const uint8_t *data, uint16_t length)
+{
+  if ((uint32_t)address + length > SIZE)
+  {
+    return false;
+  }
+  memcpy(image() + address, data, length);
+  return true;
+}
+
+void RomEmulator::describe(ProgrammingProtocol::EmulationInfo &info)
+{
+  if (loopCycles == 0)
+  {
+    measure();
+  }
+
+  info.status = ProgrammingProtocol::STATUS_OK;
+  info.capacity = SIZE;
+  info.loopCycles = (uint16_t)loopCycles;
+  info.accessNs = (uint32_t)((2ull * loopCycles * 1000000000u + SystemCoreClock - 1) / SystemCoreClock);
+  info.maxClockHz = 1000000000u / info.accessNs;
+  info.lanes = 1;
+}
+
+void RomEmulator::run()
+{
+  programmer.releaseBus();
+
+  PortModes input = currentModes();
+  PortModes output = input;
+  output.dataLowB = withMode(input.dataLowB, dataMask<PIN_PORT_B>, false, CR_OUTPUT_PUSH_PULL);
+  output.dataHighB = withMode(input.dataHighB, dataMask<PIN_PORT_B>, true, CR_OUTPUT_PUSH_PULL);
+  output.dataHighC = withMode(input.dataHighC, dataMask<PIN_PORT_C>, true, CR_OUTPUT_PUSH_PULL);
+
+  serve<false>(input, output, 0);
+}
+
+void RomEmulator::endEmulation()
+{
+  programmer.claimBus();
+}
+
+uint8_t *RomEmulator::image()
+{
+  if (!buffer.take(this))
+  {
+    memset(buffer.data(), 0xFF, SIZE);
+  }
+  return buffer.data();
+}
+
+void RomEmulator::measure()
+{
+  // Every store of the calibration pass leaves the pins as they are
+  PortModes modes = currentModes();
+  uint32_t start = DelayUtil::cycles();
+  serve<true>(modes, modes, CALIBRATION_PASSES);
+  uint32_t elapsed = DelayUtil::cycles() - start;
+  loopCycles = (elapsed + CALIBRATION_PASSES - 1) / CALIBRATION_PASSES;
+}
+
+RomEmulator::PortModes RomEmulator::currentModes() const
+{
+  PortModes modes;
+  modes.dataLowB = GPIOB->CRL;
+  modes.dataHighB = GPIOB->CRH;
+  modes.dataHighC = GPIOC->CRH;
+  return modes;
+}
+
+template <bool calibrating>
+void RomEmulator::serve(const PortModes &input, const PortModes &output, uint32_t passes)
+{
+  // Calibration only times the lookups, so it leaves the buffer to its holder
+  const uint8_t *image = calibrating ? buffer.data() : this->image();
+
+  // The release left the data pins as floating inputs
+  bool driving = false;
+  for (;;)
+  {
+    uint32_t a = GPIOA->IDR;
+    uint32_t b = GPIOB->IDR;
+
+    // The data is stored while the pins are inputs too, so it is already
+    // there when they turn on
+    uint8_t data = image[windowOffset(addressOf(a, b))];
+    GPIOB->BSRR = calibrating ? 0 : DATA_B.words[data];
+    GPIOC->BSRR = calibrating ? 0 : DATA_C.words[data];
+
+    bool selected = (a & SELECT_PINS) == 0;
+    if (calibrating || selected != driving)
+    {
+      const PortModes &modes = selected ? output : input;
+      GPIOB->CRL = modes.dataLowB;
+      GPIOB->CRH = modes.dataHighB;
+      GPIOC->CRH = modes.dataHighC;
+      driving = selected;
+    }
+
+    if (calibrating ? --passes == 0 : (b & HOST_RX_PIN) == 0)
+    {
+      break;
+    }
+  }
+
+  if (driving)
+  {
+    GPIOB->CRL = input.dataLowB;
+    GPIOB->CRH = input.dataHighB;
+    GPIOC->CRH = input.dataHighC;
+  }
+}
@@ -0,0 +1,72 @@
+#include "SerialLink.h"
+
+SerialLink::SerialLink()
+{
+  rxTail = 0;
+}
+
+void SerialLink::begin(uint32_t baudRate)
+{
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_USART3_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Pin = TX_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = RX_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_INPUT;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  // 8N1, oversampling by 16: BRR holds PCLK1 / baud with 4 fraction bits
+  USART3->CR1 = 0;
+  USART3->BRR = (HAL_RCC_GetPCLK1Freq() + baudRate / 2) / baudRate;
+  USART3->CR3 = USART_CR3_DMAR;
+
+  // Circular peripheral-to-memory transfer, no interrupts; read() follows
+  // the DMA position through CNDTR
+  DMA1_Channel3->CCR = 0;
+  DMA1_Channel3->CPAR = (uint32_t)&USART3->DR;
+  DMA1_Channel3->CMAR = (uint32_t)rxBuffer;
+  DMA1_Channel3->CNDTR = RX_BUFFER_SIZE;
+  DMA1_Channel3->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_EN;
+  rxTail = 0;
+
+  USART3->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+}
+
+int SerialLink::read()
+{
+  if (rxTail == rxHead())
+  {
+    return -1;
+  }
+
+  uint8_t byte = rxBuffer[rxTail];
+  rxTail = (rxTail + 1) % RX_BUFFER_SIZE;
+  return byte;
+}
+
+void SerialLink::write(const uint8_t *data, uint16_t length)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    while (!(USART3->SR & USART_SR_TXE))
+    {
+    }
+    USART3->DR = data[i];
+  }
+
+  while (!(USART3->SR & USART_SR_TC))
+  {
+  }
+}
+
+uint16_t SerialLink::rxHead()
+{
+  return (RX_BUFFER_SIZE - DMA1_Channel3->CNDTR) % RX_BUFFER_SIZE;
+}
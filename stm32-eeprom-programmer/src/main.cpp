@@ -1,52 +1,40 @@
 #include "stm32f1xx_hal.h"
+#include "BusCapture.h"
 #include "EEPROMProgrammer.h"
+#include "EEPROMDiagnostics.h"
+#include "EEPROMPageStore.h"
+#include "ProgrammerServer.h"
+#include "RomEmulator.h"
+#include "SerialLink.h"
 
-// Global EEPROM programmer instance
+// Resident programmer firmware: images are streamed from the host with
+// host/programmer-client instead of being compiled into the firmware
 EEPROMProgrammer eeprom;
 
+// Capture and emulation never run at once, so the 6 KB of samples and the
+// 14 KB image share one buffer, kept off the stack
+alignas(4) uint8_t sharedMemory[RomEmulator::SIZE];
+static_assert(sizeof(BusCapture::Buffers) <= sizeof(sharedMemory), "capture buffers do not fit the shared buffer");
+SharedBuffer sharedBuffer(sharedMemory);
+BusCapture busCapture(eeprom, sharedBuffer);
+RomEmulator romEmulator(eeprom, sharedBuffer);
+SerialLink serialLink;
+
+static_assert(RomEmulator::HOST_RX_PIN == SerialLink::RX_PIN, "ROM emulation stops on the host's start bit");
+
 int main(void)
 {
-  // Initialize EEPROM programmer
+  // Initialize EEPROM programmer and the host link
   eeprom.begin();
+  serialLink.begin();
+  busCapture.begin();
 
-  // Simple delay function
-  volatile uint32_t delay_count;
-
-  const uint8_t programData[] = {
-      0x00,
-      0xEA,
-      0x00,
-      0xEF,
-      0x00,
-      0xFC,
-      0x00,
-      0xE4,
-      0x00,
-      0xE3,
-      0x00,
-      0xFC,
-      0x00,
-      0xF0,
-      0x00,
-      0xFD,
-      0x00,
-      0xEA,
-      0x00,
-      0xFC,
-      0x00,
-      0xE3,
-      0x00,
-      0xEA};
-
-  // volatile bool writeSuccess = eeprom.writeDataBlock(0x0000, programData, sizeof(programData));
-  volatile bool verified = eeprom.verifyData(0x0000, programData, sizeof(programData));
+  EEPROMPageStore store(eeprom);
+  EEPROMDiagnostics diagnostics(eeprom, &busCapture);
+  ProgrammerServer server(serialLink, store, &diagnostics, &romEmulator);
 
-  volatile uint8_t readData = eeprom.readByte(0x0000);
   while (1)
   {
-    for (delay_count = 0; delay_count < 2000000; delay_count++)
-    {
-    }
-    eeprom.blinkLED(1);
+    server.poll();
   }
-}
\ No newline at end of file
+}
@@ -26,6 +26,14 @@ public:
   void handleManualTriggerPress();
   void handleManualTriggerRelease();
 
+  // Burst mode: exactly the given number of pulses at the current setting,
+  // ending with the output high, so single-stepping can carry on from there.
+  // Manual mode only. Clocks with a short high half run the burst with
+  // interrupts off, so millis() and Serial wait for it; those bursts are
+  // refused beyond 20 ms.
+  bool startBurst(uint32_t pulses);
+  bool isBurstRunning() const;
+
   // Getters
   float getCurrentFrequency() const;
   unsigned long getCurrentPeriod() const; // Returns period in nanoseconds
@@ -33,15 +41,36 @@ public:
 
   // Setters for modular design
   void setFrequency(float frequency);
+  void setPotPosition(int potValue); // Looks the setting up in FREQUENCY_TABLE
 
   // Configuration
-  static const unsigned long MIN_FREQ = 1;        // 1 Hz
-  static const unsigned long MAX_FREQ = 10000000; // 10 MHz
+  static const unsigned long MIN_FREQ = 1;             // 1 Hz
+  static const unsigned long MAX_FREQ = F_CPU / 2;     // 8 MHz, Fast PWM with TOP 1
+  static const uint16_t FAST_PWM_MAX_PERIOD = 32;      // CPU cycles, 500 kHz and up
+
+  // Timer1 values for one output frequency. Phase Correct PWM (mode 10)
+  // runs a period of 2 * N * TOP cycles. Periods of up to
+  // FAST_PWM_MAX_PERIOD cycles may instead use Fast PWM (mode 14), N * (TOP + 1)
+  // cycles, which steps by one cycle, reaching F_CPU / 2, F_CPU / 3 and so on.
+  struct TimerSetting
+  {
+    uint16_t top;    // ICR1
+    uint8_t control; // TCCR1B bits: CS12:0, and FAST_PWM
+  };
+  static const uint8_t FAST_PWM = (1 << WGM12); // Turns mode 10 into mode 14
+
+  // Closest output period to the given frequency (in hundredths of a Hz)
+  // over every prescaler, TOP and mode, in integer math
+  static TimerSetting synthesize(uint32_t centihertz);
+
+  // Prints every frequency Fast PWM adds above the Phase Correct range
+  static void printFastFrequencies();
 
 private:
   // Pin definitions
   static const int MANUAL_MODE_PIN = 2;
   static const int MANUAL_TRIGGER_PIN = 3;
+  static const int BURST_TRIGGER_PIN = 4;
   static const int CLOCK_OUT_PIN = 9; // Timer1 OC1A pin
 
   // Clock state
@@ -49,16 +78,22 @@ private:
   volatile bool manualMode;
   volatile bool manualTriggerPressed;
 
+  // Timer1 limits in Phase Correct PWM
+  static const uint16_t MIN_TOP = 2;
+  static const uint16_t MAX_TOP = 65535;
+
   // Frequency calculation
   float currentFrequency;      // Actual frequency being generated
   unsigned long currentPeriod; // Actual period being generated (in nanoseconds)
-  float requestedFrequency;    // Requested frequency from setFrequency()
+  TimerSetting timerSetting;   // Requested setting from setFrequency() or setPotPosition()
 
   // Private methods
-  unsigned long calculatePeriod(float frequency); // Returns period in nanoseconds
   void setupPWM();
+  void retunePWM(); // Glitch-free, at the next BOTTOM
   void stopPWM();
-  void updatePWM();
+  void updateCurrentValues();
+  void printSetting();
+  void applySetting(const TimerSetting &setting);
 };
 
 #endif // CLOCK_CONTROLLER_H
\ No newline at end of file
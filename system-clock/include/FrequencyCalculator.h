@@ -15,6 +15,9 @@ public:
   // Update frequency based on potentiometer
   float updateFrequency();
 
+  // Read the potentiometer without the frequency math; true if it moved
+  bool updatePotValue();
+
   // Get current values
   float getCurrentFrequency() const;
   int getPotValue() const;
@@ -0,0 +1,15 @@
+// Generated by scripts/frequency-table.js - do not edit
+#ifndef FREQUENCY_TABLE_H
+#define FREQUENCY_TABLE_H
+
+#include <Arduino.h>
+#include "ClockController.h"
+
+// Timer1 setting for each pot position, over the range below
+const int FREQUENCY_TABLE_SIZE = 1024;
+const float FREQUENCY_TABLE_MIN = 0.1;
+const float FREQUENCY_TABLE_MAX = 8000000.0;
+
+extern const ClockController::TimerSetting FREQUENCY_TABLE[FREQUENCY_TABLE_SIZE] PROGMEM;
+
+#endif // FREQUENCY_TABLE_H
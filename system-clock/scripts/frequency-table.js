@@ -0,0 +1,160 @@
+#!/usr/bin/env node
+
+// Generates the Timer1 setting for every pot position, so the clock retunes
+// with a PROGMEM lookup. The pot curve mirrors
+// FrequencyCalculator::calculateFrequency in float precision, and the search
+// is ClockController::synthesize. Rerun after changing either, the range or
+// F_CPU:
+//
+//   node scripts/frequency-table.js
+
+const fs = require("fs");
+const path = require("path");
+
+const F_CPU = 16000000;
+const MIN_FREQUENCY = 0.1;
+const MAX_FREQUENCY = F_CPU / 2;
+const POSITIONS = 1024;
+
+// Timer1 clock divisors by CS12:0
+const PRESCALERS = [0, 1, 8, 64, 256, 1024];
+const MIN_TOP = 2;
+const MAX_TOP = 65535;
+const FAST_PWM = 0x08; // WGM12 in TCCR1B
+const FAST_PWM_MAX_PERIOD = 32;
+const FASTEST = F_CPU / 2;
+const SLOWEST = F_CPU / (2 * PRESCALERS[5] * MAX_TOP);
+
+function periodCycles(top, control) {
+  const prescaler = PRESCALERS[control & 0x07];
+  return control & FAST_PWM ? prescaler * (top + 1) : 2 * prescaler * top;
+}
+
+const f = Math.fround;
+
+function calculateFrequency(potValue) {
+  const logMin = f(Math.log10(MIN_FREQUENCY));
+  const logRange = f(f(Math.log10(MAX_FREQUENCY)) - logMin);
+  const normalized = f(potValue / 1023);
+
+  let mapped;
+  if (normalized <= 0.5) {
+    const x = f(normalized * 2);
+    mapped = f(f(x * x) * x);
+  } else {
+    const x = f(f(normalized - 0.5) * 2);
+    const inverse = f(1 - x);
+    mapped = f(0.5 + f(1 - f(f(inverse * inverse) * inverse)));
+  }
+
+  return f(Math.pow(10, f(logMin + f(mapped * logRange))));
+}
+
+// Least period error over every prescaler and mode; see
+// ClockController::synthesize
+function synthesize(centihertz) {
+  const clock = BigInt(F_CPU) * 100n;
+  let best = { top: MAX_TOP, control: PRESCALERS.length - 1 };
+  if (centihertz === 0) {
+    return best;
+  }
+
+  const target = BigInt(centihertz);
+  const targetCycles = Number(clock / target);
+  let bestError = null;
+  const consider = (top, control) => {
+    const product = BigInt(periodCycles(top, control)) * target;
+    const error = product > clock ? product - clock : clock - product;
+    if (bestError === null || error < bestError) {
+      bestError = error;
+      best = { top, control };
+    }
+  };
+
+  for (let clockSelect = 1; clockSelect < PRESCALERS.length; clockSelect++) {
+    for (let top = Math.floor(targetCycles / (2 * PRESCALERS[clockSelect])), step = 0; step < 2; step++, top++) {
+      consider(Math.min(Math.max(top, MIN_TOP), MAX_TOP), clockSelect);
+    }
+  }
+  if (targetCycles < FAST_PWM_MAX_PERIOD) {
+    for (let period = targetCycles; period <= targetCycles + 1; period++) {
+      consider(period < 2 ? 1 : period - 1, FAST_PWM | 1);
+    }
+  }
+  return best;
+}
+
+function generate() {
+  const entries = [];
+  let worst = { error: 0 };
+  for (let position = 0; position < POSITIONS; position++) {
+    // Anything above the fastest output clamps to it, as in setFrequency
+    const requested = calculateFrequency(position);
+    const setting = synthesize(Math.floor(Math.min(requested, FASTEST) * 100 + 0.5));
+    entries.push(setting);
+
+    const actual = F_CPU / periodCycles(setting.top, setting.control);
+    const error = Math.abs(actual - requested) / requested;
+    if (error > worst.error && requested >= SLOWEST && requested <= FASTEST) {
+      worst = { error, position, requested, actual };
+    }
+  }
+
+  const rows = [];
+  for (let i = 0; i < entries.length; i += 8) {
+    rows.push(
+      "    " +
+        entries
+          .slice(i, i + 8)
+          .map((entry) => `{${entry.top}, 0x${entry.control.toString(16).padStart(2, "0")}}`)
+          .join(", ")
+    );
+  }
+
+  const source = `// Generated by scripts/frequency-table.js - do not edit
+#include "FrequencyTable.h"
+
+static_assert(F_CPU == ${F_CPU}UL, "FREQUENCY_TABLE was generated for a ${F_CPU / 1000000} MHz clock");
+
+const ClockController::TimerSetting FREQUENCY_TABLE[FREQUENCY_TABLE_SIZE] PROGMEM = {
+${rows.join(",\n")}
+};
+`;
+
+  const header = `// Generated by scripts/frequency-table.js - do not edit
+#ifndef FREQUENCY_TABLE_H
+#define FREQUENCY_TABLE_H
+
+#include <Arduino.h>
+#include "ClockController.h"
+
+// Timer1 setting for each pot position, over the range below
+const int FREQUENCY_TABLE_SIZE = ${POSITIONS};
+const float FREQUENCY_TABLE_MIN = ${MIN_FREQUENCY};
+const float FREQUENCY_TABLE_MAX = ${MAX_FREQUENCY.toFixed(1)};
+
+extern const ClockController::TimerSetting FREQUENCY_TABLE[FREQUENCY_TABLE_SIZE] PROGMEM;
+
+#endif // FREQUENCY_TABLE_H
+`;
+
+  const root = path.join(__dirname, "..");
+  fs.writeFileSync(path.join(root, "include", "FrequencyTable.h"), header);
+  fs.writeFileSync(path.join(root, "src", "FrequencyTable.cpp"), source);
+
+  console.log(`Wrote ${POSITIONS} entries`);
+  const fastSteps = new Set(
+    entries.filter((entry) => entry.control & FAST_PWM).map((entry) => F_CPU / periodCycles(entry.top, entry.control))
+  );
+  console.log(`Fast PWM steps used: ${[...fastSteps].sort((a, b) => b - a).map((hz) => (hz / 1e6).toFixed(3)).join(", ")} MHz`);
+  console.log(
+    `Worst error: ${(worst.error * 100).toFixed(4)}% at position ${worst.position} ` +
+      `(${worst.requested.toFixed(3)} Hz -> ${worst.actual.toFixed(3)} Hz)`
+  );
+}
+
+if (require.main === module) {
+  generate();
+}
+
+module.exports = { calculateFrequency, synthesize };
@@ -1,11 +1,302 @@
 #include "ClockController.h"
+#include "FrequencyTable.h"
+
+namespace
+{
+  // Timer1 clock divisors by CS12:0; 0 stops the timer
+  const uint16_t PRESCALERS[] = {0, 1, 8, 64, 256, 1024};
+  const uint8_t CLOCK_SELECT_COUNT = sizeof(PRESCALERS) / sizeof(PRESCALERS[0]);
+  const uint8_t CLOCK_SELECT_MASK = (1 << CS12) | (1 << CS11) | (1 << CS10);
+
+  // F_CPU in hundredths of a Hz
+  const uint64_t CLOCK_CENTIHERTZ = (uint64_t)F_CPU * 100;
+
+  // Output period in CPU cycles
+  uint32_t periodCycles(uint16_t top, uint8_t control)
+  {
+    uint32_t prescaler = PRESCALERS[control & CLOCK_SELECT_MASK];
+    return (control & ClockController::FAST_PWM) ? prescaler * (top + 1UL) : 2 * prescaler * top;
+  }
+
+  // |cycles * f - F_CPU|: the period error times f, which every candidate shares
+  uint64_t periodError(uint32_t cycles, uint32_t centihertz)
+  {
+    uint64_t product = (uint64_t)cycles * centihertz;
+    return product > CLOCK_CENTIHERTZ ? product - CLOCK_CENTIHERTZ : CLOCK_CENTIHERTZ - product;
+  }
+
+  // Longest the BOTTOM interrupt can wait behind millis, Wire and Serial, in
+  // CPU cycles. A clock with a longer half period cannot go low and high
+  // again before the interrupt runs, so a high output is still the half that
+  // began at that BOTTOM.
+  const uint32_t MAX_INTERRUPT_LATENCY = 1024;
+
+  // Double buffer for retuning: the loop writes the next setting with
+  // interrupts off and TIMER1_OVF_vect applies it at the following BOTTOM
+  volatile uint16_t pendingTop;
+  volatile uint8_t pendingControl;
+
+  // Period Timer1 runs with, changed only with the timer stopped
+  uint32_t runningPeriod;
+
+  // Restarts the stopped Timer1 on a new setting without cutting the output
+  // level it holds short. A high output that has just passed BOTTOM finishes
+  // its half on the new setting, so that pulse lasts the mean of the old and
+  // new ones; otherwise the level is held for at least one more new half.
+  // Later pulses are the new ones.
+  void restartWaveform(uint16_t top, uint8_t control, bool afterBottom)
+  {
+    bool high = PINB & (1 << PINB1);
+    bool fast = control & ClockController::FAST_PWM;
+    uint16_t compare = fast ? (top - 1) / 2 : top / 2;
+
+    // OCR1A is double buffered in the PWM modes; normal mode writes it
+    // directly. The OC1A latch keeps its level across modes.
+    TCCR1A = (1 << COM1A1);
+    TCCR1B = 0;
+    ICR1 = top;
+    OCR1A = compare;
+
+    // Phase Correct is high from the down-count match through BOTTOM to the
+    // up-count one, low around TOP; either count direction only lengthens
+    // the level. Fast PWM is high from BOTTOM to the match, so a high
+    // output restarts from TOP.
+    if (high)
+    {
+      TCNT1 = fast ? top : afterBottom ? 0 : top - 1;
+    }
+    else
+    {
+      TCNT1 = compare;
+    }
+
+    TCCR1A = (1 << COM1A1) | (1 << WGM11);
+    OCR1A = compare; // Also into the buffer the PWM mode loads at TOP
+
+    // The prescaler is shared with Timer0, so resetting it would make
+    // millis() drift on every retune. The first tick may then come early,
+    // by up to one prescaler period. synthesize() only prescales when TOP
+    // cannot reach without it, which leaves TOP at 8192 or more, so that
+    // fraction of a tick is negligible.
+    TCCR1B = (1 << WGM13) | control;
+
+    runningPeriod = periodCycles(top, control);
+  }
+
+  // Stops Timer1 and hands the pin back to PORTB. The output latch is forced
+  // high first, so the next start connects without an edge.
+  void stopTimer()
+  {
+    TIMSK1 &= ~(1 << TOIE1);
+    TCCR1B = 0;
+    TCCR1A = (1 << COM1A1) | (1 << COM1A0); // Normal mode, set on compare match
+    TCCR1C = (1 << FOC1A);
+    TCCR1A = 0;
+  }
+
+  // Pulses a counted burst still has to finish; TIMER1_OVF_vect counts the
+  // BOTTOM after each one
+  volatile uint32_t burstRemaining;
+
+  // Starts Timer1 with run, then stores value to target gap cycles after
+  // that store (iterations * 6 - 1 + gap for the loop form). Timer1 runs on
+  // the CPU clock, so this counts its ticks exactly.
+  template <uint8_t gap>
+  void startThenStore(uint8_t run, volatile uint8_t *target, uint8_t value)
+  {
+    asm volatile("sts %[tccr1b], %[run]\n\t"
+                 ".rept %[gap]\n\t"
+                 "nop\n\t"
+                 ".endr\n\t"
+                 "st %a[target], %[value]\n\t"
+                 :
+                 : [tccr1b] "n"(_SFR_MEM_ADDR(TCCR1B)), [run] "r"(run), [gap] "n"(gap), [target] "e"(target),
+                   [value] "r"(value)
+                 : "memory");
+  }
+
+  template <uint8_t gap>
+  void startThenStoreAfter(uint32_t iterations, uint8_t run, volatile uint8_t *target, uint8_t value)
+  {
+    asm volatile("sts %[tccr1b], %[run]\n\t"
+                 "1: subi %A[count], 1\n\t"
+                 "sbci %B[count], 0\n\t"
+                 "sbci %C[count], 0\n\t"
+                 "sbci %D[count], 0\n\t"
+                 "brne 1b\n\t"
+                 ".rept %[gap]\n\t"
+                 "nop\n\t"
+                 ".endr\n\t"
+                 "st %a[target], %[value]\n\t"
+                 : [count] "+d"(iterations)
+                 : [tccr1b] "n"(_SFR_MEM_ADDR(TCCR1B)), [run] "r"(run), [gap] "n"(gap), [target] "e"(target),
+                   [value] "r"(value)
+                 : "memory");
+  }
+
+  typedef void (*TimedStore)(uint8_t run, volatile uint8_t *target, uint8_t value);
+  typedef void (*LoopedStore)(uint32_t iterations, uint8_t run, volatile uint8_t *target, uint8_t value);
+
+  const TimedStore TIMED_STORES[] = {
+      startThenStore<0>, startThenStore<1>, startThenStore<2>, startThenStore<3>,
+      startThenStore<4>, startThenStore<5>, startThenStore<6>, startThenStore<7>,
+      startThenStore<8>, startThenStore<9>, startThenStore<10>, startThenStore<11>,
+      startThenStore<12>, startThenStore<13>, startThenStore<14>, startThenStore<15>};
+  const uint8_t TIMED_STORE_COUNT = sizeof(TIMED_STORES) / sizeof(TIMED_STORES[0]);
+
+  const LoopedStore LOOPED_STORES[] = {startThenStoreAfter<0>, startThenStoreAfter<1>, startThenStoreAfter<2>,
+                                       startThenStoreAfter<3>, startThenStoreAfter<4>, startThenStoreAfter<5>};
+
+  // Timer1 ticks between the two stores beyond the cycles spent between
+  // them, measured once by calibrateTimedStores()
+  int8_t timedStoreLatency;
+  int8_t loopedStoreLatency;
+
+  void calibrateTimedStores()
+  {
+    const uint8_t run = (1 << CS10);
+    uint8_t oldSREG = SREG;
+    cli();
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1 = 0;
+    TIMED_STORES[8](run, &TCCR1B, 0);
+    timedStoreLatency = (int8_t)(TCNT1 - 8);
+    TCNT1 = 0;
+    LOOPED_STORES[0](4, run, &TCCR1B, 0);
+    loopedStoreLatency = (int8_t)(TCNT1 - (4 * 6 - 1));
+    SREG = oldSREG;
+  }
+
+  enum TimedBurstResult
+  {
+    TIMED_BURST_DONE,
+    TIMED_BURST_TOO_SHORT, // Over before the store sequence
+    TIMED_BURST_TOO_LONG,  // More than MAX_TIMED_BURST_TICKS
+  };
+
+  // Longest a timed burst may hold interrupts off, in CPU cycles: 20 ms, so
+  // the buttons and serial commands still answer at once. Longer bursts
+  // take a lower frequency, where the interrupt counts them.
+  const uint32_t MAX_TIMED_BURST_TICKS = F_CPU / 50;
+
+  // Runs a burst in Fast PWM without prescaler, with interrupts off for its
+  // whole length. OCR1A loads its buffer at BOTTOM, and OCR1A = TOP holds the
+  // output high, so TOP stored during the last period parks the output high
+  // right after it. The store is timed from the start to the middle of that
+  // period; two-tick periods stop the clock instead.
+  TimedBurstResult runTimedBurst(uint32_t pulses, uint16_t period)
+  {
+    // Also keeps the tick counts below within 32 bits
+    if (pulses > MAX_TIMED_BURST_TICKS / period)
+    {
+      return TIMED_BURST_TOO_LONG;
+    }
+
+    uint16_t top = period - 1;
+    uint16_t compare = (top - 1) / 2;
+
+    // The first tick wraps TOP to BOTTOM, so period k spans ticks
+    // (k - 1) * period + 1 to k * period. A store after tick t is seen by the
+    // reload at the start of period k if t < (k - 1) * period + 1.
+    uint32_t last = pulses * period;
+    uint32_t earliest = timedStoreLatency > 0 ? timedStoreLatency : 0;
+    uint32_t ticks;
+    volatile uint8_t *target;
+    uint8_t value;
+    if (period > 2)
+    {
+      // At least one tick clear of the reloads on either side
+      ticks = last - period + 1 + top / 2;
+      if (ticks < earliest)
+      {
+        ticks = earliest;
+      }
+      if (ticks > last - 1)
+      {
+        return TIMED_BURST_TOO_SHORT;
+      }
+      target = &OCR1AL;
+      value = top & 0xFF;
+    }
+    else
+    {
+      // Two ticks a period leave no tick clear of both reloads. Stop the
+      // clock on the last low tick instead: that is the store
+      // calibrateTimedStores() measures, so the count needs no margin.
+      // stopTimer() then raises the output where BOTTOM would have.
+      ticks = last;
+      if (ticks < earliest)
+      {
+        return TIMED_BURST_TOO_SHORT;
+      }
+      target = &TCCR1B;
+      value = 0;
+    }
+
+    uint8_t oldSREG = SREG;
+    cli();
+    TCCR1A = (1 << COM1A1); // The latch is still high from stopTimer()
+    TCCR1B = 0;
+    ICR1 = top;
+    OCR1A = compare;
+    TCNT1 = top;
+    TCCR1A = (1 << COM1A1) | (1 << WGM11);
+    OCR1A = compare;   // Also into the buffer
+    OCR1AH = top >> 8; // Held in TEMP until the timed low byte store
+
+    const uint8_t run = (1 << WGM13) | ClockController::FAST_PWM | (1 << CS10);
+    uint32_t gap = ticks - timedStoreLatency;
+    if (gap < TIMED_STORE_COUNT)
+    {
+      TIMED_STORES[gap](run, target, value);
+    }
+    else
+    {
+      gap = ticks - loopedStoreLatency + 1;
+      LOOPED_STORES[gap % 6](gap / 6, run, target, value);
+    }
+
+    // Two TOPs later the last period is over whichever one the first wait saw
+    for (uint8_t i = 0; i < 2 && target == &OCR1AL; i++)
+    {
+      TIFR1 = (1 << TOV1);
+      while (!(TIFR1 & (1 << TOV1)))
+      {
+      }
+    }
+    stopTimer();
+    SREG = oldSREG;
+    return TIMED_BURST_DONE;
+  }
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  if (burstRemaining > 0)
+  {
+    // The high half after the last BOTTOM outlasts the latency, so the
+    // clock stops high before another pulse begins
+    if (--burstRemaining == 0)
+    {
+      stopTimer();
+    }
+    return;
+  }
+
+  // Freeze the count and the output while Timer1 is reprogrammed
+  TCCR1B = (1 << WGM13);
+  TIMSK1 &= ~(1 << TOIE1);
+
+  restartWaveform(pendingTop, pendingControl, runningPeriod / 2 > MAX_INTERRUPT_LATENCY);
+}
 
 ClockController::ClockController()
 {
   clockState = false;
   manualMode = true;
   currentFrequency = 1.0;
-  requestedFrequency = 1.0;
+  timerSetting = synthesize(100);
   manualTriggerPressed = false;
   currentPeriod = 1000000000; // Default 1Hz period in nanoseconds
 }
@@ -15,6 +306,16 @@ void ClockController::setupPins()
   // Setup input pins with internal pull-up resistors
   pinMode(MANUAL_MODE_PIN, INPUT_PULLUP);
   pinMode(MANUAL_TRIGGER_PIN, INPUT_PULLUP);
+  pinMode(BURST_TRIGGER_PIN, INPUT_PULLUP);
+
+  calibrateTimedStores();
+
+  // Leave the Timer1 output latch high while the pin is still an input, so
+  // connecting OC1A later does not pull the clock low
+  TCCR1B = 0;
+  TCCR1A = (1 << COM1A1) | (1 << COM1A0); // Normal mode, set on compare match
+  TCCR1C = (1 << FOC1A);
+  TCCR1A = 0;
 
   // Setup clock output pin (Timer1 OC1A)
   pinMode(CLOCK_OUT_PIN, OUTPUT);
@@ -72,7 +373,7 @@ bool ClockController::isManualMode() const
 
 void ClockController::handleManualTriggerPress()
 {
-  if (manualMode && !manualTriggerPressed)
+  if (manualMode && !manualTriggerPressed && !isBurstRunning())
   {
     manualTriggerPressed = true;
     setClockLow(); // Set output to LOW when trigger is pressed
@@ -90,6 +391,64 @@ void ClockController::handleManualTriggerRelease()
   }
 }
 
+bool ClockController::startBurst(uint32_t pulses)
+{
+  if (!manualMode || manualTriggerPressed || isBurstRunning())
+  {
+    Serial.println("Burst needs manual mode with the clock high");
+    return false;
+  }
+  if (pulses == 0)
+  {
+    Serial.println("Burst size out of range");
+    return false;
+  }
+
+  updateCurrentValues();
+  Serial.print("Burst of ");
+  Serial.print(pulses);
+  Serial.print(" pulses - Actual: ");
+  printSetting();
+  Serial.flush(); // A timed burst holds interrupts off
+
+  // Count in the interrupt while it cannot miss the high half after BOTTOM
+  uint32_t period = periodCycles(timerSetting.top, timerSetting.control);
+  uint32_t highAfterBottom = (uint32_t)(timerSetting.top / 2) * PRESCALERS[timerSetting.control & CLOCK_SELECT_MASK];
+  if (!(timerSetting.control & FAST_PWM) && highAfterBottom > MAX_INTERRUPT_LATENCY)
+  {
+    uint8_t oldSREG = SREG;
+    cli();
+    burstRemaining = pulses;
+    restartWaveform(timerSetting.top, timerSetting.control, true);
+    TIFR1 = (1 << TOV1);
+    TIMSK1 |= (1 << TOIE1);
+    SREG = oldSREG;
+    return true;
+  }
+
+  TimedBurstResult result = runTimedBurst(pulses, (uint16_t)period);
+  if (result == TIMED_BURST_TOO_SHORT)
+  {
+    Serial.println("Burst too short for this frequency");
+    return false;
+  }
+  if (result == TIMED_BURST_TOO_LONG)
+  {
+    Serial.println("Burst too long to run with interrupts off at this frequency");
+    return false;
+  }
+  return true;
+}
+
+bool ClockController::isBurstRunning() const
+{
+  uint8_t oldSREG = SREG;
+  cli();
+  bool running = burstRemaining > 0;
+  SREG = oldSREG;
+  return running;
+}
+
 float ClockController::getCurrentFrequency() const
 {
   return currentFrequency;
@@ -107,140 +466,170 @@ bool ClockController::getClockState() const
 
 void ClockController::setFrequency(float frequency)
 {
-  // Only update if requested frequency has actually changed
-  if (abs(frequency - requestedFrequency) > 0.01) // Small tolerance for floating point comparison
+  // Nothing above F_CPU / 2 (Fast PWM, TOP 1) can be generated
+  const float fastest = F_CPU / 2.0;
+  if (frequency > fastest)
   {
-    requestedFrequency = frequency;
-
-    // Update PWM with new frequency only if not in manual mode
-    if (!manualMode)
-    {
-      updatePWM();
-    }
+    frequency = fastest;
   }
+  applySetting(synthesize(frequency > 0 ? (uint32_t)(frequency * 100 + 0.5) : 0));
 }
 
-unsigned long ClockController::calculatePeriod(float frequency)
+void ClockController::setPotPosition(int potValue)
 {
-  return (unsigned long)(1000000000.0 / frequency); // Returns period in nanoseconds
+  potValue = constrain(potValue, 0, FREQUENCY_TABLE_SIZE - 1);
+
+  TimerSetting setting;
+  memcpy_P(&setting, &FREQUENCY_TABLE[potValue], sizeof(setting));
+  applySetting(setting);
 }
 
-void ClockController::setupPWM()
+ClockController::TimerSetting ClockController::synthesize(uint32_t centihertz)
 {
-  // Stop any existing PWM
-  stopPWM();
-
-  // Configure Timer1 for PWM generation on OC1A (pin 9)
-  // Set pin as output
-  DDRB |= (1 << PB1); // Set PB1 (pin 9) as output
-
-  // Clear Timer1 registers
-  TCCR1A = 0;
-  TCCR1B = 0;
-  TCNT1 = 0;
-
-  // Calculate PWM values for desired frequency
-  unsigned long pwmTop;
-  unsigned char prescaler;
-  float actualFrequency;
-
-  // Calculate the best prescaler and top value for the frequency
-  if (requestedFrequency >= 1000000)
-  {
-    // High frequency: no prescaler
-    prescaler = (1 << CS10);                      // No prescaler
-    pwmTop = 16000000 / (2 * requestedFrequency); // 16MHz clock
-    actualFrequency = 16000000.0 / (2.0 * pwmTop);
-  }
-  else if (requestedFrequency >= 100000)
-  {
-    // Medium frequency: prescaler 8
-    prescaler = (1 << CS11);                     // Prescaler 8
-    pwmTop = 2000000 / (2 * requestedFrequency); // 2MHz with prescaler 8
-    actualFrequency = 2000000.0 / (2.0 * pwmTop);
-  }
-  else if (requestedFrequency >= 1.0)
+  TimerSetting best = {MAX_TOP, CLOCK_SELECT_COUNT - 1};
+  if (centihertz == 0)
   {
-    // Low frequency: prescaler 64
-    prescaler = (1 << CS11) | (1 << CS10);      // Prescaler 64
-    pwmTop = 250000 / (2 * requestedFrequency); // 250kHz with prescaler 64
-    actualFrequency = 250000.0 / (2.0 * pwmTop);
-  }
-  else
-  {
-    // Very low frequency: use prescaler 1024 for frequencies below 1 Hz
-    prescaler = (1 << CS12) | (1 << CS10);     // Prescaler 1024
-    pwmTop = 15625 / (2 * requestedFrequency); // 15.625kHz with prescaler 1024
-    actualFrequency = 15625.0 / (2.0 * pwmTop);
+    return best;
   }
 
-  // Ensure pwmTop is within valid range (minimum 2 for proper PWM operation)
-  if (pwmTop < 2)
-  {
-    pwmTop = 2;
-  }
-  else if (pwmTop > 65535)
+  // For each prescaler and mode only the two TOPs around the target can be
+  // closest. Ties keep Phase Correct and the smaller prescaler.
+  uint32_t targetCycles = CLOCK_CENTIHERTZ / centihertz;
+  uint64_t bestError = UINT64_MAX;
+  for (uint8_t clockSelect = 1; clockSelect < CLOCK_SELECT_COUNT; clockSelect++)
   {
-    pwmTop = 65535;
+    uint32_t top = targetCycles / (2UL * PRESCALERS[clockSelect]);
+    for (uint8_t step = 0; step < 2; step++, top++)
+    {
+      uint16_t clamped = top < MIN_TOP ? (uint16_t)MIN_TOP : top > MAX_TOP ? (uint16_t)MAX_TOP : (uint16_t)top;
+      uint64_t error = periodError(periodCycles(clamped, clockSelect), centihertz);
+      if (error < bestError)
+      {
+        bestError = error;
+        best.top = clamped;
+        best.control = clockSelect;
+      }
+    }
   }
 
-  // Recalculate actual frequency with clamped pwmTop
-  if (requestedFrequency >= 1000000)
-  {
-    actualFrequency = 16000000.0 / (2.0 * pwmTop);
-  }
-  else if (requestedFrequency >= 100000)
+  // Short periods also try Fast PWM without prescaler, in one-cycle steps
+  if (targetCycles < FAST_PWM_MAX_PERIOD)
   {
-    actualFrequency = 2000000.0 / (2.0 * pwmTop);
-  }
-  else if (requestedFrequency >= 1.0)
-  {
-    actualFrequency = 250000.0 / (2.0 * pwmTop);
+    for (uint32_t period = targetCycles; period <= targetCycles + 1; period++)
+    {
+      uint16_t top = period < 2 ? 1 : period - 1;
+      uint8_t control = FAST_PWM | (1 << CS10);
+      uint64_t error = periodError(periodCycles(top, control), centihertz);
+      if (error < bestError)
+      {
+        bestError = error;
+        best.top = top;
+        best.control = control;
+      }
+    }
   }
-  else
+  return best;
+}
+
+void ClockController::printFastFrequencies()
+{
+  // Phase Correct covers the even periods from 4 cycles; Fast PWM adds 2 and the odd ones
+  Serial.print("Fast PWM steps (Hz):");
+  for (uint16_t period = 2; period <= FAST_PWM_MAX_PERIOD; period++)
   {
-    actualFrequency = 15625.0 / (2.0 * pwmTop);
+    if (period == 2 || period % 2 == 1)
+    {
+      Serial.print(' ');
+      Serial.print(F_CPU / period);
+    }
   }
+  Serial.println();
+}
 
-  // Set ICR1 as top value for Phase Correct PWM
-  ICR1 = pwmTop;
+void ClockController::setupPWM()
+{
+  // Stop any existing PWM, leaving the output high
+  stopPWM();
+  setClockHigh();
 
-  // Set OCR1A for 50% duty cycle (square wave)
-  OCR1A = pwmTop / 2;
+  // Configure Timer1 for PWM generation on OC1A (pin 9)
+  // Set pin as output
+  DDRB |= (1 << PB1); // Set PB1 (pin 9) as output
 
-  // Configure Timer1 for Phase Correct PWM with ICR1 as top
-  // COM1A1:0 = 10 for non-inverting PWM on OC1A
-  // WGM13:0 = 1010 for Phase Correct PWM with ICR1 as top
-  TCCR1A = (1 << COM1A1) | (1 << WGM11);
-  TCCR1B = (1 << WGM13) | prescaler;
+  // Phase Correct (WGM13:0 = 1010) or Fast PWM (1110) with ICR1 as top,
+  // non-inverting on OC1A, 50% duty cycle (a cycle less high for odd Fast PWM
+  // periods); the high output starts from BOTTOM
+  uint8_t oldSREG = SREG;
+  cli();
+  restartWaveform(timerSetting.top, timerSetting.control, true);
+  SREG = oldSREG;
+
+  updateCurrentValues();
+  Serial.print("PWM started - Actual: ");
+  printSetting();
+}
 
-  // Update the actual frequency and period being generated
-  currentFrequency = actualFrequency;
-  currentPeriod = calculatePeriod(actualFrequency);
-
-  Serial.print("PWM started - Requested: ");
-  Serial.print(requestedFrequency);
-  Serial.print(" Hz, Actual: ");
-  Serial.print(actualFrequency);
-  Serial.print(" Hz, Top: ");
-  Serial.print(pwmTop);
-  Serial.println();
+void ClockController::retunePWM()
+{
+  // Replaces a setting still waiting for its BOTTOM. The stale flag is
+  // cleared so the interrupt waits for the next BOTTOM.
+  uint8_t oldSREG = SREG;
+  cli();
+  pendingTop = timerSetting.top;
+  pendingControl = timerSetting.control;
+  TIFR1 = (1 << TOV1);
+  TIMSK1 |= (1 << TOIE1);
+  SREG = oldSREG;
+
+  updateCurrentValues();
+  Serial.print("PWM retuned - Actual: ");
+  printSetting();
 }
 
 void ClockController::stopPWM()
 {
-  // Stop Timer1
-  TCCR1A = 0;
-  TCCR1B = 0;
+  // Stop Timer1 and drop any pending retune or unfinished burst
+  uint8_t oldSREG = SREG;
+  cli();
+  burstRemaining = 0;
+  stopTimer();
+  SREG = oldSREG;
 
   Serial.println("PWM stopped");
 }
 
-void ClockController::updatePWM()
+void ClockController::updateCurrentValues()
+{
+  // Update the actual frequency and period being generated
+  uint32_t cycles = periodCycles(timerSetting.top, timerSetting.control);
+  uint64_t periodNs = (uint64_t)cycles * 1000000000ULL / F_CPU;
+  currentFrequency = (float)F_CPU / cycles;
+  currentPeriod = periodNs > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (unsigned long)periodNs;
+}
+
+void ClockController::printSetting()
 {
-  // Only reconfigure PWM if requested frequency has changed since last configuration
-  if (abs(requestedFrequency - currentFrequency) > 0.01) // Small tolerance for floating point comparison
+  Serial.print(currentFrequency);
+  Serial.print(" Hz, Prescaler: ");
+  Serial.print(PRESCALERS[timerSetting.control & CLOCK_SELECT_MASK]);
+  Serial.print(", Top: ");
+  Serial.print(timerSetting.top);
+  Serial.println((timerSetting.control & FAST_PWM) ? ", Fast PWM" : ", Phase Correct");
+}
+
+void ClockController::applySetting(const TimerSetting &setting)
+{
+  // Only reconfigure PWM if the timer values have actually changed
+  if (setting.top == timerSetting.top && setting.control == timerSetting.control)
   {
-    setupPWM();
+    return;
   }
-}
\ No newline at end of file
+  timerSetting = setting;
+
+  // Retune the running PWM at its next BOTTOM; in manual mode the setting
+  // waits for startClock()
+  if (!manualMode)
+  {
+    retunePWM();
+  }
+}
@@ -17,6 +17,17 @@ FrequencyCalculator::FrequencyCalculator(int potPin, float minFreq, float maxFre
 }
 
 float FrequencyCalculator::updateFrequency()
+{
+  if (updatePotValue())
+  {
+    // Calculate frequency using logarithmic scale
+    currentFrequency = calculateFrequency(currentPotValue);
+  }
+
+  return currentFrequency;
+}
+
+bool FrequencyCalculator::updatePotValue()
 {
   // Read potentiometer value (0-1023)
   int newPotValue = analogRead(potPin);
@@ -26,12 +37,10 @@ float FrequencyCalculator::updateFrequency()
   {
     currentPotValue = newPotValue;
     lastPotValue = newPotValue;
-
-    // Calculate frequency using logarithmic scale
-    currentFrequency = calculateFrequency(currentPotValue);
+    return true;
   }
 
-  return currentFrequency;
+  return false;
 }
 
 float FrequencyCalculator::getCurrentFrequency() const
@@ -0,0 +1,135 @@
+// Generated by scripts/frequency-table.js - do not edit
+#include "FrequencyTable.h"
+
+static_assert(F_CPU == 16000000UL, "FREQUENCY_TABLE was generated for a 16 MHz clock");
+
+const ClockController::TimerSetting FREQUENCY_TABLE[FREQUENCY_TABLE_SIZE] PROGMEM = {
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05},
+    {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65535, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05},
+    {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05},
+    {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {65104, 0x05}, {60096, 0x05}, {60096, 0x05},
+    {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {60096, 0x05},
+    {60096, 0x05}, {60096, 0x05}, {60096, 0x05}, {55804, 0x05}, {55804, 0x05}, {55804, 0x05}, {55804, 0x05}, {55804, 0x05},
+    {55804, 0x05}, {55804, 0x05}, {55804, 0x05}, {55804, 0x05}, {52083, 0x05}, {52083, 0x05}, {52083, 0x05}, {52083, 0x05},
+    {52083, 0x05}, {52083, 0x05}, {52083, 0x05}, {52083, 0x05}, {48828, 0x05}, {48828, 0x05}, {48828, 0x05}, {48828, 0x05},
+    {48828, 0x05}, {48828, 0x05}, {48828, 0x05}, {45956, 0x05}, {45956, 0x05}, {45956, 0x05}, {45956, 0x05}, {45956, 0x05},
+    {45956, 0x05}, {43403, 0x05}, {43403, 0x05}, {43403, 0x05}, {43403, 0x05}, {43403, 0x05}, {41118, 0x05}, {41118, 0x05},
+    {41118, 0x05}, {41118, 0x05}, {39062, 0x05}, {39062, 0x05}, {39062, 0x05}, {39062, 0x05}, {39062, 0x05}, {37202, 0x05},
+    {37202, 0x05}, {37202, 0x05}, {35511, 0x05}, {35511, 0x05}, {35511, 0x05}, {35511, 0x05}, {33967, 0x05}, {33967, 0x05},
+    {33967, 0x05}, {32552, 0x05}, {32552, 0x05}, {32552, 0x05}, {31250, 0x05}, {31250, 0x05}, {31250, 0x05}, {30048, 0x05},
+    {30048, 0x05}, {28935, 0x05}, {28935, 0x05}, {28935, 0x05}, {27902, 0x05}, {27902, 0x05}, {26940, 0x05}, {26940, 0x05},
+    {26042, 0x05}, {26042, 0x05}, {25202, 0x05}, {25202, 0x05}, {24414, 0x05}, {24414, 0x05}, {23674, 0x05}, {23674, 0x05},
+    {22978, 0x05}, {22321, 0x05}, {22321, 0x05}, {21701, 0x05}, {21115, 0x05}, {21115, 0x05}, {20559, 0x05}, {20032, 0x05},
+    {20032, 0x05}, {19531, 0x05}, {19055, 0x05}, {18601, 0x05}, {18169, 0x05}, {18169, 0x05}, {17756, 0x05}, {17361, 0x05},
+    {16984, 0x05}, {16622, 0x05}, {65104, 0x04}, {63776, 0x04}, {62500, 0x04}, {61275, 0x04}, {60096, 0x04}, {58962, 0x04},
+    {56818, 0x04}, {55804, 0x04}, {54825, 0x04}, {53879, 0x04}, {52083, 0x04}, {51230, 0x04}, {49603, 0x04}, {48828, 0x04},
+    {47348, 0x04}, {46642, 0x04}, {45290, 0x04}, {44643, 0x04}, {43403, 0x04}, {42230, 0x04}, {41118, 0x04}, {40064, 0x04},
+    {39062, 0x04}, {38110, 0x04}, {37202, 0x04}, {36337, 0x04}, {35511, 0x04}, {34722, 0x04}, {33602, 0x04}, {32895, 0x04},
+    {31888, 0x04}, {30941, 0x04}, {30340, 0x04}, {29481, 0x04}, {28670, 0x04}, {27902, 0x04}, {27174, 0x04}, {26261, 0x04},
+    {25615, 0x04}, {24802, 0x04}, {24225, 0x04}, {23496, 0x04}, {22810, 0x04}, {22163, 0x04}, {21552, 0x04}, {20833, 0x04},
+    {20292, 0x04}, {19654, 0x04}, {19055, 0x04}, {18491, 0x04}, {17960, 0x04}, {17361, 0x04}, {16801, 0x04}, {65104, 0x03},
+    {63131, 0x03}, {61275, 0x03}, {59242, 0x03}, {57339, 0x03}, {55556, 0x03}, {53648, 0x03}, {51867, 0x03}, {50201, 0x03},
+    {48638, 0x03}, {46992, 0x03}, {45290, 0x03}, {43860, 0x03}, {42373, 0x03}, {40850, 0x03}, {39432, 0x03}, {38110, 0x03},
+    {36765, 0x03}, {35511, 0x03}, {34247, 0x03}, {32982, 0x03}, {31807, 0x03}, {30637, 0x03}, {29551, 0x03}, {28474, 0x03},
+    {27412, 0x03}, {26371, 0x03}, {25407, 0x03}, {24462, 0x03}, {23540, 0x03}, {22604, 0x03}, {21739, 0x03}, {20903, 0x03},
+    {20096, 0x03}, {19320, 0x03}, {18574, 0x03}, {17832, 0x03}, {17123, 0x03}, {16426, 0x03}, {15763, 0x03}, {15133, 0x03},
+    {14518, 0x03}, {13920, 0x03}, {13340, 0x03}, {12794, 0x03}, {12255, 0x03}, {11737, 0x03}, {11241, 0x03}, {10767, 0x03},
+    {10305, 0x03}, {9858, 0x03}, {9434, 0x03}, {9019, 0x03}, {8627, 0x03}, {8245, 0x03}, {63052, 0x02}, {60241, 0x02},
+    {57537, 0x02}, {54915, 0x02}, {52438, 0x02}, {50050, 0x02}, {47733, 0x02}, {45537, 0x02}, {43422, 0x02}, {41391, 0x02},
+    {39448, 0x02}, {37580, 0x02}, {35791, 0x02}, {34083, 0x02}, {32446, 0x02}, {30874, 0x02}, {29377, 0x02}, {27941, 0x02},
+    {26567, 0x02}, {25253, 0x02}, {23998, 0x02}, {22800, 0x02}, {21654, 0x02}, {20559, 0x02}, {19516, 0x02}, {18519, 0x02},
+    {17569, 0x02}, {16661, 0x02}, {15795, 0x02}, {14970, 0x02}, {14184, 0x02}, {13437, 0x02}, {12724, 0x02}, {12045, 0x02},
+    {11400, 0x02}, {10786, 0x02}, {10202, 0x02}, {9646, 0x02}, {9118, 0x02}, {8616, 0x02}, {65115, 0x01}, {61496, 0x01},
+    {58059, 0x01}, {54795, 0x01}, {51700, 0x01}, {48766, 0x01}, {45982, 0x01}, {43346, 0x01}, {40848, 0x01}, {38480, 0x01},
+    {36240, 0x01}, {34120, 0x01}, {32112, 0x01}, {30214, 0x01}, {28418, 0x01}, {26721, 0x01}, {25118, 0x01}, {23603, 0x01},
+    {22172, 0x01}, {20821, 0x01}, {19547, 0x01}, {18345, 0x01}, {17211, 0x01}, {16141, 0x01}, {15134, 0x01}, {14185, 0x01},
+    {13291, 0x01}, {12449, 0x01}, {11656, 0x01}, {10911, 0x01}, {10210, 0x01}, {9551, 0x01}, {8931, 0x01}, {8349, 0x01},
+    {7802, 0x01}, {7288, 0x01}, {6807, 0x01}, {6354, 0x01}, {5930, 0x01}, {5533, 0x01}, {5160, 0x01}, {4811, 0x01},
+    {4483, 0x01}, {4177, 0x01}, {3890, 0x01}, {3622, 0x01}, {3371, 0x01}, {3137, 0x01}, {2917, 0x01}, {2712, 0x01},
+    {2521, 0x01}, {2342, 0x01}, {2176, 0x01}, {2020, 0x01}, {1875, 0x01}, {1740, 0x01}, {1613, 0x01}, {1496, 0x01},
+    {1387, 0x01}, {1285, 0x01}, {1190, 0x01}, {1102, 0x01}, {1020, 0x01}, {943, 0x01}, {873, 0x01}, {807, 0x01},
+    {746, 0x01}, {689, 0x01}, {636, 0x01}, {587, 0x01}, {542, 0x01}, {500, 0x01}, {461, 0x01}, {425, 0x01},
+    {392, 0x01}, {361, 0x01}, {332, 0x01}, {306, 0x01}, {282, 0x01}, {259, 0x01}, {238, 0x01}, {219, 0x01},
+    {201, 0x01}, {185, 0x01}, {170, 0x01}, {156, 0x01}, {143, 0x01}, {131, 0x01}, {120, 0x01}, {110, 0x01},
+    {101, 0x01}, {92, 0x01}, {85, 0x01}, {77, 0x01}, {71, 0x01}, {65, 0x01}, {59, 0x01}, {54, 0x01},
+    {49, 0x01}, {45, 0x01}, {41, 0x01}, {37, 0x01}, {34, 0x01}, {31, 0x01}, {28, 0x01}, {26, 0x01},
+    {24, 0x01}, {21, 0x01}, {20, 0x01}, {18, 0x01}, {16, 0x01}, {28, 0x09}, {26, 0x09}, {12, 0x01},
+    {11, 0x01}, {10, 0x01}, {9, 0x01}, {8, 0x01}, {14, 0x09}, {12, 0x09}, {6, 0x01}, {10, 0x09},
+    {5, 0x01}, {8, 0x09}, {4, 0x01}, {6, 0x09}, {6, 0x09}, {3, 0x01}, {4, 0x09}, {4, 0x09},
+    {2, 0x01}, {2, 0x01}, {2, 0x01}, {2, 0x09}, {2, 0x09}, {2, 0x09}, {1, 0x09}, {1, 0x09},
+    {8480, 0x01}, {7625, 0x01}, {6859, 0x01}, {6172, 0x01}, {5556, 0x01}, {5004, 0x01}, {4509, 0x01}, {4064, 0x01},
+    {3665, 0x01}, {3306, 0x01}, {2984, 0x01}, {2694, 0x01}, {2433, 0x01}, {2199, 0x01}, {1988, 0x01}, {1797, 0x01},
+    {1626, 0x01}, {1472, 0x01}, {1332, 0x01}, {1207, 0x01}, {1094, 0x01}, {991, 0x01}, {899, 0x01}, {816, 0x01},
+    {740, 0x01}, {672, 0x01}, {611, 0x01}, {555, 0x01}, {504, 0x01}, {459, 0x01}, {417, 0x01}, {380, 0x01},
+    {346, 0x01}, {315, 0x01}, {287, 0x01}, {262, 0x01}, {239, 0x01}, {218, 0x01}, {199, 0x01}, {181, 0x01},
+    {166, 0x01}, {151, 0x01}, {138, 0x01}, {126, 0x01}, {116, 0x01}, {106, 0x01}, {97, 0x01}, {89, 0x01},
+    {81, 0x01}, {74, 0x01}, {68, 0x01}, {63, 0x01}, {57, 0x01}, {53, 0x01}, {48, 0x01}, {44, 0x01},
+    {41, 0x01}, {38, 0x01}, {35, 0x01}, {32, 0x01}, {29, 0x01}, {27, 0x01}, {25, 0x01}, {23, 0x01},
+    {21, 0x01}, {19, 0x01}, {18, 0x01}, {16, 0x01}, {15, 0x01}, {14, 0x01}, {13, 0x01}, {12, 0x01},
+    {11, 0x01}, {20, 0x09}, {18, 0x09}, {9, 0x01}, {8, 0x01}, {14, 0x09}, {7, 0x01}, {12, 0x09},
+    {6, 0x01}, {10, 0x09}, {5, 0x01}, {5, 0x01}, {8, 0x09}, {4, 0x01}, {4, 0x01}, {6, 0x09},
+    {6, 0x09}, {3, 0x01}, {3, 0x01}, {4, 0x09}, {4, 0x09}, {4, 0x09}, {2, 0x01}, {2, 0x01},
+    {2, 0x01}, {2, 0x09}, {2, 0x09}, {2, 0x09}, {2, 0x09}, {2, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09},
+    {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}, {1, 0x09}
+};
@@ -1,15 +1,83 @@
 #include <Arduino.h>
+#include <errno.h>
 #include "ClockController.h"
 #include "Debouncer.h"
 #include "FrequencyCalculator.h"
+#include "FrequencyTable.h"
 #include "LCDController.h"
 
 // Global objects
 ClockController clockController;
 Debouncer manualModeDebouncer(50);
 Debouncer manualTriggerDebouncer(50);
-FrequencyCalculator frequencyCalculator(FrequencyCalculator::DEFAULT_POT_PIN, 0.1, 4000000.0);
+FrequencyCalculator frequencyCalculator(FrequencyCalculator::DEFAULT_POT_PIN, FREQUENCY_TABLE_MIN, FREQUENCY_TABLE_MAX);
 LCDController lcdController(0x27, 16, 2); // I2C address 0x27, 16x2 display
+Debouncer burstTriggerDebouncer(50);
+
+// Pulses the burst button runs; "burst <pulses>" on serial changes it
+uint32_t burstPulses = 1000;
+bool burstReported = true;
+
+void runBurst(uint32_t pulses)
+{
+  if (clockController.startBurst(pulses))
+  {
+    burstReported = false;
+  }
+}
+
+// Serial commands, one per line:
+//   burst <pulses>  run that many pulses at the pot frequency (manual mode)
+//   burst           run the last burst again
+void handleCommand(const char *command)
+{
+  if (strncmp(command, "burst", 5) == 0 && (command[5] == '\0' || command[5] == ' '))
+  {
+    if (command[5] == ' ')
+    {
+      // Keep the last good size when the new one is rejected
+      char *end;
+      errno = 0;
+      unsigned long pulses = strtoul(command + 6, &end, 10);
+      if (end == command + 6 || *end != '\0' || errno == ERANGE || pulses == 0)
+      {
+        Serial.println("Burst size out of range");
+        return;
+      }
+      burstPulses = pulses;
+    }
+    runBurst(burstPulses);
+  }
+  else
+  {
+    Serial.print("Unknown command: ");
+    Serial.println(command);
+  }
+}
+
+void handleSerial()
+{
+  static char line[24];
+  static uint8_t length = 0;
+
+  while (Serial.available() > 0)
+  {
+    char c = Serial.read();
+    if (c == '\r' || c == '\n')
+    {
+      line[length] = '\0';
+      if (length > 0)
+      {
+        handleCommand(line);
+      }
+      length = 0;
+    }
+    else if (length < sizeof(line) - 1)
+    {
+      line[length++] = c;
+    }
+  }
+}
 
 void setup()
 {
@@ -18,6 +86,7 @@ void setup()
   Serial.println("16-bit Computer System Clock Starting...");
 
   clockController.setupPins();
+  ClockController::printFastFrequencies();
 
   lcdController.setup();
 
@@ -26,11 +95,11 @@ void setup()
 
 void loop()
 {
-  // Update frequency calculator
-  frequencyCalculator.updateFrequency();
+  // Update pot position
+  frequencyCalculator.updatePotValue();
 
-  // Update clock controller with new frequency
-  clockController.setFrequency(frequencyCalculator.getCurrentFrequency());
+  // Retune the clock from the precomputed table (no float math)
+  clockController.setPotPosition(frequencyCalculator.getPotValue());
 
   // Handle manual mode with debouncer (polling)
   bool manualModeReading = digitalRead(2); // D2
@@ -66,6 +135,21 @@ void loop()
     lastTriggerState = currentTriggerState;
   }
 
+  // Handle burst trigger with debouncer (polling): a press runs burstPulses
+  bool burstTriggerReading = digitalRead(4); // D4
+  if (burstTriggerDebouncer.update(burstTriggerReading) && !burstTriggerDebouncer.getState())
+  {
+    runBurst(burstPulses);
+  }
+
+  handleSerial();
+
+  if (!burstReported && !clockController.isBurstRunning())
+  {
+    Serial.println("Burst done");
+    burstReported = true;
+  }
+
   // Update LCD display
   lcdController.updateDisplay(
       clockController.getCurrentFrequency(),
@@ -82,7 +166,7 @@ void loop()
     Serial.print(" (");
     Serial.print(frequencyCalculator.getPotValue() * 100.0 / 1023.0);
     Serial.print("%), Requested: ");
-    Serial.print(frequencyCalculator.getCurrentFrequency());
+    Serial.print(frequencyCalculator.calculateFrequency(frequencyCalculator.getPotValue()));
     Serial.print(" Hz, Actual: ");
     Serial.print(clockController.getCurrentFrequency());
     Serial.print(" Hz, Period: ");
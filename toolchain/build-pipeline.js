@@ -2,6 +2,8 @@
 
 const fs = require("fs");
 const path = require("path");
+const { compressImage, formatCArray } = require("./image-compressor");
+const { pageCrcs, imageId, formatCrc, formatCrcArray } = require("./page-crc");
 const { execSync } = require("child_process");
 
 class BuildPipeline {
@@ -215,63 +217,105 @@ class BuildPipeline {
   generateSTM32File(programName, lowerBytes, upperBytes) {
     const outputFile = path.join(this.config.outputDir, `${programName}.cpp`);
 
+    // One word image, low byte first as in the .hack file, stored compressed.
+    // The STM32 decodes it page by page and keeps the lane of the chip it writes.
+    const wordBytes = [];
+    for (let i = 0; i < lowerBytes.length; i++) {
+      wordBytes.push(lowerBytes[i], upperBytes[i]);
+    }
+    const wordImage = compressImage(wordBytes);
+    this.log(
+      `Compressed word image: ${wordImage.size} -> ${wordImage.data.length} bytes (${wordImage.ratio.toFixed(2)}:1)`
+    );
+
     const cppContent = `// Auto-generated EEPROM programming file for ${programName}
 // Generated on: ${new Date().toISOString()}
 
 #include "stm32f1xx_hal.h"
 #include "EEPROMProgrammer.h"
+#include "ChipSwap.h"
+#include "CompressedImage.h"
+#include "DelayUtil.h"
+#include "ProgressJournal.h"
+#include "SerialLink.h"
 
 // Global EEPROM programmer instance
 EEPROMProgrammer eeprom;
 
-// Program data for lower half (bits 0-7)
-const uint8_t ${programName}ProgramLower[] = {
-${lowerBytes
-  .map((byte, index) => {
-    const hex = `0x${byte.toString(16).toUpperCase().padStart(2, "0")}`;
-    return `    ${hex}${index < lowerBytes.length - 1 ? "," : ""}`;
-  })
-  .join("\n")}
-};
-
-// Program data for upper half (bits 8-15)
-const uint8_t ${programName}ProgramUpper[] = {
-${upperBytes
-  .map((byte, index) => {
-    const hex = `0x${byte.toString(16).toUpperCase().padStart(2, "0")}`;
-    return `    ${hex}${index < upperBytes.length - 1 ? "," : ""}`;
-  })
-  .join("\n")}
-};
+// Prompts for the chip swap, which any received byte confirms (USART3, PB10/PB11)
+SerialLink console;
+
+// Pages written so far, in the last 2 KB of flash. If the board resets
+// during a plain writeImage, the next run skips them.
+ProgressJournal journal;
+
+// Program words (lower chip: bits 0-7, the first byte of each word; upper chip: bits 8-15),
+// ${wordImage.size} bytes compressed to ${wordImage.data.length} (${wordImage.ratio.toFixed(2)}:1)
+${formatCArray(`${programName}ProgramWords`, wordImage.data)}
+
+// Per-page CRCs (CRC-32/MPEG-2, as computed by the STM32 CRC unit) for verification
+${formatCrcArray(`${programName}PageCrcLower`, pageCrcs(lowerBytes))}
+
+${formatCrcArray(`${programName}PageCrcUpper`, pageCrcs(upperBytes))}
+
+// Image ids for the manifest in each chip's tail (CRC of the whole half)
+const uint32_t ${programName}ImageIdLower = ${formatCrc(imageId(lowerBytes))};
+const uint32_t ${programName}ImageIdUpper = ${formatCrc(imageId(upperBytes))};
 
 const uint16_t ${programName.toUpperCase()}_PROGRAM_SIZE = ${lowerBytes.length};
 
 // Programming configuration
 const unsigned int PROGRAM_START_ADDRESS = 0x0000;
-const unsigned int PROGRAM_SIZE = sizeof(${programName}ProgramLower);
+const unsigned int PROGRAM_SIZE = ${programName.toUpperCase()}_PROGRAM_SIZE;
 
 // Control flags
 const bool UPLOAD_ENABLED = false;  // Set to true to upload, false to verify only
+const bool UPLOAD_SWAP = true;      // Lower chip, swap (button on PB3 or a key on USART3), upper chip; ignores UPLOAD_LOWER
 const bool UPLOAD_LOWER = true;     // Set to true to upload lower half, false for upper half
+const bool UPLOAD_DIFFERENTIAL = true; // Only program bytes that differ from the chip's contents
+const bool UPLOAD_MANIFEST = true;  // Differential, with only the pages whose hash changed read (overrides the above)
+const bool UPLOAD_DUAL = false;     // Both chips in one pass, upper chip's CE on PA15 (ignores UPLOAD_LOWER)
+
+// One decoder per half (1 KB window each), so dual mode can read both at once
+CompressedImage lowerWords(${programName}ProgramWords, sizeof(${programName}ProgramWords));
+CompressedImage upperWords(${programName}ProgramWords, sizeof(${programName}ProgramWords));
+LaneImage lowerImage(lowerWords, LaneImage::LANE_LOW);
+LaneImage upperImage(upperWords, LaneImage::LANE_HIGH);
+LaneImage &image = UPLOAD_LOWER ? lowerImage : upperImage;
+
+ChipSwap::WordImage wordImage = {&lowerWords,
+                                 PROGRAM_START_ADDRESS,
+                                 PROGRAM_SIZE,
+                                 {${programName}PageCrcLower, ${programName}PageCrcUpper},
+                                 {${programName}ImageIdLower, ${programName}ImageIdUpper}};
 
 int main(void)
 {
   // Initialize EEPROM programmer
   eeprom.begin();
 
-  // Simple delay function
-  volatile uint32_t delay_count;
-
   if (UPLOAD_ENABLED) {
     // Upload program to EEPROM
     volatile bool writeSuccess;
     
-    if (UPLOAD_LOWER) {
-      writeSuccess = eeprom.writeDataBlock(PROGRAM_START_ADDRESS, ${programName}ProgramLower, PROGRAM_SIZE);
+    if (UPLOAD_DUAL) {
+      writeSuccess = eeprom.writeImagePair(PROGRAM_START_ADDRESS, lowerImage, upperImage, PROGRAM_SIZE);
+    } else if (UPLOAD_SWAP) {
+      console.begin();
+      ChipSwap swap(eeprom, &console);
+      swap.begin();
+      writeSuccess = swap.run(wordImage);
+    } else if (UPLOAD_MANIFEST) {
+      writeSuccess = eeprom.writeImageManifest(PROGRAM_START_ADDRESS, image, PROGRAM_SIZE,
+                                               UPLOAD_LOWER ? ${programName}PageCrcLower : ${programName}PageCrcUpper,
+                                               UPLOAD_LOWER ? ${programName}ImageIdLower : ${programName}ImageIdUpper);
+    } else if (UPLOAD_DIFFERENTIAL) {
+      writeSuccess = eeprom.writeImageDifferential(PROGRAM_START_ADDRESS, image, PROGRAM_SIZE);
     } else {
-      writeSuccess = eeprom.writeDataBlock(PROGRAM_START_ADDRESS, ${programName}ProgramUpper, PROGRAM_SIZE);
+      writeSuccess = eeprom.writeImage(PROGRAM_START_ADDRESS, image, PROGRAM_SIZE, EEPROMProgrammer::WRITE_MODE_PAGE,
+                                       EEPROMProgrammer::COMPLETION_DATA_POLLING, &journal);
     }
-    
+
     if (writeSuccess) {
       // Upload successful - LED stays on
       eeprom.setPinLow(eeprom.ledPort, eeprom.STATUS_LED_PIN);
@@ -279,19 +323,26 @@ int main(void)
       // Upload failed - LED blinks rapidly
       while (1) {
         eeprom.blinkLED(1);
-        for (delay_count = 0; delay_count < 100000; delay_count++) {}
+        DelayUtil::delayMilliseconds(100);
       }
     }
   } else {
     // Verify program data
     volatile bool verified;
-    
-    if (UPLOAD_LOWER) {
-      verified = eeprom.verifyData(PROGRAM_START_ADDRESS, ${programName}ProgramLower, PROGRAM_SIZE);
+    EEPROMProgrammer::VerifyResult result; // Mismatching ranges, for the debugger
+
+    if (UPLOAD_DUAL) {
+      verified = eeprom.verifyPageCrcs(PROGRAM_START_ADDRESS, PROGRAM_SIZE, ${programName}PageCrcLower, lowerImage,
+                                       &result);
+      eeprom.selectChip(EEPROMProgrammer::CHIP_UPPER);
+      verified = verified && eeprom.verifyPageCrcs(PROGRAM_START_ADDRESS, PROGRAM_SIZE, ${programName}PageCrcUpper,
+                                                   upperImage, &result);
     } else {
-      verified = eeprom.verifyData(PROGRAM_START_ADDRESS, ${programName}ProgramUpper, PROGRAM_SIZE);
+      verified = eeprom.verifyPageCrcs(PROGRAM_START_ADDRESS, PROGRAM_SIZE,
+                                       UPLOAD_LOWER ? ${programName}PageCrcLower : ${programName}PageCrcUpper,
+                                       image, &result);
     }
-    
+
     if (verified) {
       // Verification successful - LED stays on
       eeprom.setPinLow(eeprom.ledPort, eeprom.STATUS_LED_PIN);
@@ -299,14 +350,14 @@ int main(void)
       // Verification failed - LED blinks rapidly
       while (1) {
         eeprom.blinkLED(1);
-        for (delay_count = 0; delay_count < 500000; delay_count++) {}
+        DelayUtil::delayMilliseconds(500);
       }
     }
   }
 
   // Success - LED stays on
   while (1) {
-    for (delay_count = 0; delay_count < 2000000; delay_count++) {}
+    DelayUtil::delayMilliseconds(1000);
   }
 }
 `;
@@ -330,7 +381,7 @@ int main(void)
       fs.copyFileSync(sourceFile, targetFile);
       this.log(`Copied program to STM32 programmer: ${targetFile}`);
       this.log(
-        `To upload: Set UPLOAD_ENABLED = true and UPLOAD_LOWER = true/false in the copied file and flash to STM32`
+        `To upload: Set UPLOAD_ENABLED = true in the copied file and flash to STM32; it burns the lower chip, waits for the upper one (button on PB3 or any key on USART3) and burns it`
       );
     } else {
       this.error(`Source file not found: ${sourceFile}`);
@@ -0,0 +1,177 @@
+#!/usr/bin/env node
+
+const fs = require("fs");
+const path = require("path");
+
+// LZ77 image format decoded by CompressedImage on the STM32.
+//
+// The stream is a sequence of groups: one flag byte, then eight items (LSB
+// first). A 0 flag is a literal byte. A 1 flag is a two-byte little-endian
+// match token: bits 0-9 hold distance - 1 (1..1024 bytes back), bits 10-15
+// hold length - 3 (3..66 bytes). Matches may overlap the bytes they produce,
+// which covers runs of one byte.
+//
+// Hack code has almost no byte runs, since each lane alternates between
+// A- and C-instructions. The repetition is in the code templates the VM
+// translator emits, which recur within a few hundred instructions, so a
+// 1 KB window does most of the work.
+const WINDOW_SIZE = 1024;
+const MIN_MATCH = 3;
+const MAX_MATCH = 66;
+
+function findMatch(data, position) {
+  let bestLength = 0;
+  let bestDistance = 0;
+  const maxLength = Math.min(MAX_MATCH, data.length - position);
+
+  for (let distance = 1; distance <= WINDOW_SIZE && distance <= position; distance++) {
+    let length = 0;
+    while (length < maxLength && data[position + length] === data[position - distance + length]) {
+      length++;
+    }
+    if (length > bestLength) {
+      bestLength = length;
+      bestDistance = distance;
+      if (length === maxLength) {
+        break;
+      }
+    }
+  }
+
+  return { length: bestLength, distance: bestDistance };
+}
+
+function compress(data) {
+  const out = [];
+  let flagIndex = -1;
+  let flagBit = 8;
+  let position = 0;
+
+  while (position < data.length) {
+    if (flagBit === 8) {
+      flagIndex = out.length;
+      out.push(0);
+      flagBit = 0;
+    }
+
+    const match = findMatch(data, position);
+    if (match.length >= MIN_MATCH) {
+      const token = (match.distance - 1) | ((match.length - MIN_MATCH) << 10);
+      out[flagIndex] |= 1 << flagBit;
+      out.push(token & 0xff, token >> 8);
+      position += match.length;
+    } else {
+      out.push(data[position]);
+      position++;
+    }
+    flagBit++;
+  }
+
+  return out;
+}
+
+function decompress(compressed, size) {
+  const out = [];
+  let position = 0;
+  let flags = 0;
+  let flagsLeft = 0;
+
+  while (out.length < size) {
+    if (flagsLeft === 0) {
+      flags = compressed[position++];
+      flagsLeft = 8;
+    }
+    flagsLeft--;
+
+    if (flags & 1) {
+      const token = compressed[position] | (compressed[position + 1] << 8);
+      position += 2;
+      const distance = (token & 0x3ff) + 1;
+      const length = (token >> 10) + MIN_MATCH;
+      for (let i = 0; i < length && out.length < size; i++) {
+        out.push(out[out.length - distance]);
+      }
+    } else {
+      out.push(compressed[position++]);
+    }
+    flags >>= 1;
+  }
+
+  return out;
+}
+
+// Compress and check the round trip, so a broken image never reaches the programmer
+function compressImage(data) {
+  const compressed = compress(data);
+  const restored = decompress(compressed, data.length);
+  if (restored.length !== data.length || restored.some((byte, index) => byte !== data[index])) {
+    throw new Error("Compressed image does not round-trip");
+  }
+
+  return {
+    data: compressed,
+    size: data.length,
+    ratio: compressed.length ? data.length / compressed.length : 1,
+  };
+}
+
+function formatCArray(name, bytes) {
+  const rows = [];
+  for (let i = 0; i < bytes.length; i += 16) {
+    rows.push(
+      "    " +
+        bytes
+          .slice(i, i + 16)
+          .map((byte) => `0x${byte.toString(16).toUpperCase().padStart(2, "0")}`)
+          .join(", ")
+    );
+  }
+  return `const uint8_t ${name}[] = {\n${rows.join(",\n")}\n};`;
+}
+
+module.exports = { compress, decompress, compressImage, formatCArray, WINDOW_SIZE, MIN_MATCH, MAX_MATCH };
+
+// Command line usage: print one lane of a .hack file, or the whole words
+// (low byte first, as the pipeline stores them), as a compressed C array
+if (require.main === module) {
+  const args = process.argv.slice(2);
+  if (args.length < 1) {
+    console.log("Usage: node image-compressor.js <input.hack> [--lane low|high|words] [--name arrayName] [--raw]");
+    console.log("Example: node image-compressor.js simple-loop.hack --lane high");
+    process.exit(1);
+  }
+
+  const inputFile = args[0];
+  const laneIndex = args.indexOf("--lane");
+  const lane = laneIndex >= 0 ? args[laneIndex + 1] : "low";
+  const nameIndex = args.indexOf("--name");
+  const name = nameIndex >= 0 ? args[nameIndex + 1] : path.basename(inputFile, ".hack").replace(/[^a-zA-Z0-9_]/g, "_");
+
+  try {
+    const bytes = fs
+      .readFileSync(inputFile, "utf8")
+      .trim()
+      .split("\n")
+      .map((line) => line.trim())
+      .filter((line) => line.length === 16)
+      .flatMap((line) => {
+        const instruction = parseInt(line, 2);
+        const low = instruction & 0xff;
+        const high = (instruction >> 8) & 0xff;
+        return lane === "words" ? [low, high] : lane === "high" ? [high] : [low];
+      });
+
+    const image = compressImage(bytes);
+    const description = { words: "16-bit words", high: "upper byte lane" }[lane] || "lower byte lane";
+    console.log(`// ${path.basename(inputFile)}, ${description}`);
+    console.log(`// ${image.size} bytes compressed to ${image.data.length} (${image.ratio.toFixed(2)}:1)`);
+    console.log(formatCArray(`${name}Compressed`, image.data));
+    console.log(`const uint16_t ${name.replace(/([a-z0-9])([A-Z])/g, "$1_$2").toUpperCase()}_SIZE = ${image.size};`);
+    if (args.includes("--raw")) {
+      console.log(formatCArray(name, bytes));
+    }
+  } catch (error) {
+    console.error("Error:", error.message);
+    process.exit(1);
+  }
+}
@@ -0,0 +1,60 @@
+#!/usr/bin/env node
+
+// Per-page CRCs matching the STM32F1 CRC unit (HardwareCRC on the
+// programmer): CRC-32/MPEG-2 over 32-bit words, bytes packed little-endian,
+// a partial last word padded with 0xFF. Pages are split on 64-byte
+// boundaries from the start address, as EEPROMProgrammer does.
+
+const PAGE_SIZE = 64;
+
+function crc32Words(bytes) {
+  let crc = 0xffffffff;
+  for (let i = 0; i < bytes.length; i += 4) {
+    let word = 0;
+    for (let j = 3; j >= 0; j--) {
+      word = (word << 8) | (i + j < bytes.length ? bytes[i + j] : 0xff);
+    }
+    crc = (crc ^ word) >>> 0;
+    for (let bit = 0; bit < 32; bit++) {
+      crc = crc & 0x80000000 ? ((crc << 1) ^ 0x04c11db7) >>> 0 : (crc << 1) >>> 0;
+    }
+  }
+  return crc;
+}
+
+function pageCrcs(bytes, startAddress = 0) {
+  const crcs = [];
+  let offset = 0;
+  while (offset < bytes.length) {
+    const chunk = Math.min(PAGE_SIZE - ((startAddress + offset) % PAGE_SIZE), bytes.length - offset);
+    crcs.push(crc32Words(bytes.slice(offset, offset + chunk)));
+    offset += chunk;
+  }
+  return crcs;
+}
+
+// Id of a whole image in the EEPROM's manifest (ImageManifest.h): the same
+// CRC over all of its bytes
+function imageId(bytes) {
+  return crc32Words(bytes);
+}
+
+function formatCrc(crc) {
+  return `0x${crc.toString(16).toUpperCase().padStart(8, "0")}`;
+}
+
+function formatCrcArray(name, crcs) {
+  const rows = [];
+  for (let i = 0; i < crcs.length; i += 6) {
+    rows.push(
+      "    " +
+        crcs
+          .slice(i, i + 6)
+          .map(formatCrc)
+          .join(", ")
+    );
+  }
+  return `const uint32_t ${name}[] = {\n${rows.join(",\n")}\n};`;
+}
+
+module.exports = { crc32Words, pageCrcs, imageId, formatCrc, formatCrcArray, PAGE_SIZE };